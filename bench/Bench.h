@@ -0,0 +1,180 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	bench/Bench.h
+ * Minimal harness for the libzypp microbenchmarks.
+*/
+#ifndef ZYPP_BENCH_BENCH_H
+#define ZYPP_BENCH_BENCH_H
+
+#include <sys/resource.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include <zypp/base/String.h>
+
+///////////////////////////////////////////////////////////////////
+namespace bench
+{
+  ///////////////////////////////////////////////////////////////////
+  /// \class AllocCounter
+  /// \brief Number and size of the <tt>operator new</tt> calls.
+  ///
+  /// The counters are fed by the replacement <tt>operator new</tt> in
+  /// zypp-bench.cc. Memory allocated by libsolv (plain \c malloc) is not
+  /// counted, peak RSS covers it.
+  ///////////////////////////////////////////////////////////////////
+  struct AllocCounter
+  {
+    static std::atomic<std::uint64_t> & count()
+    { static std::atomic<std::uint64_t> _val { 0 }; return _val; }
+
+    static std::atomic<std::uint64_t> & bytes()
+    { static std::atomic<std::uint64_t> _val { 0 }; return _val; }
+
+    static void add( std::size_t size_r )
+    {
+      count().fetch_add( 1, std::memory_order_relaxed );
+      bytes().fetch_add( size_r, std::memory_order_relaxed );
+    }
+  };
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class PeakRss
+  /// \brief Peak resident set size of the process in KiB.
+  ///
+  /// On linux the high water mark can be reset (<tt>/proc/self/clear_refs</tt>),
+  /// so \ref get reports the peak since the last \ref reset. Otherwise it
+  /// is the peak of the process lifetime.
+  ///////////////////////////////////////////////////////////////////
+  struct PeakRss
+  {
+    static void reset()
+    {
+      std::ofstream clear( "/proc/self/clear_refs" );
+      if ( clear )
+        clear << "5" << std::flush;
+    }
+
+    static std::uint64_t get()
+    {
+      std::ifstream status( "/proc/self/status" );
+      for( std::string line; std::getline( status, line ); )
+      {
+        if ( zypp::str::hasPrefix( line, "VmHWM:" ) )
+          return zypp::str::strtonum<std::uint64_t>( line.substr( 6 ) );
+      }
+      struct rusage usage;
+      if ( ::getrusage( RUSAGE_SELF, &usage ) == 0 )
+        return usage.ru_maxrss;
+      return 0;
+    }
+  };
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class Scenario
+  /// \brief A named benchmark.
+  ///
+  /// \c run performs one iteration and returns the number of operations it
+  /// did (e.g. the number of editions compared). The optional \c setup is
+  /// called untimed before each iteration.
+  ///////////////////////////////////////////////////////////////////
+  struct Scenario
+  {
+    std::string name;
+    std::function<std::uint64_t()> run;
+    std::function<void()> setup = {};
+  };
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class Runner
+  /// \brief Run \ref Scenario and print one JSON object per line.
+  ///
+  /// Each scenario is repeated until \c minTime has elapsed, but at least
+  /// \c minIterations times.
+  /// \code
+  /// {"scenario":"edition.compare","fixture":"openSUSE-11.1+obs_virtualbox","iterations":112,
+  ///  "ops":615440,"ns_total":201983325,"ns_per_op":328.2,"allocs":0,
+  ///  "alloc_bytes":0,"peak_rss_kb":41236}
+  /// \endcode
+  ///////////////////////////////////////////////////////////////////
+  class Runner
+  {
+  public:
+    Runner( std::ostream & out_r )
+    : _out( out_r )
+    {}
+
+  public:
+    std::chrono::milliseconds minTime { 200 };
+    unsigned minIterations = 3;
+    std::string filter;		///< run only scenarios containing this string
+
+    /** Fixture name used in the following reports. */
+    void fixture( const std::string & name_r )
+    { _fixture = name_r; }
+
+    /** Whether \a name_r would be run. */
+    bool selected( const std::string & name_r ) const
+    { return filter.empty() || name_r.find( filter ) != std::string::npos; }
+
+    void run( const Scenario & scenario_r )
+    {
+      if ( ! selected( scenario_r.name ) )
+        return;
+
+      typedef std::chrono::steady_clock Clock;
+      std::chrono::nanoseconds elapsed { 0 };
+      std::uint64_t iterations = 0;
+      std::uint64_t ops = 0;
+      std::uint64_t allocs = 0;
+      std::uint64_t allocBytes = 0;
+
+      PeakRss::reset();
+      while ( iterations < minIterations || elapsed < minTime )
+      {
+        if ( scenario_r.setup )
+          scenario_r.setup();
+
+        std::uint64_t c = AllocCounter::count();
+        std::uint64_t b = AllocCounter::bytes();
+        Clock::time_point start = Clock::now();
+
+        ops += scenario_r.run();
+
+        elapsed += Clock::now() - start;
+        allocs += AllocCounter::count() - c;
+        allocBytes += AllocCounter::bytes() - b;
+        ++iterations;
+      }
+
+      _out << "{\"scenario\":\"" << scenario_r.name << "\""
+           << ",\"fixture\":\"" << _fixture << "\""
+           << ",\"iterations\":" << iterations
+           << ",\"ops\":" << ops
+           << ",\"ns_total\":" << elapsed.count()
+           << ",\"ns_per_op\":" << ( ops ? double(elapsed.count()) / ops : 0.0 )
+           << ",\"allocs\":" << allocs
+           << ",\"alloc_bytes\":" << allocBytes
+           << ",\"peak_rss_kb\":" << PeakRss::get()
+           << "}" << std::endl;
+    }
+
+  private:
+    std::ostream & _out;
+    std::string _fixture;
+  };
+
+} // namespace bench
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_BENCH_BENCH_H
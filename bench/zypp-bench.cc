@@ -0,0 +1,513 @@
+#define INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "../tests/lib/TestSetup.h"
+#undef  INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "../tools/argparse.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include <zypp/AutoDispose.h>
+#include <zypp/Capability.h>
+#include <zypp/Digest.h>
+#include <zypp/PoolQuery.h>
+#include <zypp/ResPoolProxy.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/sat/LookupAttr.h>
+#include <zypp/media/MediaBlockList.h>
+
+#include "Bench.h"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+// Count the operator new calls (see bench::AllocCounter).
+// new[], nothrow and sized delete forward to these.
+///////////////////////////////////////////////////////////////////
+void * operator new( std::size_t size_r )
+{
+  bench::AllocCounter::add( size_r );
+  if ( void * ret = std::malloc( size_r ? size_r : 1 ) )
+    return ret;
+  throw std::bad_alloc();
+}
+
+void operator delete( void * ptr_r ) noexcept
+{ std::free( ptr_r ); }
+
+void operator delete( void * ptr_r, std::size_t ) noexcept
+{ std::free( ptr_r ); }
+
+static std::string appname { "zypp-bench" };
+
+int errexit( const std::string & msg_r = std::string(), int exit_r = 100 )
+{
+  if ( ! msg_r.empty() )
+    cerr << endl << appname << ": ERR: " << msg_r << endl << endl;
+  return exit_r;
+}
+
+int usage( const argparse::Options & options_r, int return_r = 0 )
+{
+  cerr << "USAGE: " << appname << " [OPTION]..." << endl;
+  cerr << "    Run the libzypp microbenchmarks and print one JSON object per scenario." << endl;
+  cerr << options_r << endl;
+  return return_r;
+}
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  /** Results are stored here, so the compiler can not drop the work. */
+  volatile std::uint64_t sink = 0;
+
+  /** Write a testtags repo with \a count_r packages.
+   * Each package provides itself and a library, requires the library
+   * of its successor and obsoletes an older name. About every 10th
+   * package name comes in 3 versions, so the proxy sees multi version
+   * selectables.
+   */
+  void writeGeneratedRepo( const Pathname & file_r, unsigned count_r )
+  {
+    std::ofstream out( file_r.c_str() );
+    out << "=Ver: 3.0" << endl;
+    for ( unsigned i = 0; i < count_r; ++i )
+    {
+      unsigned n = ( i % 10 == 0 ) ? i / 3 * 3 : i;	// names shared by 3 versions
+      std::string name( str::form( "gen-%06u", n ) );
+      std::string ver( str::form( "%u.%u.%u", 1 + i % 3, i % 17, i % 5 ) );
+      std::string rel( str::form( "%u.1", 1 + i % 7 ) );
+      out << "=Pkg: " << name << " " << ver << " " << rel << " " << ( i % 4 ? "x86_64" : "noarch" ) << endl;
+      out << "+Prv:" << endl
+          << name << " = " << ver << "-" << rel << endl
+          << str::form( "libgen%06u.so.%u()(64bit)", i, i % 3 ) << endl
+          << "-Prv:" << endl;
+      out << "+Req:" << endl
+          << str::form( "libgen%06u.so.%u()(64bit)", (i+1) % count_r, (i+1) % 3 ) << endl
+          << "-Req:" << endl;
+      out << "=Obs: " << name << "-old < " << ver << endl;
+      out << "=Sum: generated package " << i << endl;
+    }
+  }
+
+  /** Run all scenarios on the current pool. */
+  void runScenarios( bench::Runner & runner_r )
+  {
+    ResPool pool( ResPool::instance() );
+    sat::Pool satpool( sat::Pool::instance() );
+    satpool.prepare();
+
+    // Input data collected once per fixture:
+    std::vector<Edition> editions;
+    std::vector<std::string> names;
+    std::vector<std::string> caps;
+    for ( sat::Solvable solv : satpool.solvables() )
+    {
+      editions.push_back( solv.edition() );
+      names.push_back( solv.name() );
+      for ( const Capability & cap : solv.provides() )
+        caps.push_back( cap.asString() );
+    }
+    // Names not yet in the pool are created (and stay in the pool).
+    // So the 1st iteration measures creation, the following ones lookup.
+    std::vector<std::string> newNames;
+    for ( unsigned i = 0; i < names.size(); ++i )
+      newNames.push_back( str::form( "bench-new-name-%u", i ) );
+
+    runner_r.run( { "edition.compare", [&]() {
+      std::uint64_t ret = 0;
+      int cmp = 0;
+      for ( unsigned i = 1; i < editions.size(); ++i, ++ret )
+        cmp += editions[i-1].compare( editions[i] );
+      sink = cmp;
+      return ret;
+    } } );
+
+    runner_r.run( { "idstring.construct.existing", [&]() {
+      std::uint64_t ret = 0;
+      for ( const std::string & name : names )
+        ret += IdString( name ).empty() ? 0 : 1;
+      return ret;
+    } } );
+
+    runner_r.run( { "idstring.construct.new", [&]() {
+      std::uint64_t ret = 0;
+      for ( const std::string & name : newNames )
+        ret += IdString( name ).empty() ? 0 : 1;
+      return ret;
+    } } );
+
+    runner_r.run( { "capability.parse", [&]() {
+      std::uint64_t ret = 0;
+      for ( const std::string & cap : caps )
+        ret += Capability( cap ).empty() ? 0 : 1;
+      return ret;
+    } } );
+
+    auto poolquery = [&]() {
+      PoolQuery q;
+      q.addString( "lib" );
+      q.addAttribute( sat::SolvAttr::name );
+      q.addAttribute( sat::SolvAttr::provides );
+      q.setMatchSubstring();
+      // Unlike begin()/end(), size() takes the result from the cache if enabled.
+      sink = q.size();
+      return std::uint64_t(1);
+    };
+    PoolQuery::setResultCacheEnabled( false );
+    runner_r.run( { "poolquery.execute", poolquery } );
+    PoolQuery::setResultCacheEnabled( true );
+    runner_r.run( { "poolquery.execute.cached", poolquery } );
+    PoolQuery::setResultCacheEnabled( false );
+
+    runner_r.run( { "respool.iterate", [&]() {
+      std::uint64_t ret = 0;
+      for ( const PoolItem & pi : pool )
+      {
+        if ( pi.status().isInstalled() || pi.isRelevant() )
+          ++ret;
+      }
+      sink = ret;
+      return std::uint64_t( pool.size() );
+    } } );
+
+    runner_r.run( { "respoolproxy.construct", [&]() {
+      ResPoolProxy proxy( pool.proxy() );
+      return std::uint64_t( proxy.size() );
+    }, [&]() {
+      // Change the pools serial number so the next proxy is built from scratch.
+      // Updating the ResPool store is not part of the measurement.
+      satpool.reposInsert( "bench-tmp" ).eraseFromPool();
+      pool.size();
+    } } );
+  }
+
+  /** Loading a repos solv file (startup time and RSS).
+   * The descriptions are paged data, libsolv reads them on demand.
+   */
+  void runLoadScenarios( bench::Runner & runner_r, const Pathname & solvfile_r )
+  {
+    sat::Pool satpool( sat::Pool::instance() );
+    auto erase = [&]() {
+      satpool.reposErase( "bench-load" );
+    };
+
+    runner_r.run( { "pool.load.solv", [&]() {
+      return std::uint64_t( satpool.addRepoSolv( solvfile_r, "bench-load" ).solvablesSize() );
+    }, erase } );
+
+    runner_r.run( { "pool.load.solv.descriptions", [&]() {
+      Repository repo( satpool.addRepoSolv( solvfile_r, "bench-load" ) );
+      std::uint64_t ret = 0;
+      sat::LookupAttr q( sat::SolvAttr::description, repo );
+      for_( it, q.begin(), q.end() )
+        ret += ::strlen( it.c_str() );
+      sink = ret;
+      return std::uint64_t( repo.solvablesSize() );
+    }, erase } );
+    erase();
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class BlocklistFixture
+  /// \brief A blocklist (sha1 + 4 byte rsum) and a local file to reuse blocks from.
+  ///
+  /// The local file is the target shifted by a few bytes, with every 64th
+  /// block modified. The block sums are kept for \ref referenceReuseBlocks.
+  ///////////////////////////////////////////////////////////////////
+  struct BlocklistFixture
+  {
+    BlocklistFixture( const Pathname & deltafile_r, unsigned mib_r )
+    : deltafile( deltafile_r )
+    {
+      std::ofstream out( deltafile.c_str() );
+      out << "some garbage";
+      std::string blk( blksize, '\0' );
+      unsigned seed = 42;
+      for ( off_t off = 0; off < off_t(mib_r) << 20; off += blksize )
+      {
+        for ( auto & ch : blk )
+        {
+          seed = seed * 1103515245 + 12345;
+          ch = char( seed >> 16 );
+        }
+        size_t blkno = blocklist.addBlock( off, blksize );
+
+        Digest dig;
+        dig.create( Digest::sha1() );
+        dig.update( blk.data(), blk.size() );
+        chksums.push_back( dig.digestVector() );
+        blocklist.setChecksum( blkno, Digest::sha1(), chksums.back().size(), chksums.back().data() );
+        rsums.push_back( blocklist.updateRsum( 0, blk.data(), blk.size() ) );
+        blocklist.setRsum( blkno, 4, rsums.back(), blksize );
+
+        if ( blkno % 64 == 0 )
+        {
+          std::string mod( blk );
+          mod.replace( 7, 10, "**********" );
+          out << mod;
+        }
+        else
+          out << blk;
+      }
+      blocklist.setFilesize( off_t(mib_r) << 20 );
+    }
+
+    static constexpr size_t blksize = 4096;
+    Pathname deltafile;
+    media::MediaBlockList blocklist;
+    std::vector<unsigned int> rsums;
+    std::vector<std::vector<unsigned char>> chksums;
+  };
+
+  /** The MediaBlockList::reuseBlocks scan as it was before reading the file in chunks.
+   * It fetches the file byte by byte via getc(). Returns the number of blocks not found.
+   * Only the case needed by \ref BlocklistFixture (4 byte rsums, full sha1) is kept.
+   */
+  size_t referenceReuseBlocks( const BlocklistFixture & fix_r, FILE * wfp_r )
+  {
+    const media::MediaBlockList & bl( fix_r.blocklist );
+    const size_t blksize = fix_r.blksize;
+    const size_t nblks = bl.numBlocks();
+    AutoFILE file( ::fopen( fix_r.deltafile.c_str(), "r" ) );
+    if ( ! file )
+      return nblks;
+    FILE * fp = file;
+    std::vector<bool> found( nblks, false );
+
+    auto checkChecksumRotated = [&]( size_t blkno, const unsigned char * buf, size_t start ) {
+      if ( start == blksize )
+        start = 0;
+      Digest dig;
+      dig.create( Digest::sha1() );
+      dig.update( (const char *)buf + start, blksize - start );
+      if ( start )
+        dig.update( (const char *)buf, start );
+      return dig.digestVector() == fix_r.chksums[blkno];
+    };
+    auto writeBlock = [&]( size_t blkno, const unsigned char * buf, size_t start ) {
+      if ( start == blksize )
+        start = 0;
+      if ( ::fseeko( wfp_r, bl.getBlock( blkno ).off, SEEK_SET ) )
+        return;
+      if ( ::fwrite( buf + start, blksize - start, 1, wfp_r ) != 1 )
+        return;
+      if ( start && ::fwrite( buf, start, 1, wfp_r ) != 1 )
+        return;
+      found[blkno] = true;
+    };
+    size_t pushback = 0;
+    unsigned char * pushbackp = 0;
+    auto fetchnext = [&]( unsigned char * bp ) {
+      size_t l = blksize;
+      if ( pushback )
+      {
+        if ( pushbackp != bp )
+          ::memmove( bp, pushbackp, pushback );
+        bp += pushback;
+        l -= pushback;
+      }
+      for ( int c; l && ( c = ::getc( fp ) ) != EOF; --l )
+        *bp++ = c;
+      ::memset( bp, 0, l );
+      return blksize - l;
+    };
+
+    // create hash of checksums
+    unsigned int hm = fix_r.rsums.size() * 2;
+    while ( hm & (hm - 1) )
+      hm &= hm - 1;
+    hm = std::max( hm * 2 - 1, 16383U );
+    std::vector<unsigned int> ht( hm + 1, 0 );
+    for ( unsigned int i = 0; i < fix_r.rsums.size(); ++i )
+    {
+      unsigned int h = fix_r.rsums[i] & hm;
+      unsigned int hh = 7;
+      while ( ht[h] )
+        h = (h + hh++) & hm;
+      ht[h] = i + 1;
+    }
+
+    std::vector<unsigned char> buf( blksize, 0 );
+    std::vector<unsigned char> buf2( blksize, 0 );
+    int bshift = 0;
+    for ( ; size_t(1 << bshift) != blksize; ++bshift )
+      ;
+    unsigned short a = 0, b = 0;
+    bool eof = false;
+    bool init = true;
+    while ( ! eof )
+    {
+      for ( size_t i = 0; i < blksize; ++i )
+      {
+        int c;
+        if ( eof )
+          c = 0;
+        else
+        {
+          if ( pushback )
+          {
+            c = *pushbackp++;
+            --pushback;
+          }
+          else
+            c = ::getc( fp );
+          if ( c == EOF )
+          {
+            eof = true;
+            c = 0;
+            if ( ! i )
+              break;
+          }
+        }
+        int oc = buf[i];
+        buf[i] = c;
+        a += c - oc;
+        b += a - (oc << bshift);
+        if ( init )
+        {
+          if ( i != blksize - 1 )
+            continue;
+          init = false;
+        }
+        unsigned int r = ((unsigned int)a & 65535) << 16 | ((unsigned int)b & 65535);
+        unsigned int h = r & hm;
+        unsigned int hh = 7;
+        for ( ; ht[h]; h = (h + hh++) & hm )
+        {
+          size_t blkno = ht[h] - 1;
+          if ( fix_r.rsums[blkno] != r || found[blkno] )
+            continue;
+          if ( ! checkChecksumRotated( blkno, buf.data(), i + 1 ) )
+            continue;
+          writeBlock( blkno, buf.data(), i + 1 );
+          while ( ! eof )
+          {
+            ++blkno;
+            pushback = fetchnext( buf2.data() );
+            pushbackp = buf2.data();
+            if ( ! pushback )
+              break;
+            if ( ! bl.checkRsum( blkno, buf2.data(), blksize ) )
+              break;
+            if ( ! bl.checkChecksum( blkno, buf2.data(), blksize ) )
+              break;
+            writeBlock( blkno, buf2.data(), 0 );
+            pushback = 0;
+          }
+          init = false;
+          std::fill( buf.begin(), buf.end(), 0 );
+          a = b = 0;
+          i = size_t(-1);	// start with 0 on next iteration
+          break;
+        }
+      }
+    }
+    return std::count( found.begin(), found.end(), false );
+  }
+
+  /** Reusing the blocks of a local file (delta download), old vs. new scan.
+   * Found blocks are written to /dev/null, the scan is measured, not the disk.
+   */
+  void runBlocklistScenarios( bench::Runner & runner_r, const BlocklistFixture & fix_r )
+  {
+    const std::uint64_t bytes = PathInfo( fix_r.deltafile ).size();	// ns_per_op is per byte scanned
+    size_t referenceLeft = 0;
+    size_t left = 0;
+
+    runner_r.run( { "blocklist.reuse.reference", [&]() {
+      AutoFILE out( ::fopen( "/dev/null", "w" ) );
+      referenceLeft = referenceReuseBlocks( fix_r, out );
+      return bytes;
+    } } );
+
+    media::MediaBlockList blocklist;
+    runner_r.run( { "blocklist.reuse", [&]() {
+      AutoFILE out( ::fopen( "/dev/null", "w" ) );
+      blocklist.reuseBlocks( out, fix_r.deltafile.asString() );
+      left = blocklist.numBlocks();
+      return bytes;
+    }, [&]() {
+      // reuseBlocks drops the found blocks, start with the complete list
+      blocklist = fix_r.blocklist;
+    } } );
+
+    if ( runner_r.selected( "blocklist.reuse.reference" ) && runner_r.selected( "blocklist.reuse" ) && referenceLeft != left )
+      cerr << appname << ": WAR: blocklist.reuse: " << left << " blocks left, reference " << referenceLeft << endl;
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+int main( int argc, char * argv[] )
+{
+  appname = Pathname::basename( argv[0] );
+
+  argparse::Options options;
+  options.add()
+    ( "help,h",		"Print help and exit." )
+    ( "filter",		"Run only the scenarios whose name contains ARG.", argparse::Option::Arg::required )
+    ( "min-time",	"Repeat each scenario for at least ARG ms (default 200).", argparse::Option::Arg::required )
+    ( "generated",	"Number of solvables in the generated fixture (default 200000, 0 disables it).", argparse::Option::Arg::required )
+    ( "blocklist-size",	"Size in MiB of the file scanned in the blocklist fixture (default 64, 0 disables it). Use e.g. 4096 for a multi-GiB run.", argparse::Option::Arg::required )
+    ( "output,o",	"Append the results to file ARG rather than printing them to stdout.", argparse::Option::Arg::required )
+    ;
+  auto result = options.parse( argc, argv );
+
+  if ( result.count( "help" ) )
+    return usage( options );
+
+  std::ofstream outfile;
+  if ( result.count( "output" ) )
+  {
+    outfile.open( result["output"].arg().c_str(), std::ios_base::app );
+    if ( ! outfile )
+      return errexit( "Can not open output file " + result["output"].arg() );
+  }
+  bench::Runner runner( outfile.is_open() ? outfile : cout );
+
+  if ( result.count( "filter" ) )
+    runner.filter = result["filter"].arg();
+  if ( result.count( "min-time" ) )
+    runner.minTime = std::chrono::milliseconds( str::strtonum<unsigned>( result["min-time"].arg() ) );
+  unsigned generated = 200000;
+  if ( result.count( "generated" ) )
+    generated = str::strtonum<unsigned>( result["generated"].arg() );
+  unsigned blocklistSize = 64;	// multi-GiB runs are opt-in: the reference scan is slow
+  if ( result.count( "blocklist-size" ) )
+    blocklistSize = str::strtonum<unsigned>( result["blocklist-size"].arg() );
+
+  // go...
+  TestSetup test( Arch_x86_64 );
+
+  runner.fixture( "openSUSE-11.1+obs_virtualbox" );
+  test.loadTargetRepo( TESTS_SRC_DIR "/data/obs_virtualbox_11_1" );
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "opensuse" );
+  runScenarios( runner );
+  test.satpool().reposEraseAll();
+  runLoadScenarios( runner, RepoManagerOptions::makeTestSetup( test.root() ).repoSolvCachePath / "opensuse" / "solv" );
+
+  if ( generated )
+  {
+    runner.fixture( str::form( "generated-%u", generated ) );
+    filesystem::TmpFile tmp;
+    writeGeneratedRepo( tmp.path(), generated );
+    test.satpool().reposInsert( "generated" ).addTesttags( tmp.path() );
+    runScenarios( runner );
+    test.satpool().reposEraseAll();
+  }
+
+  if ( blocklistSize && ( runner.selected( "blocklist.reuse" ) || runner.selected( "blocklist.reuse.reference" ) ) )
+  {
+    runner.fixture( str::form( "blocklist-%uMiB", blocklistSize ) );
+    filesystem::TmpFile tmp;
+    BlocklistFixture fix( tmp.path(), blocklistSize );
+    runBlocklistScenarios( runner, fix );
+  }
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/AutoDispose.h>
+#include <zypp/Digest.h>
+#include <zypp/TmpPath.h>
+#include <zypp/media/MediaBlockList.h>
+
+using namespace zypp;
+using namespace zypp::media;
+
+namespace
+{
+  std::string randomData( size_t size_r, unsigned seed_r )
+  {
+    std::string ret( size_r, '\0' );
+    for ( auto & ch : ret )
+    {
+      seed_r = seed_r * 1103515245 + 12345;
+      ch = char( seed_r >> 16 );
+    }
+    return ret;
+  }
+
+  /** Blocklist for \a data_r like a zsync file would provide it (sha1 + rsum). */
+  MediaBlockList blocklistFor( const std::string & data_r, size_t blksize_r, int rsumlen_r )
+  {
+    MediaBlockList ret( data_r.size() );
+    for ( size_t off = 0, blkno = 0; off < data_r.size(); off += blksize_r, ++blkno )
+    {
+      size_t size = std::min( blksize_r, data_r.size() - off );
+      ret.addBlock( off, size );
+
+      Digest dig;
+      dig.create( Digest::sha1() );
+      dig.update( data_r.data() + off, size );
+      std::vector<unsigned char> sum( dig.digestVector() );
+      ret.setChecksum( blkno, Digest::sha1(), sum.size(), sum.data() );
+
+      // the last block is zero padded
+      std::string blk( data_r.substr( off, size ) );
+      blk.resize( blksize_r, '\0' );
+      unsigned int rs = ret.updateRsum( 0, blk.data(), blk.size() );
+      if ( rsumlen_r < 4 )
+        rs &= ( 1U << ( 8 * rsumlen_r ) ) - 1;
+      ret.setRsum( blkno, rsumlen_r, rs, blksize_r );
+    }
+    return ret;
+  }
+
+  std::string readFile( FILE * fp_r )
+  {
+    std::string ret;
+    rewind( fp_r );
+    for ( int ch = getc( fp_r ); ch != EOF; ch = getc( fp_r ) )
+      ret += char(ch);
+    return ret;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(reuse_shifted_blocks)
+{
+  const size_t blksize = 1024;
+  const std::string target( randomData( 300 * blksize + 123, 42 ) );
+
+  // The local file has the target data shifted and one block in the middle modified.
+  std::string delta( "some garbage" + target );
+  delta.replace( 12 + 100 * blksize + 7, 10, "**********" );
+
+  filesystem::TmpFile deltafile;
+  std::ofstream( deltafile.path().c_str() ) << delta;
+
+  for ( int rsumlen : { 2, 3, 4 } )
+  {
+    MediaBlockList bl( blocklistFor( target, blksize, rsumlen ) );
+    BOOST_REQUIRE_EQUAL( bl.numBlocks(), 301U );
+
+    AutoFILE out( tmpfile() );
+    bl.reuseBlocks( out, deltafile.path().asString() );
+
+    // only the modified block is left to download
+    BOOST_REQUIRE_EQUAL( bl.numBlocks(), 1U );
+    BOOST_CHECK_EQUAL( bl.getBlock( 0 ).off, off_t(100 * blksize) );
+
+    std::string result( readFile( out ) );
+    BOOST_REQUIRE_EQUAL( result.size(), target.size() );
+    BOOST_CHECK( result.substr( 0, 100 * blksize ) == target.substr( 0, 100 * blksize ) );
+    BOOST_CHECK( result.substr( 101 * blksize ) == target.substr( 101 * blksize ) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(reuse_nothing)
+{
+  const std::string target( randomData( 16 * 1024, 7 ) );
+  filesystem::TmpFile deltafile;
+  std::ofstream( deltafile.path().c_str() ) << randomData( 16 * 1024, 8 );
+
+  MediaBlockList bl( blocklistFor( target, 1024, 4 ) );
+  AutoFILE out( tmpfile() );
+  bl.reuseBlocks( out, deltafile.path().asString() );
+  BOOST_CHECK_EQUAL( bl.numBlocks(), 16U );
+}
@@ -0,0 +1,68 @@
+#include <iostream>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/base/Logger.h>
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+#include <zypp/repo/RepoMirrorRace.h>
+
+using namespace zypp;
+using namespace zypp::repo;
+
+BOOST_AUTO_TEST_CASE(rank)
+{
+  Url a( "http://a.example.com/repo" );
+  Url b( "http://b.example.com/repo" );
+  Url c( "http://c.example.com/repo" );
+  Url d( "http://d.example.com/repo" );
+  std::vector<Url> urls { a, b, c, d };
+
+  MirrorStats stats;
+  BOOST_CHECK( stats.rank( urls ) == urls );
+
+  stats.addFailure( a );
+  stats.addSample( c, 2.0 );
+  stats.addSample( d, 0.5 );
+  // known good by speed, then unknown, then failed
+  BOOST_CHECK( stats.rank( urls ) == std::vector<Url>({ d, c, b, a }) );
+
+  // a sample clears the failure, the average is smoothed
+  stats.addSample( a, 1.0 );
+  BOOST_CHECK( ! stats.get( a ).lastFailed );
+  stats.addSample( a, 5.0 );
+  BOOST_CHECK_EQUAL( stats.get( a ).avgSeconds, 2.0 );
+  BOOST_CHECK_EQUAL( stats.get( a ).samples, 2U );
+}
+
+BOOST_AUTO_TEST_CASE(save_and_load)
+{
+  Url a( "http://a.example.com/repo" );
+  Url b( "ftp://b.example.com/repo" );
+  MirrorStats stats;
+  stats.addSample( a, 0.25 );
+  stats.addFailure( b );
+
+  filesystem::TmpDir tmp;
+  Pathname file( tmp.path() / "mirrorstats" );
+  stats.saveToFile( file );
+  BOOST_REQUIRE( PathInfo( file ).isFile() );
+
+  MirrorStats loaded( MirrorStats::fromFile( file ) );
+  BOOST_CHECK_EQUAL( loaded.get( a ).avgSeconds, 0.25 );
+  BOOST_CHECK_EQUAL( loaded.get( a ).samples, 1U );
+  BOOST_CHECK( ! loaded.get( a ).lastFailed );
+  BOOST_CHECK( loaded.get( b ).lastFailed );
+
+  BOOST_CHECK( MirrorStats::fromFile( tmp.path() / "nonexistent" ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE(race_without_network_urls)
+{
+  // Local urls are not probed, the order is kept.
+  std::vector<Url> urls { Url( "dir:/tmp/a" ), Url( "file:/tmp/b" ), Url( "cd:/" ) };
+  MirrorStats stats;
+  BOOST_CHECK( raceMirrors( urls, "repodata/repomd.xml", 3, stats ) == urls );
+  BOOST_CHECK( stats.empty() );
+}
@@ -0,0 +1,60 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/base/Logger.h>
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+#include <zypp/RepoInfo.h>
+#include <zypp/repo/RepoProvideFile.h>
+
+using namespace zypp;
+using namespace zypp::repo;
+
+namespace
+{
+  std::string readFile( const Pathname & file_r )
+  {
+    std::ifstream str( file_r.c_str() );
+    return std::string( std::istreambuf_iterator<char>( str ), std::istreambuf_iterator<char>() );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(prefetch_path)
+{
+  filesystem::TmpDir tmp;
+  const Pathname repodir( tmp.path() / "repo" );		// empty repo
+  const Pathname prefetchdir( tmp.path() / "prefetch" );
+  filesystem::assert_dir( repodir );
+
+  RepoInfo info;
+  info.setAlias( "prefetchtest" );
+  info.addBaseUrl( Url( "dir:" + repodir.asString() ) );
+  info.setPackagesPath( tmp.path() / "packages" );
+  info.setKeepPackages( true );
+
+  // the file is available in the prefetch area only
+  const std::string content( "prefetched package\n" );
+  filesystem::assert_dir( prefetchdir / info.alias() / "noarch" );
+  std::ofstream( ( prefetchdir / info.alias() / "noarch/pkg.rpm" ).c_str() ) << content;
+
+  OnMediaLocation loc( "noarch/pkg.rpm" );
+  loc.setChecksum( CheckSum( CheckSum::sha256Type(), std::istringstream( content ) ) );
+
+  RepoMediaAccess access;
+  BOOST_CHECK_THROW( access.provideFile( info, loc ), Exception );
+
+  access.setPrefetchPath( prefetchdir );
+  ManagedFile file( access.provideFile( info, loc ) );
+  BOOST_CHECK_EQUAL( file.value(), info.packagesPath() / "noarch/pkg.rpm" );
+  BOOST_CHECK_EQUAL( readFile( file ), content );
+
+  // staged files must match the checksum
+  OnMediaLocation badloc( "noarch/pkg.rpm" );
+  badloc.setChecksum( CheckSum( CheckSum::sha256Type(), std::istringstream( "something else" ) ) );
+  filesystem::unlink( info.packagesPath() / "noarch/pkg.rpm" );
+  BOOST_CHECK_THROW( access.provideFile( info, badloc ), Exception );
+}
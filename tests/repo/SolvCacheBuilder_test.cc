@@ -0,0 +1,65 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/base/Logger.h>
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/repo/SolvCacheBuilder.h>
+
+using namespace zypp;
+using namespace zypp::repo;
+
+#define YUM_DIR		TESTS_SRC_DIR "/repo/yum/data/10.2-updates-subset"
+#define SUSETAGS_DIR	TESTS_SRC_DIR "/repo/susetags/data/stable-x86-subset"
+
+namespace
+{
+  unsigned countLines( const Pathname & file_r )
+  {
+    std::ifstream str( file_r.c_str() );
+    unsigned ret = 0;
+    for ( std::string line; std::getline( str, line ); )
+      ++ret;
+    return ret;
+  }
+
+  void checkBuild( const RepoType & type_r, const Pathname & metadata_r, const std::string & alias_r )
+  {
+    filesystem::TmpDir tmp;
+    Pathname solvfile( tmp.path() / "solv" );
+
+    SolvCacheBuilder builder( type_r, metadata_r );
+    BOOST_REQUIRE( builder.supports() );
+    builder.build( solvfile );
+
+    BOOST_REQUIRE( PathInfo( solvfile ).isFile() );
+    BOOST_REQUIRE( PathInfo( solvfile.extend( ".idx" ) ).isFile() );
+
+    sat::Pool satpool( sat::Pool::instance() );
+    Repository repo( satpool.addRepoSolv( solvfile, alias_r ) );
+    BOOST_CHECK( repo.solvablesSize() > 0 );
+    // solv.idx is written from the in-memory repo, it must match the solv file.
+    BOOST_CHECK_EQUAL( countLines( solvfile.extend( ".idx" ) ), repo.solvablesSize() );
+    repo.eraseFromPool();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(build_rpmmd)
+{
+  checkBuild( RepoType::RPMMD, YUM_DIR, "yum" );
+}
+
+BOOST_AUTO_TEST_CASE(build_susetags)
+{
+  checkBuild( RepoType::YAST2, SUSETAGS_DIR, "susetags" );
+}
+
+BOOST_AUTO_TEST_CASE(unsupported_type)
+{
+  SolvCacheBuilder builder( RepoType::RPMPLAINDIR, YUM_DIR );
+  BOOST_CHECK( ! builder.supports() );
+}
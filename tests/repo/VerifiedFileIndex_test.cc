@@ -0,0 +1,77 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+#include <zypp/repo/VerifiedFileIndex_p.h>
+
+using namespace zypp;
+using namespace zypp::repo;
+
+namespace
+{
+  void writeFile( const Pathname & file_r, const std::string & content_r )
+  {
+    filesystem::assert_dir( file_r.dirname() );
+    std::ofstream str( file_r.c_str() );
+    str << content_r;
+  }
+
+  CheckSum sha256Of( const Pathname & file_r )
+  { return CheckSum( "sha256", filesystem::checksum( file_r, "sha256" ) ); }
+
+  std::string indexContent( const Pathname & dir_r )
+  {
+    std::ifstream str( (dir_r/".verified").c_str() );
+    return std::string( std::istreambuf_iterator<char>( str ), std::istreambuf_iterator<char>() );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(verifiedfileindex_check)
+{
+  filesystem::TmpDir cache;
+  Pathname file( cache.path() / "x86_64" / "some package.rpm" );
+  writeFile( file, "content" );
+  CheckSum sum( sha256Of( file ) );
+
+  BOOST_CHECK( ! VerifiedFileIndex::check( cache.path(), file, CheckSum() ) );
+  BOOST_CHECK( ! VerifiedFileIndex::check( cache.path(), file, CheckSum( "sha256", std::string( 64, '0' ) ) ) );
+  BOOST_CHECK_EQUAL( indexContent( cache.path() ), "" );
+
+  BOOST_CHECK( VerifiedFileIndex::check( cache.path(), file, sum ) );
+  std::string index( indexContent( cache.path() ) );
+  BOOST_CHECK( index.find( sum.checksum() + " x86_64/some package.rpm\n" ) != std::string::npos );
+  BOOST_CHECK( VerifiedFileIndex::check( cache.path(), file, sum ) );
+  BOOST_CHECK_EQUAL( indexContent( cache.path() ), index );	// nothing new
+
+  // a replaced file must be hashed again
+  filesystem::unlink( file );
+  writeFile( file, "other content" );
+  BOOST_CHECK( ! VerifiedFileIndex::check( cache.path(), file, sum ) );
+  BOOST_CHECK( VerifiedFileIndex::check( cache.path(), file, sha256Of( file ) ) );
+
+  // files outside the cache are not recorded
+  filesystem::TmpDir other;
+  Pathname ofile( other.path() / "outside.rpm" );
+  writeFile( ofile, "content" );
+  BOOST_CHECK( VerifiedFileIndex::check( cache.path(), ofile, sum ) );
+  BOOST_CHECK( ! PathInfo( other.path() / ".verified" ).isExist() );
+}
+
+BOOST_AUTO_TEST_CASE(verifiedfileindex_persist)
+{
+  filesystem::TmpDir cache;
+  Pathname file( cache.path() / "noarch" / "pkg.rpm" );
+  writeFile( file, "content" );
+  CheckSum sum( sha256Of( file ) );
+
+  VerifiedFileIndex::persist( cache.path(), file, sum );	// not known to be verified
+  BOOST_CHECK_EQUAL( indexContent( cache.path() ), "" );
+
+  VerifiedFileIndex::remember( file, sum );
+  VerifiedFileIndex::persist( cache.path(), file, sum );
+  BOOST_CHECK( indexContent( cache.path() ).find( " noarch/pkg.rpm\n" ) != std::string::npos );
+}
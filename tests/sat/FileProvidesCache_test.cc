@@ -0,0 +1,63 @@
+#include <cstdlib>
+#include <fstream>
+#include <boost/test/unit_test.hpp>
+
+#include "TestSetup.h"
+#include <zypp/sat/WhatProvides.h>
+#include <zypp/ZConfig.h>
+
+static filesystem::TmpDir confdir;
+
+/** <tt>"file: provider..."</tt> for all file dependencies required in the pool. */
+std::set<std::string> fileProviders( sat::Pool satpool_r )
+{
+  std::set<std::string> ret;
+  for ( sat::Solvable solv : satpool_r.solvables() )
+  {
+    for ( const Capability & cap : solv.requires() )
+    {
+      if ( ! cap.detail().isNamed() || ! str::hasPrefix( cap.detail().name().asString(), "/" ) )
+        continue;
+      str::Str line;
+      line << cap << ":";
+      for ( sat::Solvable prv : sat::WhatProvides( cap ) )
+        line << " " << prv.asString();
+      ret.insert( line );
+    }
+  }
+  return ret;
+}
+
+BOOST_AUTO_TEST_CASE(fileprovides_cache)
+{
+  // repo.cache.fileprovides must be set before ZConfig is created
+  Pathname conf( confdir.path() / "zypp.conf" );
+  std::ofstream( conf.c_str() ) << "[main]" << endl << "repo.cache.fileprovides = true" << endl;
+  ::setenv( "ZYPP_CONF", conf.c_str(), 1 );
+
+  TestSetup test( Arch_x86_64 );
+  BOOST_REQUIRE( ZConfig::instance().repo_cache_fileprovides() );
+
+  Pathname solvfile( RepoManagerOptions::makeTestSetup( test.root() ).repoSolvCachePath / "update" / "solv" );
+  Pathname cache( solvfile.extend( ".fileprovides" ) );
+
+  test.loadRepo( TESTS_SRC_DIR"/data/11.0-update", "update" );
+  std::set<std::string> searched( fileProviders( test.satpool() ) );
+  BOOST_REQUIRE( ! searched.empty() );
+  BOOST_REQUIRE( PathInfo( cache ).isFile() );
+  ino_t ino = PathInfo( cache ).ino();
+
+  // Loading the solv file again restores the file provides;
+  // as nothing new was searched, the cache is not rewritten.
+  test.satpool().reposEraseAll();
+  test.loadRepo( solvfile, "update" );
+  BOOST_CHECK( fileProviders( test.satpool() ) == searched );
+  BOOST_CHECK_EQUAL( PathInfo( cache ).ino(), ino );
+
+  // An outdated cache is ignored and rewritten.
+  test.satpool().reposEraseAll();
+  std::ofstream( cache.c_str() ) << "# outdated" << endl << "= /bin/sh" << endl;
+  test.loadRepo( solvfile, "update" );
+  BOOST_CHECK( fileProviders( test.satpool() ) == searched );
+  BOOST_CHECK( PathInfo( cache ).ino() != ino );
+}
@@ -0,0 +1,132 @@
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+#include <zypp/misc/CheckAccessDeleted.h>
+
+using std::endl;
+using namespace zypp;
+
+namespace
+{
+  /** A child process, killed when going out of scope. */
+  struct Child
+  {
+    ~Child()
+    {
+      if ( _pid > 0 )
+      {
+        ::kill( _pid, SIGKILL );
+        ::waitpid( _pid, nullptr, 0 );
+      }
+    }
+    pid_t _pid = -1;
+  };
+
+  /** The ProcInfo of \a pid_r or \c nullptr. */
+  const CheckAccessDeleted::ProcInfo * findPid( const CheckAccessDeleted & check_r, pid_t pid_r )
+  {
+    for ( const auto & pinfo : check_r )
+    {
+      if ( pinfo.pid == str::numstring( pid_r ) )
+        return &pinfo;
+    }
+    return nullptr;
+  }
+
+  bool hasFile( const CheckAccessDeleted::ProcInfo & pinfo_r, const Pathname & file_r )
+  { return std::find( pinfo_r.files.begin(), pinfo_r.files.end(), file_r.asString() ) != pinfo_r.files.end(); }
+
+  // Not below /tmp or /var, which are ignored for mapped files.
+  const Pathname testRoot { TESTS_BUILD_DIR };
+}
+
+BOOST_AUTO_TEST_CASE(deleted_library)
+{
+  filesystem::TmpDir tmp( testRoot, "CheckAccessDeleted." );
+  const Pathname lib( tmp.path() / "lib" / "libzypp-fake.so.1" );
+  filesystem::assert_dir( lib.dirname() );
+  {
+    std::ofstream out( lib.c_str() );
+    out << std::string( 4096, 'x' );
+  }
+
+  int pipefd[2];
+  BOOST_REQUIRE_EQUAL( ::pipe( pipefd ), 0 );
+  Child child;
+  child._pid = ::fork();
+  BOOST_REQUIRE( child._pid >= 0 );
+  if ( child._pid == 0 )
+  {
+    // map it like the loader does with a library and wait to be killed
+    int fd = ::open( lib.c_str(), O_RDONLY );
+    void * addr = ( fd < 0 ? MAP_FAILED : ::mmap( nullptr, 4096, PROT_READ, MAP_PRIVATE, fd, 0 ) );
+    char ok = ( addr == MAP_FAILED ? '0' : '1' );
+    ::write( pipefd[1], &ok, 1 );
+    while ( true )
+      ::pause();
+  }
+  ::close( pipefd[1] );
+  char ok = '0';
+  BOOST_REQUIRE_EQUAL( ::read( pipefd[0], &ok, 1 ), 1 );
+  ::close( pipefd[0] );
+  BOOST_REQUIRE_EQUAL( ok, '1' );
+
+  // still mapped, but not yet deleted
+  CheckAccessDeleted check( false );
+  check.check();
+  BOOST_CHECK( ! findPid( check, child._pid ) );
+
+  filesystem::unlink( lib );
+  check.check();
+  const CheckAccessDeleted::ProcInfo * pinfo = findPid( check, child._pid );
+  BOOST_REQUIRE( pinfo );
+  BOOST_CHECK_EQUAL( pinfo->ppid, str::numstring( ::getpid() ) );
+  BOOST_CHECK_EQUAL( pinfo->puid, str::numstring( ::getuid() ) );
+  BOOST_CHECK_EQUAL( pinfo->files.size(), 1U );
+  BOOST_CHECK( hasFile( *pinfo, lib ) );	// without the ' (deleted)'
+}
+
+BOOST_AUTO_TEST_CASE(deleted_executable)
+{
+  filesystem::TmpDir tmp( testRoot, "CheckAccessDeleted." );
+  const Pathname exe( tmp.path() / "bin" / "zypp-fake-sleep" );
+  filesystem::assert_dir( exe.dirname() );
+  BOOST_REQUIRE_EQUAL( filesystem::copy( "/bin/sleep", exe ), 0 );
+  ::chmod( exe.c_str(), 0755 );
+
+  Child child;
+  child._pid = ::fork();
+  BOOST_REQUIRE( child._pid >= 0 );
+  if ( child._pid == 0 )
+  {
+    ::execl( exe.c_str(), exe.c_str(), "60", (char *)0 );
+    ::_exit( 127 );
+  }
+  // wait for the exec
+  const Pathname procexe( Pathname("/proc") / str::numstring( child._pid ) / "exe" );
+  for ( unsigned i = 0; i < 100 && filesystem::readlink( procexe ) != exe; ++i )
+    ::usleep( 10000 );
+  BOOST_REQUIRE_EQUAL( filesystem::readlink( procexe ), exe );
+
+  filesystem::unlink( exe );
+  BOOST_CHECK_EQUAL( filesystem::readlink( procexe ).asString(), exe.asString() + " (deleted)" );
+
+  CheckAccessDeleted check;
+  const CheckAccessDeleted::ProcInfo * pinfo = findPid( check, child._pid );
+  BOOST_REQUIRE( pinfo );
+  BOOST_CHECK_EQUAL( pinfo->command, exe.basename() );	// without the ' (deleted)'
+  BOOST_CHECK_EQUAL( pinfo->files.size(), 1U );		// the exe and its mapping
+  BOOST_CHECK( hasFile( *pinfo, exe ) );
+}
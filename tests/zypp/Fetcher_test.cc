@@ -2,6 +2,7 @@
 
 #include <zypp/MediaSetAccess.h>
 #include <zypp/Fetcher.h>
+#include <zypp/ZConfig.h>
 
 #include "WebServer.h"
 
@@ -371,6 +372,54 @@ BOOST_AUTO_TEST_CASE(enqueuedir_http)
   web.stop();
 }
 
+BOOST_AUTO_TEST_CASE(enqueue_digested_http_prefetch)
+{
+  WebServer web((Pathname(TESTS_SRC_DIR) + "/zypp/data/Fetcher/remote-site").c_str(), 10001);
+  BOOST_REQUIRE( web.start() );
+  ZConfig::instance().set_download_prefetch_files( true );
+
+  // digested files are downloaded concurrently before they are provided
+  {
+      MediaSetAccess media( web.url(), "/" );
+      Fetcher fetcher;
+      filesystem::TmpDir dest;
+
+      OnMediaLocation loc1("/complexdir/subdir1/subdir1-file1.txt");
+      loc1.setChecksum(CheckSum::sha1("f1d2d2f924e986ac86fdf7b36c94bcdf32beec15"));
+      OnMediaLocation loc2("/complexdir/subdir1/subdir1-file2.txt");
+      loc2.setChecksum(CheckSum::sha1("e242ed3bffccdf271b7fbaf34ed72d089537b42f"));
+      fetcher.enqueueDigested(loc1);
+      fetcher.enqueueDigested(loc2);
+      fetcher.start( dest.path(), media );
+      fetcher.reset();
+
+      BOOST_CHECK( filesystem::is_checksum( dest.path() + "/complexdir/subdir1/subdir1-file1.txt", loc1.checksum() ) );
+      BOOST_CHECK( filesystem::is_checksum( dest.path() + "/complexdir/subdir1/subdir1-file2.txt", loc2.checksum() ) );
+  }
+
+  // a prefetched file with the wrong checksum is not taken
+  {
+      MediaSetAccess media( web.url(), "/" );
+      Fetcher fetcher;
+      filesystem::TmpDir dest;
+
+      OnMediaLocation loc1("/complexdir/subdir1/subdir1-file1.txt");
+      loc1.setChecksum(CheckSum::sha1("f1d2d2f924e986ac86fdf7b36c94bcdf32beec15"));
+      OnMediaLocation loc2("/complexdir/subdir1/subdir1-file2.txt");
+      loc2.setChecksum(CheckSum::sha1("e242ed3bffccdf271b7fbaf34ed72d089537b42e"));
+      fetcher.enqueueDigested(loc1);
+      fetcher.enqueueDigested(loc2);
+      BOOST_CHECK_THROW( fetcher.start( dest.path(), media ), FileCheckException);
+      fetcher.reset();
+
+      BOOST_CHECK( PathInfo(dest.path() + "/complexdir/subdir1/subdir1-file1.txt").isExist() );
+      BOOST_CHECK( ! PathInfo(dest.path() + "/complexdir/subdir1/subdir1-file2.txt").isExist() );
+  }
+
+  ZConfig::instance().set_default_download_prefetch_files();
+  web.stop();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
 // vim: set ts=2 sts=2 sw=2 ai et:
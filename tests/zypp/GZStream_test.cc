@@ -1,6 +1,8 @@
 // Boost.Test
 #include <boost/test/unit_test.hpp>
 
+#include <vector>
+
 #include <zypp/base/GzStream.h>
 #include <zypp/Pathname.h>
 #include <zypp/base/InputStream.h>
@@ -78,3 +80,48 @@ BOOST_AUTO_TEST_CASE(gz_seek)
     BOOST_REQUIRE_EQUAL( test, "Hello" );
   }
 }
+
+BOOST_AUTO_TEST_CASE(gz_bulk_read)
+{
+  const zypp::Pathname file = zypp::Pathname(TESTS_BUILD_DIR) / "testbulk.gz";
+  std::string testString;
+  for ( unsigned i = 0; i < 100000; ++i )
+    testString += std::to_string( i ) + ( i % 7 ? " " : "\n" );
+
+  {
+    zypp::ofgzstream strOut( file.c_str() );
+    BOOST_REQUIRE( strOut.is_open() );
+    strOut << testString;
+  }
+
+  // Mix reads smaller and larger than the streambufs buffer; large
+  // ones are decompressed straight into the callers buffer.
+  {
+    std::string test;
+    std::vector<char> buf( 20000 );
+    const std::streamsize sizes[] { 10, 20000, 1, 3000, 1023, 1024, 9999 };
+    zypp::ifgzstream str( file.c_str() );
+    for ( unsigned i = 0; str.good(); ++i )
+    {
+      str.read( buf.data(), sizes[i % 7] );
+      test.append( buf.data(), str.gcount() );
+    }
+    BOOST_REQUIRE_EQUAL( test.size(), testString.size() );
+    BOOST_REQUIRE( test == testString );
+  }
+
+  // Seeking after a bulk read
+  {
+    std::vector<char> buf( 20000 );
+    zypp::ifgzstream str( file.c_str() );
+    str.read( buf.data(), 20000 );
+    BOOST_REQUIRE_EQUAL( str.tellg(), 20000 );
+    str.seekg( 100, std::ios_base::beg );
+    str.read( buf.data(), 10 );
+    BOOST_REQUIRE_EQUAL( std::string( buf.data(), 10 ), testString.substr( 100, 10 ) );
+    str.seekg( 50000, std::ios_base::beg );
+    str.read( buf.data(), 2000 );
+    BOOST_REQUIRE_EQUAL( std::string( buf.data(), 2000 ), testString.substr( 50000, 2000 ) );
+    BOOST_REQUIRE_EQUAL( str.tellg(), 52000 );
+  }
+}
@@ -204,6 +204,21 @@ BOOST_AUTO_TEST_CASE(signature_test)
 
     BOOST_CHECK(keyring.verifyFileSignature( DATADIR + "repomd.xml", DATADIR + "repomd.xml.asc"));
     BOOST_CHECK( ! keyring.verifyFileSignature( DATADIR + "repomd.xml.corrupted", DATADIR + "repomd.xml.asc"));
+
+    std::vector<std::pair<Pathname,Pathname>> files;
+    for ( unsigned i = 0; i < 4; ++i )
+    {
+      files.push_back( { DATADIR + "repomd.xml", DATADIR + "repomd.xml.asc" } );
+      files.push_back( { DATADIR + "repomd.xml.corrupted", DATADIR + "repomd.xml.asc" } );
+    }
+    for ( unsigned threads : { 1, 3 } )
+    {
+      std::vector<bool> res { keyring.verifyFileSignatures( files, false, threads ) };
+      BOOST_REQUIRE_EQUAL( res.size(), files.size() );
+      for ( unsigned i = 0; i < res.size(); ++i )
+        BOOST_CHECK_EQUAL( res[i], i % 2 == 0 );
+    }
+    BOOST_CHECK( keyring.verifyFileSignatures( {} ).empty() );
   }
 }
 
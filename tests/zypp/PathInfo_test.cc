@@ -10,6 +10,7 @@
 #include <zypp/base/LogControl.h>
 #include <zypp/base/Exception.h>
 #include <zypp/PathInfo.h>
+#include <zypp/Digest.h>
 #include <zypp/TmpPath.h>
 
 using boost::unit_test::test_suite;
@@ -48,6 +49,37 @@ BOOST_AUTO_TEST_CASE(pathinfo_checksum_test)
   BOOST_REQUIRE( is_checksum( file.path(), file_md5 ) );
 }
 
+/**
+ * Test case for
+ * std::vector<bool> verifyFiles( const std::vector<std::pair<Pathname,CheckSum>> & files_r, unsigned threads_r );
+ */
+BOOST_AUTO_TEST_CASE(pathinfo_verifyfiles_test)
+{
+  TmpDir dir;
+  std::string big;
+  for ( unsigned i = 0; i < 100000; ++i )
+    big += std::to_string( i );	// more than one read block
+  std::ofstream( (dir.path()/"small").c_str() ) << "I will test the checksum of this";
+  std::ofstream( (dir.path()/"big").c_str() ) << big;
+
+  CheckSum bigSum( CheckSum::sha256( Digest::digest( "sha256", big ) ) );
+  BOOST_CHECK_EQUAL( checksum( dir.path()/"big", "SHA256" ), bigSum.checksum() );
+
+  std::vector<std::pair<Pathname,CheckSum>> files {
+    { dir.path()/"small",   CheckSum( "sha1", "142df4277c326f3549520478c188cab6e3b5d042" ) },
+    { dir.path()/"big",     bigSum },
+    { dir.path()/"small",   CheckSum( "md5", "00000000000000000000000000000000" ) },
+    { dir.path()/"missing", CheckSum( "md5", "f139a810b84d82d1f29fc53c5e59beae" ) },
+  };
+  std::vector<bool> expected { true, true, false, false };
+  BOOST_CHECK( verifyFiles( files ) == expected );
+  BOOST_CHECK( verifyFiles( files, 1 ) == expected );
+
+  // a modified file is hashed again
+  std::ofstream( (dir.path()/"small").c_str() ) << "I will test the checksum of that";
+  BOOST_CHECK( ! is_checksum( dir.path()/"small", files[0].second ) );
+}
+
 BOOST_AUTO_TEST_CASE(pathinfo_is_exist_test)
 {
   TmpDir dir;
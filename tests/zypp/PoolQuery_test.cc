@@ -1,6 +1,7 @@
 #include "TestSetup.h"
 #include <zypp/PoolQuery.h>
 #include <zypp/PoolQueryUtil.tcc>
+#include <zypp/PoolQueryResult.h>
 
 #define BOOST_TEST_MODULE PoolQuery
 
@@ -987,3 +988,93 @@ BOOST_AUTO_TEST_CASE(zypperLocksSerialize)
     }
   }
 }
+
+/////////////////////////////////////////////////////////////////////////////
+// resultCache
+/////////////////////////////////////////////////////////////////////////////
+
+/** The query result when iterating the pool. */
+std::set<sat::Solvable> searched( const PoolQuery & q )
+{ return std::set<sat::Solvable>( q.begin(), q.end() ); }
+
+/** The query result from the cache. */
+std::set<sat::Solvable> cached( const PoolQuery & q )
+{
+  std::set<sat::Solvable> ret;
+  sat::Map result( q.resultMap() );
+  for ( sat::Map::size_type idx = 0; idx < result.size(); ++idx )
+    if ( result.test( idx ) )
+      ret.insert( sat::Solvable( idx ) );
+  return ret;
+}
+
+BOOST_AUTO_TEST_CASE(resultCache)
+{
+  cout << "****resultCache****"  << endl;
+  PoolQuery::setResultCacheEnabled( true );
+
+  PoolQuery q;
+  q.addString("zypper");
+  q.addAttribute(sat::SolvAttr::name);
+
+  PoolQuery r;
+  r.addString("zypper");
+  r.addAttribute(sat::SolvAttr::name);
+  r.addRepo("zyppsvn");
+
+  std::set<sat::Solvable> all( searched( q ) );
+  BOOST_CHECK( ! all.empty() );
+  BOOST_CHECK( cached( q ) == all );
+  BOOST_CHECK( cached( q ) == all );	// from the cache
+  BOOST_CHECK_EQUAL( q.size(), all.size() );
+  BOOST_CHECK( cached( r ) == searched( r ) );
+  BOOST_CHECK( cached( r ).size() < all.size() );
+
+  // the result follows repo changes
+  sat::Pool::instance().reposErase( "zyppsvn" );
+  BOOST_CHECK( cached( q ) == searched( q ) );
+  BOOST_CHECK( cached( q ).size() < all.size() );
+  BOOST_CHECK( cached( r ).empty() );
+  BOOST_CHECK( q.size() );
+
+  test.loadRepo( TESTS_SRC_DIR "/data/OBS_zypp_svn-11.1", "zyppsvn" );
+  BOOST_CHECK( cached( q ) == searched( q ) );
+  BOOST_CHECK_EQUAL( cached( q ).size(), all.size() );
+  BOOST_CHECK( cached( r ) == searched( r ) );
+  BOOST_CHECK_EQUAL( PoolQueryResult( q ).size(), all.size() );
+
+  PoolQuery::setResultCacheEnabled( false );
+  BOOST_CHECK( cached( q ) == searched( q ) );
+}
+
+BOOST_AUTO_TEST_CASE(resultCache_key)
+{
+  cout << "****resultCache_key****"  << endl;
+  PoolQuery::setResultCacheEnabled( true );
+
+  // word and substring queries serialize alike, but must not share a cache entry
+  PoolQuery s;
+  s.addString("zypp");
+  s.addAttribute(sat::SolvAttr::name);
+  s.setMatchSubstring();
+
+  PoolQuery w;
+  w.addString("zypp");
+  w.addAttribute(sat::SolvAttr::name);
+  w.setMatchWord();
+
+  BOOST_CHECK( cached( s ) == searched( s ) );
+  BOOST_CHECK( cached( w ) == searched( w ) );
+  BOOST_CHECK( searched( w ).size() < searched( s ).size() );
+  BOOST_CHECK_EQUAL( w.size(), searched( w ).size() );
+  BOOST_CHECK_EQUAL( s.size(), searched( s ).size() );
+  BOOST_CHECK( ! w.empty() );
+
+  PoolQuery none;
+  none.addString("nosuchpackagename");
+  none.addAttribute(sat::SolvAttr::name);
+  BOOST_CHECK( none.empty() );
+  BOOST_CHECK_EQUAL( none.size(), 0 );
+
+  PoolQuery::setResultCacheEnabled( false );
+}
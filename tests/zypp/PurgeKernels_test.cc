@@ -355,3 +355,74 @@ BOOST_DATA_TEST_CASE(purge_kernels, bdata::make( maketestdata() ), repoPath, una
 
   BOOST_REQUIRE_EQUAL( expectedRemovals.size(), removeCount );
 }
+
+namespace {
+  std::set<std::string> purgeAndCollectRemovals( const Pathname &repoPath, const std::string &uname_r, const std::string &keepSpec )
+  {
+    TestSetup test( Arch_x86_64 );
+    test.loadTestcaseRepos( repoPath );
+
+    PurgeKernels krnls;
+    krnls.setUnameR( uname_r );
+    krnls.setKernelArch( Arch_x86_64 );
+    krnls.setKeepSpec( keepSpec );
+    krnls.markObsoleteKernels();
+
+    auto pool = ResPool::instance();
+    BOOST_REQUIRE( pool.resolver().resolvePool() );
+
+    std::set<std::string> removals;
+    const filter::ByStatus toBeUninstalledFilter( &ResStatus::isToBeUninstalled );
+    for ( const PoolItem & pi : pool.byStatus( toBeUninstalledFilter ) )
+      removals.insert( makeNVRA( pi ) );
+    return removals;
+  }
+}
+
+// All removals are valid, so they are done in a single solver run.
+BOOST_AUTO_TEST_CASE(purge_kernels_batch_removal)
+{
+  const std::set<std::string> removals = purgeAndCollectRemovals( TESTS_SRC_DIR"/zypp/data/PurgeKernels/simple", "1-3-default", "oldest,running,latest" );
+  const std::set<std::string> expected {
+    "kernel-default-1-2.x86_64",
+    "kernel-default-devel-1-2.x86_64",
+    "kernel-default-devel-debuginfo-1-2.x86_64",
+    "kernel-devel-1-2.noarch",
+    "kernel-livepatch-default-1-2.x86_64",
+    "kernel-syms-1-2.x86_64",
+    "kernel-default-1-4.x86_64",
+    "kernel-default-devel-1-4.x86_64",
+    "kernel-default-devel-debuginfo-1-4.x86_64",
+    "kernel-devel-1-4.noarch",
+    "kernel-syms-1-4.x86_64",
+    "kernel-devel-1-1.2.noarch",
+    "kernel-source-1-1.2.noarch",
+    "kernel-default-devel-1-3.x86_64",
+    "kernel-default-devel-debuginfo-1-3.x86_64",
+    "kernel-devel-1-3.noarch",
+  };
+  BOOST_CHECK_EQUAL_COLLECTIONS( removals.begin(), removals.end(), expected.begin(), expected.end() );
+}
+
+// Removing kernel-default-1-1 would take 'foo' with it, so the single solver run
+// is reverted. The per package fallback must still remove everything else.
+BOOST_AUTO_TEST_CASE(purge_kernels_batch_conflict_fallback)
+{
+  const std::set<std::string> removals = purgeAndCollectRemovals( TESTS_SRC_DIR"/zypp/data/PurgeKernels/withdeps", "1-5-default", "running" );
+  BOOST_CHECK( removals.count( "kernel-default-1-1.x86_64" ) == 0 );
+  BOOST_CHECK( removals.count( "foo-1-1.x86_64" ) == 0 );
+  const std::set<std::string> expected {
+    "kernel-default-1-2.x86_64",
+    "kernel-default-extra-1-2.x86_64",
+    "kernel-default-devel-1-2.x86_64",
+    "kernel-default-devel-debuginfo-1-2.x86_64",
+    "kernel-devel-1-2.noarch",
+    "kernel-livepatch-default-1-2.x86_64",
+    "kernel-syms-1-2.x86_64",
+    "kernel-default-devel-1-1.x86_64",
+    "kernel-default-devel-debuginfo-1-1.x86_64",
+    "kernel-devel-1-1.noarch",
+    "kernel-syms-1-1.x86_64",
+  };
+  BOOST_CHECK_EQUAL_COLLECTIONS( removals.begin(), removals.end(), expected.begin(), expected.end() );
+}
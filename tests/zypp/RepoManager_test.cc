@@ -271,6 +271,52 @@ BOOST_AUTO_TEST_CASE(repomanager_test)
 
 }
 
+BOOST_AUTO_TEST_CASE(refresh_repositories_test)
+{
+  KeyRingTestReceiver keyring_callbacks;
+  keyring_callbacks.answerAcceptKey(KeyRingReport::KEY_TRUST_TEMPORARILY);
+  keyring_callbacks.answerAcceptVerFailed(true);
+  keyring_callbacks.answerAcceptUnknownKey(true);
+  keyring_callbacks.answerAcceptUnsignedFile(true);
+
+  TmpDir tmpCachePath;
+  RepoManagerOptions opts( RepoManagerOptions::makeTestSetup( tmpCachePath ) ) ;
+  RepoManager manager(opts);
+
+  std::vector<RepoInfo> repos;
+  {
+    RepoInfo info;
+    info.setAlias("yum");
+    info.setBaseUrl( (Pathname(TESTS_SRC_DIR) + "/repo/yum/data/10.2-updates-subset").asDirUrl() );
+    info.setType(RepoType::RPMMD);
+    repos.push_back( info );
+  }
+  {
+    RepoInfo info;
+    info.setAlias("susetags");
+    info.setBaseUrl( (Pathname(TESTS_SRC_DIR) + "/repo/susetags/data/stable-x86-subset").asDirUrl() );
+    info.setType(RepoType::YAST2);
+    repos.push_back( info );
+  }
+  {
+    RepoInfo info;
+    info.setAlias("broken");
+    info.setBaseUrl( (tmpCachePath.path() / "does-not-exist").asDirUrl() );
+    info.setType(RepoType::RPMMD);
+    repos.push_back( info );
+  }
+
+  RepoManager::RefreshErrors errors( manager.refreshRepositories( repos, RepoManager::RefreshForced, 2 ) );
+  BOOST_CHECK_EQUAL( errors.size(), 1 );
+  BOOST_CHECK( errors.count( "broken" ) );
+
+  BOOST_CHECK( manager.isCached( repos[0] ) );
+  BOOST_CHECK( manager.isCached( repos[1] ) );
+  BOOST_CHECK( ! manager.isCached( repos[2] ) );
+  // cookie written, so a 2nd run does not rebuild
+  BOOST_CHECK_EQUAL( manager.cacheStatus( repos[0] ), manager.metadataStatus( repos[0] ) );
+}
+
 BOOST_AUTO_TEST_CASE(repo_seting_test)
 {
   RepoInfo repo;
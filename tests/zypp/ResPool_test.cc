@@ -0,0 +1,66 @@
+#include <boost/test/unit_test.hpp>
+
+#include <iostream>
+
+#include "TestSetup.h"
+#include <zypp/base/LogTools.h>
+
+#include <zypp/ResPool.h>
+
+using std::cout;
+using std::endl;
+using namespace zypp;
+
+static TestSetup test( Arch_x86_64 );
+
+/** Number of items in the pool and whether each one is found by ident (exactly once). */
+unsigned checkByIdent()
+{
+  ResPool pool( ResPool::instance() );
+  unsigned items = 0;
+  unsigned indexed = 0;
+  for ( const PoolItem & pi : pool )
+  {
+    ++items;
+    unsigned found = 0;
+    for ( const PoolItem & ident : pool.byIdent( pi ) )
+    {
+      BOOST_CHECK_EQUAL( ident.satSolvable().ident(), pi.satSolvable().ident() );
+      if ( ident == pi )
+        ++found;
+    }
+    BOOST_CHECK_EQUAL( found, 1U );
+    indexed += found;
+  }
+  BOOST_CHECK_EQUAL( items, indexed );
+  return items;
+}
+
+BOOST_AUTO_TEST_CASE(id2item_follows_repo_changes)
+{
+  ResPool pool( ResPool::instance() );
+  BOOST_CHECK_EQUAL( checkByIdent(), 0U );
+
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "opensuse" );
+  unsigned opensuse = checkByIdent();
+  BOOST_CHECK( opensuse );
+
+  test.loadRepo( TESTS_SRC_DIR "/data/OBS_zypp_svn-11.1", "zyppsvn" );
+  unsigned both = checkByIdent();
+  BOOST_CHECK( both > opensuse );
+
+  sat::Pool::instance().reposErase( "opensuse" );
+  unsigned zyppsvn = checkByIdent();
+  BOOST_CHECK_EQUAL( zyppsvn, both - opensuse );
+  BOOST_CHECK( pool.byIdent( ResKind::package, "glibc" ).empty() );
+
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "opensuse" );
+  BOOST_CHECK_EQUAL( checkByIdent(), both );
+  BOOST_CHECK( ! pool.byIdent( ResKind::package, "glibc" ).empty() );
+
+  // removing all repos lets the pool reuse the IDs
+  sat::Pool::instance().reposEraseAll();
+  BOOST_CHECK_EQUAL( checkByIdent(), 0U );
+  test.loadRepo( TESTS_SRC_DIR "/data/OBS_zypp_svn-11.1", "zyppsvn" );
+  BOOST_CHECK_EQUAL( checkByIdent(), zyppsvn );
+}
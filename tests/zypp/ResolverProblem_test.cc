@@ -0,0 +1,63 @@
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <thread>
+#include <zypp/ResolverProblem.h>
+#include <zypp/ProblemSolution.h>
+
+using namespace zypp;
+
+BOOST_AUTO_TEST_CASE(formatter)
+{
+  unsigned calls = 0;
+  ResolverProblem_Ptr problem = new ResolverProblem( [&calls]( std::string & description_r, std::string & details_r, std::vector<std::string> & completeProblemInfo_r ) {
+    ++calls;
+    description_r = "description";
+    details_r = "details";
+    completeProblemInfo_r = { "rule1", "rule2" };
+  } );
+  // solutions are added right away and do not trigger the formatter
+  problem->addSolution( new ProblemSolution( "solution" ) );
+  ResolverProblem copy( *problem );
+  BOOST_CHECK_EQUAL( calls, 0 );
+  BOOST_CHECK_EQUAL( problem->solutions().size(), 1 );
+  BOOST_CHECK_EQUAL( calls, 0 );
+
+  BOOST_CHECK_EQUAL( problem->description(), "description" );
+  BOOST_CHECK_EQUAL( calls, 1 );
+  BOOST_CHECK_EQUAL( problem->details(), "details" );
+  BOOST_CHECK_EQUAL( problem->completeProblemInfo().size(), 2 );
+  BOOST_CHECK_EQUAL( calls, 1 );
+
+  // copy made before formatting shares the result
+  BOOST_CHECK_EQUAL( copy.description(), "description" );
+  BOOST_CHECK_EQUAL( copy.solutions().size(), 1 );
+  BOOST_CHECK_EQUAL( calls, 1 );
+
+  // setter takes over the formatted texts, copies are not affected
+  copy.setDescription( "changed" );
+  BOOST_CHECK_EQUAL( copy.description(), "changed" );
+  BOOST_CHECK_EQUAL( copy.details(), "details" );
+  BOOST_CHECK_EQUAL( problem->description(), "description" );
+  BOOST_CHECK_EQUAL( calls, 1 );
+}
+
+BOOST_AUTO_TEST_CASE(formatter_threads)
+{
+  std::atomic<unsigned> calls( 0 );
+  ResolverProblem problem( [&calls]( std::string & description_r, std::string &, std::vector<std::string> & ) {
+    ++calls;
+    std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    description_r = "description";
+  } );
+
+  std::vector<ResolverProblem> copies( 8, problem );
+  std::vector<std::thread> threads;
+  std::atomic<unsigned> ok( 0 );
+  for ( const ResolverProblem & copy : copies )
+    threads.emplace_back( [&copy,&ok]() { if ( copy.description() == "description" ) ++ok; } );
+  for ( std::thread & thread : threads )
+    thread.join();
+
+  BOOST_CHECK_EQUAL( calls, 1 );
+  BOOST_CHECK_EQUAL( ok, copies.size() );
+}
@@ -0,0 +1,96 @@
+#include <cstdlib>
+#include <fstream>
+#include <boost/test/unit_test.hpp>
+#define BOOST_CHECK_MODULE ResolverReuse
+using namespace boost::unit_test;
+
+#include "TestSetup.h"
+#include <zypp/ResPool.h>
+#include <zypp/ZConfig.h>
+#include <zypp/base/LogControl.h>
+
+static TestSetup test( TestSetup::initLater );
+static filesystem::TmpDir confdir;
+
+struct BAD_TESTCASE {};
+
+/** Count the resolver runs reusing the solver (as logged by SATResolver::solverInit). */
+struct ReuseCounter : public log::LineWriter
+{
+  virtual void writeOut( const std::string & formated_r )
+  {
+    if ( formated_r.find( "reusing the solver" ) != std::string::npos )
+      ++_reused;
+  }
+  unsigned _reused = 0;
+};
+static shared_ptr<ReuseCounter> counter( new ReuseCounter );
+
+typedef std::set<PoolItem> PoolItemSet;
+
+PoolItemSet resolve( bool reuse_r = true )
+{
+  unsigned reused = counter->_reused;
+  if ( ! test.resolver().resolvePool() )
+    throw BAD_TESTCASE();
+  BOOST_CHECK_EQUAL( counter->_reused, reuse_r ? reused+1 : reused );
+
+  return { make_filter_begin<resfilter::ByTransact>(test.pool()), make_filter_end<resfilter::ByTransact>(test.pool()) };
+}
+
+inline PoolItem getPi( const std::string & name_r, bool installed_r )
+{
+  for ( const auto & pi : test.pool().byName( name_r ) )
+  { if ( pi.isSystem() == installed_r ) return pi; }
+  throw BAD_TESTCASE();
+}
+
+struct TestInit {
+  TestInit() {
+    // solver.reuseSolver must be set before ZConfig is created
+    Pathname conf( confdir.path() / "zypp.conf" );
+    std::ofstream( conf.c_str() ) << "[main]" << endl << "solver.reuseSolver = true" << endl;
+    ::setenv( "ZYPP_CONF", conf.c_str(), 1 );
+
+    test = TestSetup( );
+    test.loadTestcaseRepos( TESTS_SRC_DIR"/data/TCNamespaceRecommends" );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+/////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE(reuse)
+{
+  BOOST_REQUIRE( ZConfig::instance().solver_reuseSolver() );
+  base::LogControl::TmpLineWriter tmp( counter );
+
+  PoolItem Ip	= getPi( "aspell", true );
+  PoolItem Ap	= getPi( "aspell", false );
+  PoolItem Apde	= getPi( "aspell-de", false );
+  PoolItem Aprec	= getPi( "recommended-pkg", false );
+
+  // The first run creates the solver...
+  resolve( false );
+
+  // ...the next ones reuse it. Results must not depend on the previous runs...
+  for ( unsigned i = 0; i < 3; ++i )
+  {
+    Ap.status().setTransact( true, ResStatus::USER );
+    BOOST_CHECK_EQUAL( resolve(), PoolItemSet({ Ap, Ip, Apde, Aprec }) );
+    Ap.status().setTransact( false, ResStatus::USER );
+
+    Apde.status().setLock( true, ResStatus::USER );
+    Ap.status().setTransact( true, ResStatus::USER );
+    BOOST_CHECK_EQUAL( resolve(), PoolItemSet({ Ap, Ip, Aprec }) );
+    Ap.status().setTransact( false, ResStatus::USER );
+    Apde.status().setLock( false, ResStatus::USER );
+  }
+
+  // ...nor on a pool change in between, which needs a new solver.
+  test.satpool().reposInsert( "dummy" ).eraseFromPool();
+  Ap.status().setTransact( true, ResStatus::USER );
+  BOOST_CHECK_EQUAL( resolve( false ), PoolItemSet({ Ap, Ip, Apde, Aprec }) );
+  Ap.status().setTransact( false, ResStatus::USER );
+}
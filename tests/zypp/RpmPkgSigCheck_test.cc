@@ -1,6 +1,7 @@
 #include "TestSetup.h"
 
 #include <zypp/target/rpm/RpmDb.h>
+#include <zypp/ExternalProgram.h>
 using target::rpm::RpmDb;
 
 #define DATADIR (Pathname(TESTS_SRC_DIR) / "/zypp/data/RpmPkgSigCheck")
@@ -287,3 +288,63 @@ BOOST_AUTO_TEST_CASE(signed_broken_header_pkg_withkey)
   } };
   BOOST_CHECK_EQUAL( xpct, cs );
 }
+
+///////////////////////////////////////////////////////////////////
+// Keys are imported and removed in-process. Package checks must
+// follow the changes, also if done by another process.
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  /** The gpg-pubkey in the rpm database with version \a version_r or \ref Edition::noedition */
+  Edition rpmKey( const std::string & version_r )
+  {
+    for ( const Edition & ed : test.target().rpmDb().pubkeyEditions() )
+      if ( ed.version() == version_r )
+	return ed;
+    return Edition::noedition;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(remove_and_import_keys)
+{
+  RpmDb & rpmdb( test.target().rpmDb() );
+  Pathname rpm { DATADIR/"signed.rpm" };
+  BOOST_REQUIRE( rpmKey( "3dbdc284" ) != Edition::noedition );
+  BOOST_CHECK_EQUAL( gcheckPackageSignature( rpm ).result, RpmDb::CHK_OK );
+
+  rpmdb.removePubkey( PublicKey( DATADIR/"signed.key" ) );
+  BOOST_CHECK( rpmKey( "3dbdc284" ) == Edition::noedition );
+  BOOST_CHECK_EQUAL( gcheckPackageSignature( rpm ).result, RpmDb::CHK_NOKEY );
+
+  // one armored block holding two certificates: signed.key and 38f33cd1
+  rpmdb.importPubkey( PublicKey( DATADIR/"twokeys.asc" ) );
+  BOOST_CHECK( rpmKey( "3dbdc284" ) != Edition::noedition );
+#ifndef HAVE_NO_PGPPUBKEYCERTLEN
+  BOOST_CHECK( rpmKey( "38f33cd1" ) != Edition::noedition );
+#endif
+  BOOST_CHECK_EQUAL( gcheckPackageSignature( rpm ).result, RpmDb::CHK_OK );
+}
+
+BOOST_AUTO_TEST_CASE(remove_key_externally)
+{
+  if ( ! PathInfo( "/usr/bin/rpm" ).isFile() )
+    return;
+
+  RpmDb & rpmdb( test.target().rpmDb() );
+  Pathname rpm { DATADIR/"signed.rpm" };
+  Edition key { rpmKey( "3dbdc284" ) };
+  BOOST_REQUIRE( key != Edition::noedition );
+  BOOST_CHECK_EQUAL( gcheckPackageSignature( rpm ).result, RpmDb::CHK_OK );	// keyring is loaded
+
+  ExternalProgram prog( { "/usr/bin/rpm", "--root", rpmdb.root().asString(), "--dbpath", rpmdb.dbPath().asString(),
+			  "-e", "gpg-pubkey-"+key.asString() }, ExternalProgram::Stderr_To_Stdout );
+  for ( std::string line = prog.receiveLine(); ! line.empty(); line = prog.receiveLine() )
+    cout << line;
+  BOOST_REQUIRE_EQUAL( prog.close(), 0 );
+
+  BOOST_CHECK( rpmKey( "3dbdc284" ) == Edition::noedition );
+  BOOST_CHECK_EQUAL( gcheckPackageSignature( rpm ).result, RpmDb::CHK_NOKEY );
+
+  rpmdb.importPubkey( PublicKey( DATADIR/"signed.key" ) );
+  BOOST_CHECK_EQUAL( gcheckPackageSignature( rpm ).result, RpmDb::CHK_OK );
+}
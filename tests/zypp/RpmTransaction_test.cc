@@ -0,0 +1,82 @@
+#include "TestSetup.h"
+#include <unistd.h>
+
+#include <zypp/target/rpm/RpmDb.h>
+#include <zypp/target/rpm/RpmException.h>
+#include <thread>
+#include <future>
+using target::rpm::RpmDb;
+
+#define DATADIR (Pathname(TESTS_SRC_DIR) / "/zypp/data/RpmPkgSigCheck")
+
+static TestSetup test( TestSetup::initLater );
+struct TestInit {
+  TestInit() {
+    test = TestSetup( );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+typedef RpmDb::TransactionElement Element;
+
+///////////////////////////////////////////////////////////////////
+// RpmDb::commitTransaction in --test mode: nothing gets installed.
+// unsigned.rpm is pkg-test42-0-0.noarch
+///////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE(erase_not_installed)
+{
+  RpmDb & rpmdb( test.target().rpmDb() );
+  BOOST_REQUIRE( ! rpmdb.hasPackage( "pkg-test42" ) );
+
+  std::vector<Element> elements( 1 );
+  elements[0].kind = Element::ERASE;
+  elements[0].name = "pkg-test42-0-0.noarch";
+  rpmdb.commitTransaction( elements, target::rpm::RPMINST_TEST );
+  BOOST_CHECK_EQUAL( elements[0].state, Element::FAILED );
+}
+
+BOOST_AUTO_TEST_CASE(install_test_transaction)
+{
+  if ( ::geteuid() != 0 )
+  {
+    BOOST_TEST_MESSAGE( "skipped: rpm needs to chroot into the test root" );
+    return;
+  }
+
+  RpmDb & rpmdb( test.target().rpmDb() );
+  std::vector<Element> elements( 2 );
+  elements[0].kind = Element::INSTALL;
+  elements[0].file = DATADIR/"unsigned.rpm";
+  elements[1].kind = Element::INSTALL;
+  elements[1].file = DATADIR/"no.rpm";	// not an rpm
+
+  unsigned activated = 0;
+  rpmdb.commitTransaction( elements,
+			   target::rpm::RPMINST_TEST|target::rpm::RPMINST_NODEPS|target::rpm::RPMINST_FORCE|target::rpm::RPMINST_NOSIGNATURE,
+			   [&activated]( unsigned ) { ++activated; } );
+  BOOST_CHECK_EQUAL( elements[0].state, Element::DONE );
+  BOOST_CHECK_EQUAL( elements[1].state, Element::FAILED );
+  BOOST_CHECK_EQUAL( activated, 2 );
+  BOOST_CHECK( ! rpmdb.hasPackage( "pkg-test42" ) );	// --test
+}
+
+BOOST_AUTO_TEST_CASE(refused_with_other_threads)
+{
+  // rpm would chroot the whole process into the test root
+  RpmDb & rpmdb( test.target().rpmDb() );
+  BOOST_REQUIRE( rpmdb.root() != "/" );
+
+  std::vector<Element> elements( 1 );
+  elements[0].kind = Element::INSTALL;
+  elements[0].file = DATADIR/"unsigned.rpm";
+
+  // any thread, not just our own worker pools
+  std::promise<void> done;
+  std::thread other( [&done]() { done.get_future().wait(); } );
+  BOOST_CHECK_THROW( rpmdb.commitTransaction( elements, target::rpm::RPMINST_TEST ), target::rpm::RpmException );
+  BOOST_CHECK_EQUAL( elements[0].state, Element::PENDING );
+  done.set_value();
+  other.join();
+}
@@ -0,0 +1,81 @@
+// Boost.Test
+#include <boost/test/unit_test.hpp>
+
+#include <unistd.h>
+#include <fstream>
+#include <vector>
+#include <zstd.h>
+
+#include <zypp/base/ZstdStream.h>
+#include <zypp/Pathname.h>
+#include <zypp/base/InputStream.h>
+#include <zypp/PathInfo.h>
+
+namespace
+{
+  void writeZstd( const zypp::Pathname & file_r, const std::string & data_r )
+  {
+    std::vector<char> buf( ZSTD_compressBound( data_r.size() ) );
+    size_t size = ZSTD_compress( buf.data(), buf.size(), data_r.data(), data_r.size(), 3 );
+    BOOST_REQUIRE( !ZSTD_isError( size ) );
+    std::ofstream( file_r.c_str() ).write( buf.data(), size );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(zstd_simple_read)
+{
+  const zypp::Pathname file = zypp::Pathname(TESTS_BUILD_DIR) / "test.zst";
+  const std::string testString("HelloWorld");
+  writeZstd( file, testString );
+
+  BOOST_REQUIRE_EQUAL( zypp::filesystem::zipType( file ), zypp::filesystem::ZT_ZSTD  );
+
+  {
+    std::string test;
+    zypp::ifzstdstream str( file.c_str() );
+    BOOST_REQUIRE( str.is_open() );
+    BOOST_REQUIRE( str.getbuf().canRead() );
+    BOOST_REQUIRE( !str.getbuf().canWrite() );
+    str >> test;
+    BOOST_REQUIRE_EQUAL( test, testString );
+  }
+
+  {
+    zypp::InputStream iStr( file );
+    BOOST_REQUIRE( typeid( iStr.stream() ) == typeid( zypp::ifzstdstream& ) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(zstd_bulk_read)
+{
+  const zypp::Pathname file = zypp::Pathname(TESTS_BUILD_DIR) / "testbulk.zst";
+  std::string testString;
+  for ( unsigned i = 0; i < 100000; ++i )
+    testString += std::to_string( i ) + ( i % 7 ? " " : "\n" );
+  writeZstd( file, testString );
+
+  std::string test;
+  std::vector<char> buf( 20000 );
+  const std::streamsize sizes[] { 10, 20000, 1, 3000, 1023, 1024, 9999 };
+  zypp::ifzstdstream str( file.c_str() );
+  for ( unsigned i = 0; str.good(); ++i )
+  {
+    str.read( buf.data(), sizes[i % 7] );
+    test.append( buf.data(), str.gcount() );
+  }
+  BOOST_REQUIRE_EQUAL( test.size(), testString.size() );
+  BOOST_REQUIRE( test == testString );
+}
+
+BOOST_AUTO_TEST_CASE(zstd_truncated)
+{
+  const zypp::Pathname file = zypp::Pathname(TESTS_BUILD_DIR) / "testtrunc.zst";
+  writeZstd( file, std::string( 100000, 'x' ) );
+  ::truncate( file.c_str(), zypp::PathInfo( file ).size() - 4 );
+
+  std::vector<char> buf( 200000 );
+  zypp::ifzstdstream str( file.c_str() );
+  str.read( buf.data(), buf.size() );
+  BOOST_CHECK( str.fail() );
+  BOOST_CHECK( !str.zError().empty() );
+}
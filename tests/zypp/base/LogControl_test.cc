@@ -0,0 +1,108 @@
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/LogControl.h>
+#include <zypp/base/String.h>
+
+using namespace zypp;
+using zypp::base::LogControl;
+
+namespace
+{
+  /** Collect the formated lines. */
+  struct CollectingWriter : public log::LineWriter
+  {
+    virtual void writeOut( const std::string & formated_r )
+    {
+      std::lock_guard<std::mutex> guard( _mutex );
+      _lines.push_back( formated_r );
+    }
+    std::mutex _mutex;
+    std::vector<std::string> _lines;
+  };
+}
+
+BOOST_AUTO_TEST_CASE(logcontrol_async)
+{
+  shared_ptr<CollectingWriter> writer( new CollectingWriter );
+  LogControl::TmpLineWriter tmp( writer );
+  LogControl::instance().setAsync( true );
+
+  static const unsigned nthreads = 4;
+  static const unsigned nlines = 5000;	// more than a ring buffer holds
+  std::vector<std::thread> threads;
+  for ( unsigned t = 0; t < nthreads; ++t )
+    threads.push_back( std::thread( [t]() {
+      for ( unsigned i = 0; i < nlines; ++i )
+        WAR << str::form( "%u:%u", t, i ) << std::endl;
+    } ) );
+  for ( unsigned i = 0; i < nlines; ++i )
+    ERR << str::form( "m:%u", i ) << std::endl;
+  for ( std::thread & thread : threads )
+    thread.join();
+
+  LogControl::instance().setAsync( false );
+  WAR << "sync" << std::endl;
+
+  // Warnings are never dropped and each threads lines keep their order.
+  BOOST_REQUIRE_EQUAL( writer->_lines.size(), (nthreads+1)*nlines + 1 );
+  std::vector<unsigned> next( nthreads+1, 0 );
+  for ( unsigned l = 0; l < writer->_lines.size() - 1; ++l )
+  {
+    const std::string & line( writer->_lines[l].substr( writer->_lines[l].rfind( ' ' ) + 1 ) );
+    std::string::size_type sep = line.find( ':' );
+    unsigned t = ( line[0] == 'm' ? nthreads : str::strtonum<unsigned>( line.substr( 0, sep ) ) );
+    BOOST_CHECK_EQUAL( str::strtonum<unsigned>( line.substr( sep+1 ) ), next[t]++ );
+  }
+  BOOST_CHECK( str::endsWith( writer->_lines.back(), " sync" ) );
+}
+
+BOOST_AUTO_TEST_CASE(logcontrol_group_buffer_reused)
+{
+  shared_ptr<CollectingWriter> writer( new CollectingWriter );
+  LogControl::TmpLineWriter tmp( writer );
+
+  // the group name is taken from the buffer, not from its address
+  char group[] = "groupA";
+  L_WAR( group ) << "a" << std::endl;
+  group[5] = 'B';
+  L_WAR( group ) << "b" << std::endl;
+  BOOST_REQUIRE_EQUAL( writer->_lines.size(), 2 );
+  BOOST_CHECK( writer->_lines[0].find( "[groupA]" ) != std::string::npos );
+  BOOST_CHECK( writer->_lines[1].find( "[groupB]" ) != std::string::npos );
+}
+
+BOOST_AUTO_TEST_CASE(logcontrol_async_switch_off_while_logging)
+{
+  shared_ptr<CollectingWriter> writer( new CollectingWriter );
+  LogControl::TmpLineWriter tmp( writer );
+  LogControl::instance().setAsync( true );
+
+  // Lines queued while the writer stops must not get lost.
+  static const unsigned nthreads = 4;
+  static const unsigned nlines = 2000;
+  std::vector<std::thread> threads;
+  for ( unsigned t = 0; t < nthreads; ++t )
+    threads.push_back( std::thread( [t]() {
+      for ( unsigned i = 0; i < nlines; ++i )
+        WAR << str::form( "%u:%u", t, i ) << std::endl;
+    } ) );
+  LogControl::instance().setAsync( false );
+  for ( std::thread & thread : threads )
+    thread.join();
+
+  BOOST_REQUIRE_EQUAL( writer->_lines.size(), nthreads*nlines );
+  std::vector<unsigned> next( nthreads, 0 );
+  for ( const std::string & formated : writer->_lines )
+  {
+    const std::string & line( formated.substr( formated.rfind( ' ' ) + 1 ) );
+    std::string::size_type sep = line.find( ':' );
+    unsigned t = str::strtonum<unsigned>( line.substr( 0, sep ) );
+    BOOST_CHECK_EQUAL( str::strtonum<unsigned>( line.substr( sep+1 ) ), next[t]++ );
+  }
+}
@@ -0,0 +1,46 @@
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/base/WorkerPool_p.h>
+
+using zypp::WorkerPool;
+using zypp::parallelFor;
+
+BOOST_AUTO_TEST_CASE( submit )
+{
+  WorkerPool pool( 3 );
+  BOOST_CHECK_EQUAL( pool.size(), 3 );
+
+  std::vector<std::future<int>> results;
+  for ( int i = 0; i < 100; ++i )
+    results.push_back( pool.submit( [i]() { return i * i; } ) );
+  for ( int i = 0; i < 100; ++i )
+    BOOST_CHECK_EQUAL( results[i].get(), i * i );
+}
+
+BOOST_AUTO_TEST_CASE( exceptions )
+{
+  WorkerPool pool( 2 );
+  auto good = pool.submit( []() { return 42; } );
+  auto bad  = pool.submit( []() -> int { throw std::runtime_error( "bad" ); } );
+  BOOST_CHECK_EQUAL( good.get(), 42 );
+  BOOST_CHECK_THROW( bad.get(), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( parallel_for )
+{
+  std::atomic<unsigned> sum( 0 );
+  parallelFor( 1000, [&sum]( size_t i ) { sum += i; }, 4 );
+  BOOST_CHECK_EQUAL( sum, 499500U );
+
+  // sequential fallback
+  std::vector<size_t> order;
+  parallelFor( 3, [&order]( size_t i ) { order.push_back( i ); }, 1 );
+  BOOST_CHECK_EQUAL( order.size(), 3 );
+  BOOST_CHECK_EQUAL( order[2], 2U );
+
+  BOOST_CHECK_THROW( parallelFor( 10, []( size_t i ) { if ( i == 5 ) throw std::runtime_error( "5" ); }, 4 ), std::runtime_error );
+}
@@ -4,6 +4,7 @@
 #include <zypp/zyppng/media/network/request.h>
 #include <zypp/zyppng/media/network/networkrequestdispatcher.h>
 #include <zypp/zyppng/media/network/networkrequesterror.h>
+#include <zypp/zyppng/media/network/private/networkrequestdispatcher_p.h>
 #include <zypp/TmpPath.h>
 #include <zypp/base/String.h>
 #include <zypp/Digest.h>
@@ -331,3 +332,61 @@ BOOST_DATA_TEST_CASE(nwdispatcher_delay_download, bdata::make( withSSL ), withSS
   BOOST_TEST_REQ_ERR( reqDLFile, zyppng::NetworkRequestError::Timeout );
 }
 
+
+namespace {
+  /** Access to the dispatchers internals, the test WebServer does not speak HTTP/2. */
+  struct MultiplexTestDispatcher : public zyppng::NetworkRequestDispatcher
+  {
+    zyppng::NetworkRequestDispatcherPrivate & priv()
+    { return *static_cast<zyppng::NetworkRequestDispatcherPrivate *>( d_ptr.get() ); }
+  };
+}
+
+BOOST_AUTO_TEST_CASE(nwdispatcher_multiplexing_host)
+{
+  auto ev = zyppng::EventDispatcher::createMain();
+  WebServer web((zypp::Pathname(TESTS_SRC_DIR)/"data"/"dummywebroot").c_str(), 10001, false );
+  web.addRequestHandler("getData", WebServer::makeResponse("200 OK", "Hello" ) );
+  BOOST_REQUIRE( web.start() );
+
+  zyppng::Url weburl (web.url());
+  weburl.setPathName("/handler/getData");
+
+  // returns the max. number of concurrently running requests
+  auto runRequests = [&]( bool markHost ) {
+    MultiplexTestDispatcher disp;
+    disp.setMaximumConcurrentConnections( 1 );
+    disp.setMaximumConcurrentStreams( 4 );
+    if ( markHost )
+      disp.priv()._multiplexingHosts.insert( zyppng::NetworkRequestDispatcherPrivate::hostKey( weburl ) );
+
+    size_t running = 0;
+    size_t maxRunning = 0;
+    disp.sigDownloadStarted().connect( [&]( zyppng::NetworkRequestDispatcher &, zyppng::NetworkRequest & ){
+      maxRunning = std::max( maxRunning, ++running );
+    });
+    disp.sigDownloadFinished().connect( [&]( zyppng::NetworkRequestDispatcher &, zyppng::NetworkRequest & ){
+      --running;
+    });
+    disp.sigQueueFinished().connect( [&ev]( const zyppng::NetworkRequestDispatcher& ){
+      ev->quit();
+    });
+
+    std::vector<zypp::filesystem::TmpFile> targets( 6 );
+    std::vector<zyppng::NetworkRequest::Ptr> reqs;
+    for ( const auto & target : targets ) {
+      reqs.push_back( std::make_shared<zyppng::NetworkRequest>( weburl, target.path() ) );
+      reqs.back()->transferSettings() = web.transferSettings();
+      disp.enqueue( reqs.back() );
+    }
+    disp.run();
+    ev->run();
+
+    for ( const auto & req : reqs )
+      BOOST_TEST_REQ_SUCCESS( req );
+    return maxRunning;
+  };
+
+  BOOST_CHECK_EQUAL( runRequests( false ), 1 );
+  BOOST_CHECK_EQUAL( runRequests( true ), 4 );
+}
@@ -21,6 +21,7 @@
 
 #include <iostream>
 #include <sstream>
+#include <mutex>
 
 #ifdef DIGEST_TESTSUITE
 #include <fstream>
@@ -79,7 +80,7 @@ namespace zypp {
         unsigned md_len;
 
         bool finalized : 1;
-        static bool openssl_digests_added;
+        static std::once_flag openssl_digests_added;
 
         std::string name;
 
@@ -89,7 +90,7 @@ namespace zypp {
 
 
 
-    bool Digest::P::openssl_digests_added = false;
+    std::once_flag Digest::P::openssl_digests_added;
 
     Digest::P::P() :
       md(NULL),
@@ -104,14 +105,13 @@ namespace zypp {
 
     bool Digest::P::maybeInit()
     {
-      if(!openssl_digests_added)
-      {
+      // Digests may be computed on worker threads.
+      std::call_once( openssl_digests_added, []() {
         OPENSSL_config(NULL);
         ENGINE_load_builtin_engines();
         ENGINE_register_all_complete();
         OpenSSL_add_all_digests();
-        openssl_digests_added = true;
-      }
+      } );
 
       if(!mdctx)
       {
@@ -21,9 +21,18 @@
 #include <zypp/base/DefaultIntegral.h>
 #include <zypp/base/String.h>
 #include <zypp/Fetcher.h>
+#include <zypp/ZConfig.h>
 #include <zypp/ZYppFactory.h>
 #include <zypp/CheckSum.h>
+#include <zypp/TmpPath.h>
 #include <zypp/base/UserRequestException.h>
+#include <zypp/media/CurlHelper.h>
+#include <zypp/media/CredentialManager.h>
+#include <zypp/media/MediaException.h>
+#include <zypp/ZYppCallbacks.h>
+#include <zypp/zyppng/base/EventDispatcher>
+#include <zypp/zyppng/media/network/downloader.h>
+#include <zypp/zyppng/media/network/networkrequestdispatcher.h>
 #include <zypp/parser/susetags/ContentFileReader.h>
 #include <zypp/parser/susetags/RepoIndex.h>
 
@@ -213,6 +222,13 @@ namespace zypp
        */
       void provideToDest( MediaSetAccess & media_r, const Pathname & destDir_r , const FetcherJob_Ptr & jobp_r );
 
+      /**
+       * Download the plain files with a known checksum concurrently
+       * into a staging directory, where \ref locateInCache finds them.
+       * Anything failing here is left to \ref provideToDest.
+       */
+      filesystem::TmpPath prefetch( MediaSetAccess & media_r, const Pathname & destDir_r );
+
   private:
     friend Impl * rwcowClone<Impl>( const Impl * rhs );
     /** clone for RWCOW_pointer */
@@ -226,6 +242,8 @@ namespace zypp
     std::map<std::string, CheckSum> _checksums;
     // cache of dir contents
     std::map<std::string, filesystem::DirContent> _dircontent;
+    // files prefetched by start
+    filesystem::TmpPath _staging;
 
     Fetcher::Options _options;
   };
@@ -356,6 +374,162 @@ namespace zypp
       }
     }
 
+    if ( _staging )
+    {
+      cacheLocation = _staging.path() / resource_r.filename();
+      if ( PathInfo(cacheLocation).isExist() && is_checksum( cacheLocation, resource_r.checksum() ) )
+      {
+	DBG << "file " << resource_r.filename() << " was prefetched" << endl;
+	swap( ret, cacheLocation );
+	return ret;
+      }
+    }
+
+    return ret;
+  }
+
+  filesystem::TmpPath Fetcher::Impl::prefetch( MediaSetAccess & media_r, const Pathname & destDir_r )
+  {
+    filesystem::TmpPath ret;
+    const long parallel = ZConfig::instance().download_max_concurrent_connections();
+    const Url & baseurl( media_r.url() );
+    if ( ! ZConfig::instance().download_prefetch_files() || parallel < 2 || ! baseurl.schemeIsDownloading() )
+      return ret;
+
+    std::vector<FetcherJob_Ptr> jobs;
+    for ( const FetcherJob_Ptr & jobp : _resources )
+    {
+      const OnMediaLocation & loc( jobp->location );
+      if ( ( jobp->flags & FetcherJob::Directory ) || ! jobp->deltafile.empty() || loc.medianr() != 1 || loc.checksum().empty() )
+	continue;	// left to the regular download
+      if ( locateInCache( loc, destDir_r ).empty() )
+	jobs.push_back( jobp );
+    }
+    if ( jobs.size() < 2 )
+      return ret;	// nothing to gain
+
+    media::TransferSettings settings;
+    try
+    {
+      internal::fillSettingsFromUrl( baseurl, settings );
+      if ( settings.proxy().empty() )
+	internal::fillSettingsSystemProxy( baseurl, settings );
+    }
+    catch ( const media::MediaException & excpt )
+    {
+      ZYPP_CAUGHT( excpt );
+      return ret;
+    }
+    if ( settings.userPassword().empty() )
+    {
+      media::CredentialManager cm( media::CredManagerOptions( ZConfig::instance().repoManagerRoot() ) );
+      media::AuthData_Ptr cred( cm.getCred( baseurl ) );
+      if ( cred && cred->valid() )
+      {
+	settings.setUsername( cred->username() );
+	settings.setPassword( cred->password() );
+      }
+    }
+
+    if ( filesystem::assert_dir( destDir_r.dirname() ) == 0 )
+      ret = filesystem::TmpDir( destDir_r.dirname(), ".prefetch." );	// hardlinks into destDir_r
+    if ( ! ret )
+      return ret;
+    MIL << "Prefetching " << jobs.size() << " files into " << ret.path() << endl;
+
+    std::shared_ptr<zyppng::EventDispatcher> ev( zyppng::EventDispatcher::instance() );
+    if ( ! ev )
+      ev = zyppng::EventDispatcher::createMain();
+
+    zyppng::Downloader downloader;
+    downloader.requestDispatcher()->setMaximumConcurrentConnections( parallel );
+
+    // All files are reported as one download of the baseurl; the
+    // receiver may abort it like any other download.
+    callback::SendReport<media::DownloadProgressReport> report;
+    report->start( baseurl, ret.path() );
+
+    off_t expected = 0;
+    for ( const FetcherJob_Ptr & jobp : jobs )
+      expected += jobp->location.downloadSize();
+    std::vector<off_t> received( jobs.size(), 0 );
+    off_t receivedSum = 0;
+    unsigned finished = 0;
+    int percent = -1;
+    bool aborted = false;
+
+    std::vector<zyppng::Download::Ptr> downloads;
+    std::vector<sigc::connection> connections;
+    downloads.reserve( jobs.size() );
+    size_t running = 0;
+    unsigned fetched = 0;
+
+    auto sendProgress = [&]() {
+      int val = expected ? std::min( off_t(100), receivedSum * 100 / expected ) : finished * 100 / jobs.size();
+      if ( val != percent )
+      {
+	percent = val;
+	if ( ! report->progress( percent, baseurl ) )
+	{
+	  aborted = true;
+	  ev->quit();
+	}
+      }
+    };
+
+    for ( unsigned idx = 0; idx < jobs.size(); ++idx )
+    {
+      const OnMediaLocation & loc( jobs[idx]->location );
+      const Pathname target( ret.path() / loc.filename() );
+      if ( filesystem::assert_dir( target.dirname() ) != 0 )
+	continue;
+
+      Url url( internal::clearQueryString( baseurl ) );
+      url.appendPathName( loc.filename() );
+      zyppng::Download::Ptr dl( downloader.downloadFile( url, target, loc.downloadSize() ) );
+      dl->settings() = settings;
+      auto alive = [&,idx]( zyppng::Download &, off_t dlnow_r ) {
+	receivedSum += dlnow_r - received[idx];
+	received[idx] = dlnow_r;
+	sendProgress();
+      };
+      connections.push_back( dl->sigAlive().connect( alive ) );
+      connections.push_back( dl->sigProgress().connect( [alive]( zyppng::Download & dl_r, off_t, off_t dlnow_r ) {
+	alive( dl_r, dlnow_r );
+      } ) );
+      connections.push_back( dl->sigFinished().connect( [&]( zyppng::Download & dl_r ) {
+	if ( dl_r.state() == zyppng::Download::Success )
+	  ++fetched;
+	else
+	  DBG << "Prefetching " << dl_r.url() << " failed: " << dl_r.errorString() << endl;
+	++finished;
+	if ( --running == 0 )
+	  ev->quit();
+	else
+	  sendProgress();
+      } ) );
+      ++running;
+      dl->start();
+      downloads.push_back( std::move(dl) );
+    }
+    if ( running )
+      ev->run();
+
+    // pending downloads are dropped with the Downloader, but must
+    // not call back into this scope.
+    for ( sigc::connection & conn : connections )
+      conn.disconnect();
+    downloads.clear();
+
+    if ( aborted )
+    {
+      WAR << "Prefetching aborted by the user" << endl;
+      report->finish( baseurl, media::DownloadProgressReport::ERROR, "User abort" );
+      ZYPP_THROW( AbortRequestException( "User abort" ) );
+    }
+    report->finish( baseurl, media::DownloadProgressReport::NO_ERROR, "" );
+
+    MIL << "Prefetched " << fetched << " of " << jobs.size() << " files" << endl;
     return ret;
   }
 
@@ -722,6 +896,9 @@ namespace zypp
 
     downloadAndReadIndexList(media, dest_dir);
 
+    // the prefetched files are taken from the staging dir by locateInCache
+    _staging = prefetch( media, dest_dir );
+
     for ( const FetcherJob_Ptr & jobp : _resources )
     {
       if ( jobp->flags & FetcherJob::Directory )
@@ -799,6 +976,7 @@ namespace zypp
       if ( ! progress.incr() )
         ZYPP_THROW(AbortRequestException());
     } // for each job
+    _staging = filesystem::TmpPath();
   }
 
   /** \relates Fetcher::Impl Stream output */
@@ -15,6 +15,7 @@
 #include <zypp/ZYppFactory.h>
 #include <zypp/Digest.h>
 #include <zypp/KeyRing.h>
+#include <zypp/repo/VerifiedFileIndex_p.h>
 
 using std::endl;
 
@@ -79,6 +80,7 @@ namespace zypp
           ZYPP_THROW( ExceptionType( file.basename() + " has wrong checksum" ) );
         }
       }
+      repo::VerifiedFileIndex::remember( file, _checksum );
     }
   }
 
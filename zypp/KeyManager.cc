@@ -380,6 +380,15 @@ bool KeyManagerCtx::verify(const Pathname &file, const Pathname &signature)
   return _pimpl->verifySignaturesFprs(file, signature);
 }
 
+std::vector<bool> KeyManagerCtx::verify(const std::vector<std::pair<Pathname,Pathname>> &files_r)
+{
+  std::vector<bool> ret;
+  ret.reserve( files_r.size() );
+  for ( const auto & file : files_r )
+    ret.push_back( _pimpl->verifySignaturesFprs( file.first, file.second ) );
+  return ret;
+}
+
 bool KeyManagerCtx::exportKey(const std::string &id, std::ostream &stream)
 {
   GpgmeErr err = GPG_ERR_NO_ERROR;
@@ -17,6 +17,8 @@
 #include <zypp/PublicKey.h>
 
 #include <memory>
+#include <vector>
+#include <utility>
 
 namespace zypp
 {
@@ -64,6 +66,11 @@ class KeyManagerCtx
         /** Tries to verify \a file using \a signature, returns true on success */
         bool verify(const Pathname & file, const Pathname & signature);
 
+        /** Tries to verify each (file, signature) pair in \a files_r using this context.
+         * Returns the results in the order of \a files_r.
+         */
+        std::vector<bool> verify(const std::vector<std::pair<Pathname,Pathname>> & files_r);
+
         /** Exports the key with \a id into the given \a stream, returns true on success */
         bool exportKey(const std::string & id, std::ostream & stream);
 
@@ -32,6 +32,7 @@
 #include <zypp/TmpPath.h>
 #include <zypp/ZYppCallbacks.h>       // JobReport::instance
 #include <zypp/KeyManager.h>
+#include <zypp/base/WorkerPool_p.h>
 
 using std::endl;
 
@@ -118,12 +119,24 @@ namespace zypp
     /// \code
     ///   const std::list<PublicKeyData> & cachedPublicKeyData( const Pathname & keyring );
     /// \endcode
+    /// Also provides a \ref KeyManagerCtx per keyring, which is reused
+    /// as long as the keyring does not change. Creating a context and
+    /// setting up the gpg engine for each query is expensive.
     ///////////////////////////////////////////////////////////////////
     struct CachedPublicKeyData : private base::NonCopyable
     {
       const std::list<PublicKeyData> & operator()( const Pathname & keyring_r ) const
       { return getData( keyring_r ); }
 
+      /** The pooled \ref KeyManagerCtx for \a keyring_r (for read-only operations). */
+      KeyManagerCtx & context( const Pathname & keyring_r ) const
+      {
+	Cache & cache( _cacheMap[keyring_r] );
+	cache.assertCache( keyring_r );
+	getData( keyring_r, cache );	// drops an outdated context
+	return getContext( keyring_r, cache );
+      }
+
       void setDirty( const Pathname & keyring_r )
       { _cacheMap[keyring_r].setDirty(); }
 
@@ -170,6 +183,7 @@ namespace zypp
 	{
 	  _keyringK.reset();
 	  _keyringP.reset();
+	  _context.reset();
 	}
 
 	void assertCache( const Pathname & keyring_r )
@@ -189,6 +203,7 @@ namespace zypp
 	}
 
 	std::list<PublicKeyData> _data;
+	std::optional<KeyManagerCtx> _context;
 
       private:
 
@@ -209,12 +224,20 @@ namespace zypp
       const std::list<PublicKeyData> & getData( const Pathname & keyring_r, Cache & cache_r ) const
       {
         if ( cache_r.hasChanged() ) {
-	  cache_r._data = KeyManagerCtx::createForOpenPGP( keyring_r ).listKeys();
+	  cache_r._context.reset();
+	  cache_r._data = getContext( keyring_r, cache_r ).listKeys();
 	  MIL << "Found keys: " << cache_r._data  << endl;
         }
         return cache_r._data;
       }
 
+      KeyManagerCtx & getContext( const Pathname & keyring_r, Cache & cache_r ) const
+      {
+	if ( not cache_r._context )
+	  cache_r._context = KeyManagerCtx::createForOpenPGP( keyring_r );
+	return cache_r._context.value();
+      }
+
       mutable CacheMap _cacheMap;
     };
     ///////////////////////////////////////////////////////////////////
@@ -279,6 +302,9 @@ namespace zypp
     bool verifyFileTrustedSignature( const Pathname & file, const Pathname & signature )
     { return verifyFile( file, signature, trustedKeyRing() ); }
 
+    std::vector<bool> verifyFileSignatures( const std::vector<std::pair<Pathname,Pathname>> & files_r, bool trusted_r, unsigned threads_r )
+    { return verifyFiles( files_r, ( trusted_r ? trustedKeyRing() : generalKeyRing() ), threads_r ); }
+
     PublicKeyData publicKeyExists( const std::string & id )
     { return publicKeyExists(id, generalKeyRing());}
     PublicKeyData trustedPublicKeyExists( const std::string & id )
@@ -295,6 +321,7 @@ namespace zypp
     { return cachedPublicKeyData.manip( keyring ); }
 
     bool verifyFile( const Pathname & file, const Pathname & signature, const Pathname & keyring );
+    std::vector<bool> verifyFiles( const std::vector<std::pair<Pathname,Pathname>> & files_r, const Pathname & keyring, unsigned threads_r );
     void importKey( const Pathname & keyfile, const Pathname & keyring );
 
     PublicKey exportKey( const std::string & id, const Pathname & keyring );
@@ -316,6 +343,14 @@ namespace zypp
     /** Load key files cached on the system into the generalKeyRing. */
     void preloadCachedKeys();
 
+    /** Context without keyring, e.g. to read signature fingerprints (created on demand). */
+    KeyManagerCtx & volatileContext()
+    {
+      if ( not _volatileContext )
+	_volatileContext = KeyManagerCtx::createForOpenPGP();
+      return _volatileContext.value();
+    }
+
     const Pathname generalKeyRing() const
     { return _general_tmp_dir.path(); }
     const Pathname trustedKeyRing() const
@@ -326,6 +361,7 @@ namespace zypp
     filesystem::TmpDir _general_tmp_dir;
     Pathname _base_dir;
     bool _allowPreload = false;	//< General keyring may be preloaded with keys cached on the system.
+    std::optional<KeyManagerCtx> _volatileContext;
 
   private:
     /** Functor returning the keyrings data (cached).
@@ -512,7 +548,7 @@ namespace zypp
 
   void KeyRing::Impl::dumpPublicKey( const std::string & id, const Pathname & keyring, std::ostream & stream )
   {
-    KeyManagerCtx::createForOpenPGP( keyring ).exportKey(id, stream);
+    cachedPublicKeyData.context( keyring ).exportKey(id, stream);
   }
 
   filesystem::TmpFile KeyRing::Impl::dumpPublicKeyToTmp( const std::string & id, const Pathname & keyring )
@@ -773,7 +809,7 @@ namespace zypp
 
     MIL << "Determining key id of signature " << signature << endl;
 
-    std::list<std::string> fprs = KeyManagerCtx::createForOpenPGP().readSignatureFingerprints( signature );
+    std::list<std::string> fprs = volatileContext().readSignatureFingerprints( signature );
     if ( ! fprs.empty() ) {
       std::string &id = fprs.back();
       MIL << "Determined key id [" << id << "] for signature " << signature << endl;
@@ -784,7 +820,34 @@ namespace zypp
 
   bool KeyRing::Impl::verifyFile( const Pathname & file, const Pathname & signature, const Pathname & keyring )
   {
-    return KeyManagerCtx::createForOpenPGP( keyring ).verify( file, signature );
+    return cachedPublicKeyData.context( keyring ).verify( file, signature );
+  }
+
+  std::vector<bool> KeyRing::Impl::verifyFiles( const std::vector<std::pair<Pathname,Pathname>> & files_r, const Pathname & keyring, unsigned threads_r )
+  {
+    if ( ! threads_r )
+      threads_r = WorkerPool::defaultSize();
+    if ( threads_r > files_r.size() )
+      threads_r = files_r.size();
+    if ( threads_r < 2 )
+      return cachedPublicKeyData.context( keyring ).verify( files_r );
+
+    // A gpgme context must not be shared between threads, so each chunk gets its own.
+    MIL << "Verifying " << files_r.size() << " signatures using " << threads_r << " threads" << endl;
+    const size_t chunkSize = ( files_r.size() + threads_r - 1 ) / threads_r;
+    std::vector<std::vector<bool>> results( threads_r );
+    parallelFor( threads_r, [&]( size_t idx_r ) {
+      auto begin = files_r.begin() + std::min( files_r.size(), idx_r * chunkSize );
+      auto end   = files_r.begin() + std::min( files_r.size(), (idx_r+1) * chunkSize );
+      if ( begin != end )
+	results[idx_r] = KeyManagerCtx::createForOpenPGP( keyring ).verify( std::vector<std::pair<Pathname,Pathname>>( begin, end ) );
+    }, threads_r );
+
+    std::vector<bool> ret;
+    ret.reserve( files_r.size() );
+    for ( const auto & result : results )
+      ret.insert( ret.end(), result.begin(), result.end() );
+    return ret;
   }
 
   ///////////////////////////////////////////////////////////////////
@@ -865,6 +928,9 @@ namespace zypp
   bool KeyRing::verifyFileTrustedSignature( const Pathname & file, const Pathname & signature )
   { return _pimpl->verifyFileTrustedSignature( file, signature ); }
 
+  std::vector<bool> KeyRing::verifyFileSignatures( const std::vector<std::pair<Pathname,Pathname>> & files_r, bool trusted_r, unsigned threads_r )
+  { return _pimpl->verifyFileSignatures( files_r, trusted_r, threads_r ); }
+
   bool KeyRing::provideAndImportKeyFromRepositoryWorkflow(const std::string &id, const RepoInfo &info)
   {
     return _pimpl->provideAndImportKeyFromRepositoryWorkflow( id, info );
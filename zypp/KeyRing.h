@@ -17,6 +17,8 @@
 #include <list>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <zypp/base/ReferenceCounted.h>
 #include <zypp/base/Flags.h>
@@ -348,6 +350,19 @@ namespace zypp
 
     bool verifyFileTrustedSignature( const Pathname &file, const Pathname &signature );
 
+    /**
+     * Verifies many files against their signatures, with no user interaction
+     *
+     * Like \ref verifyFileSignature (or \ref verifyFileTrustedSignature if
+     * \a trusted_r is set), but the gpg context is set up just once per thread.
+     * The files are split among up to \a threads_r threads (\c 0 chooses the
+     * number of CPUs).
+     *
+     * \param files_r (file, signature) pairs to verify
+     * \return the results in the order of \a files_r
+     */
+    std::vector<bool> verifyFileSignatures( const std::vector<std::pair<Pathname,Pathname>> & files_r, bool trusted_r = false, unsigned threads_r = 1 );
+
     /**
      * Try to find the \a id in key cache or repository specified in \a info. Ask the user to trust
      * the key if it was found
@@ -111,6 +111,12 @@ namespace zypp
       void setLabel( const std::string & label_r )
       { _label = label_r; }
 
+      /**
+       * The \ref Url of media #1, as passed to the ctor.
+       */
+      const Url & url() const
+      { return _url; }
+
       enum ProvideFileOption
       {
         /**
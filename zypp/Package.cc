@@ -17,6 +17,7 @@
 #include <zypp/Package.h>
 #include <zypp/sat/LookupAttr.h>
 #include <zypp/ZYppFactory.h>
+#include <zypp/repo/VerifiedFileIndex_p.h>
 #include <zypp/target/rpm/RpmDb.h>
 #include <zypp/target/rpm/RpmHeader.h>
 
@@ -53,7 +54,7 @@ namespace zyppintern
     }
     else
     {
-      if ( loc_r.checksum() != CheckSum( loc_r.checksum().type(), std::ifstream( pi.c_str() ) ) )
+      if ( ! repo::VerifiedFileIndex::check( repo_r.packagesPath(), pi.path(), loc_r.checksum() ) )
 	return Pathname();	// same name but wrong checksum
     }
 
@@ -17,6 +17,8 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <mutex>
+#include <unordered_map>
 
 #include <zypp/base/LogTools.h>
 #include <zypp/base/String.h>
@@ -29,6 +31,7 @@
 #include <zypp/PathInfo.h>
 #include <zypp/Digest.h>
 #include <zypp/TmpPath.h>
+#include <zypp/base/WorkerPool_p.h>
 
 using std::endl;
 using std::string;
@@ -1010,16 +1013,121 @@ namespace zypp
     //  METHOD NAME : checksum
     //  METHOD TYPE : std::string
     //
+    namespace
+    {
+      ///////////////////////////////////////////////////////////////////
+      /// \class ChecksumCache
+      /// \brief Checksums of files not modified since they were computed.
+      ///
+      /// A file is identified by device, inode, size, mtime and ctime. As the
+      /// timestamps are coarse, files modified within the last seconds are not
+      /// remembered (a same sized rewrite might not change them).
+      ///////////////////////////////////////////////////////////////////
+      class ChecksumCache
+      {
+      public:
+        static ChecksumCache & instance()
+        { static ChecksumCache _instance; return _instance; }
+
+        std::string get( const Pathname & file_r, const struct stat & st_r, const std::string & algorithm_r )
+        {
+          std::lock_guard<std::mutex> lock( _mutex );
+          auto it = _files.find( file_r.asString() );
+          if ( it == _files.end() || it->second._id != Id( st_r ) )
+            return std::string();
+          auto sum = it->second._sums.find( algorithm_r );
+          return( sum == it->second._sums.end() ? std::string() : sum->second );
+        }
+
+        void set( const Pathname & file_r, const struct stat & st_r, const std::string & algorithm_r, const std::string & sum_r )
+        {
+          if ( sum_r.empty() || std::max( st_r.st_mtime, st_r.st_ctime ) + 2 > ::time( nullptr ) )
+            return;	// recently modified
+          std::lock_guard<std::mutex> lock( _mutex );
+          if ( _files.size() >= _maxFiles )
+            _files.clear();
+          Entry & entry( _files[file_r.asString()] );
+          if ( entry._id != Id( st_r ) )
+          {
+            entry._id = Id( st_r );
+            entry._sums.clear();
+          }
+          entry._sums[algorithm_r] = sum_r;
+        }
+
+      private:
+        struct Id
+        {
+          Id()
+          {}
+          Id( const struct stat & st_r )
+          : _dev( st_r.st_dev ), _ino( st_r.st_ino ), _size( st_r.st_size )
+          , _mtime( st_r.st_mtim.tv_sec * 1000000000LL + st_r.st_mtim.tv_nsec )
+          , _ctime( st_r.st_ctim.tv_sec * 1000000000LL + st_r.st_ctim.tv_nsec )
+          {}
+          bool operator!=( const Id & rhs ) const
+          { return _dev != rhs._dev || _ino != rhs._ino || _size != rhs._size || _mtime != rhs._mtime || _ctime != rhs._ctime; }
+
+          dev_t _dev = 0;
+          ino_t _ino = 0;
+          off_t _size = 0;
+          long long _mtime = 0;
+          long long _ctime = 0;
+        };
+
+        struct Entry
+        {
+          Id _id;
+          std::map<std::string,std::string> _sums;	// algorithm : checksum
+        };
+
+        static constexpr size_t _maxFiles = 16384;
+        std::unordered_map<std::string,Entry> _files;
+        std::mutex _mutex;
+      };
+
+      /** Digest the file content read in large blocks. */
+      std::string fileDigest( int fd_r, const std::string & algorithm_r )
+      {
+        Digest digest;
+        if ( ! digest.create( algorithm_r ) )
+          return std::string();
+
+        ::posix_fadvise( fd_r, 0, 0, POSIX_FADV_SEQUENTIAL );
+        std::vector<char> buf( 256 * 1024 );
+        for ( ;; )
+        {
+          ssize_t got = ::read( fd_r, buf.data(), buf.size() );
+          if ( got < 0 )
+          {
+            if ( errno == EINTR )
+              continue;
+            return std::string();
+          }
+          if ( got == 0 )
+            break;
+          if ( ! digest.update( buf.data(), got ) )
+            return std::string();
+        }
+        return digest.digest();
+      }
+    } // namespace
+
     std::string checksum( const Pathname & file, const std::string &algorithm )
     {
-      if ( ! PathInfo( file ).isFile() ) {
+      AutoFD fd( ::open( file.c_str(), O_RDONLY|O_CLOEXEC ) );
+      struct stat st;
+      if ( fd == -1 || ::fstat( fd, &st ) != 0 || ! S_ISREG( st.st_mode ) ) {
         return string();
       }
-      std::ifstream istr( file.asString().c_str() );
-      if ( ! istr ) {
-        return string();
+      const std::string alg( str::toLower( algorithm ) );
+      std::string ret( ChecksumCache::instance().get( file, st, alg ) );
+      if ( ret.empty() )
+      {
+        ret = fileDigest( fd, alg );
+        ChecksumCache::instance().set( file, st, alg, ret );
       }
-      return Digest::digest( algorithm, istr );
+      return ret;
     }
 
     bool is_checksum( const Pathname & file, const CheckSum &checksum )
@@ -1027,6 +1135,15 @@ namespace zypp
       return ( filesystem::checksum(file,  checksum.type()) == checksum.checksum() );
     }
 
+    std::vector<bool> verifyFiles( const std::vector<std::pair<Pathname,CheckSum>> & files_r, unsigned threads_r )
+    {
+      std::vector<char> ok( files_r.size(), false );	// not vector<bool>: written concurrently
+      parallelFor( files_r.size(), [&]( size_t idx_r ) {
+        ok[idx_r] = is_checksum( files_r[idx_r].first, files_r[idx_r].second );
+      }, threads_r );
+      return std::vector<bool>( ok.begin(), ok.end() );
+    }
+
     ///////////////////////////////////////////////////////////////////
     //
     //	METHOD NAME : erase
@@ -1101,6 +1218,8 @@ namespace zypp
           } else if ( magic[0] == '\0' && magic[1] == 'Z' && magic[2] == 'C' && magic[3] == 'K' && magic[4] == '1') {
             ret = ZT_ZCHNK;
 
+          } else if ( magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD ) {
+            ret = ZT_ZSTD;
           }
         }
         close( fd );
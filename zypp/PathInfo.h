@@ -26,6 +26,8 @@ extern "C"
 #include <list>
 #include <set>
 #include <map>
+#include <utility>
+#include <vector>
 
 #include <zypp/Pathname.h>
 #include <zypp/CheckSum.h>
@@ -731,6 +733,10 @@ namespace zypp
     /**
      * Compute a files checksum
      *
+     * The file is read in large blocks. The result is remembered as long as
+     * the file is not modified (device, inode, size, mtime and ctime), so
+     * asking again for an unchanged file does not re-read it.
+     *
      * @return the files checksum on success, otherwise an empty string..
      **/
     std::string checksum( const Pathname & file, const std::string &algorithm );
@@ -742,6 +748,14 @@ namespace zypp
      **/
     bool is_checksum( const Pathname & file, const CheckSum &checksum );
 
+    /**
+     * Check the checksums of a batch of files, using up to \a threads_r
+     * threads (\c 0 means one per CPU).
+     *
+     * @return for each file, whether \ref is_checksum succeeded.
+     **/
+    std::vector<bool> verifyFiles( const std::vector<std::pair<Pathname,CheckSum>> & files_r, unsigned threads_r = 0 );
+
     ///////////////////////////////////////////////////////////////////
     /** \name Changing permissions. */
     //@{
@@ -771,11 +785,11 @@ namespace zypp
     /** \name Misc. */
     //@{
     /**
-     * Test whether a file is compressed (gzip/bzip2).
+     * Test whether a file is compressed (gzip/bzip2/zchunk/zstd).
      *
-     * @return ZT_GZ, ZT_BZ2 if file is compressed, otherwise ZT_NONE.
+     * @return ZT_GZ, ZT_BZ2, ZT_ZCHNK, ZT_ZSTD if file is compressed, otherwise ZT_NONE.
      **/
-    enum ZIP_TYPE { ZT_NONE, ZT_GZ, ZT_BZ2, ZT_ZCHNK };
+    enum ZIP_TYPE { ZT_NONE, ZT_GZ, ZT_BZ2, ZT_ZCHNK, ZT_ZSTD };
 
     ZIP_TYPE zipType( const Pathname & file );
 
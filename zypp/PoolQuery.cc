@@ -9,8 +9,17 @@
 /** \file	zypp/PoolQuery.cc
  *
 */
+extern "C"
+{
+#include <solv/repo.h>
+}
 #include <iostream>
 #include <sstream>
+#include <tuple>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <atomic>
 
 #include <zypp/base/Gettext.h>
 #include <zypp/base/LogTools.h>
@@ -21,7 +30,10 @@
 
 #include <zypp/sat/Pool.h>
 #include <zypp/sat/Solvable.h>
+#include <zypp/sat/detail/PoolImpl.h>
 #include <zypp/base/StrMatcher.h>
+#include <zypp/base/SerialNumber.h>
+#include <zypp/ZConfig.h>
 
 #include <zypp/PoolQuery.h>
 
@@ -1029,7 +1041,14 @@ namespace zypp
 
   bool PoolQuery::empty() const
   {
-    try { return begin() == end(); }
+    try
+    {
+      if ( resultCacheEnabled() )
+      {
+        return cachedResult() == 0;
+      }
+      return begin() == end();
+    }
     catch (const Exception & ex) {}
     return true;
   }
@@ -1038,6 +1057,8 @@ namespace zypp
   {
     try
     {
+      if ( resultCacheEnabled() )
+        return cachedResult();
       size_type count = 0;
       for_( it, begin(), end() )
         ++count;
@@ -1048,7 +1069,195 @@ namespace zypp
   }
 
   void PoolQuery::execute(ProcessResolvable fnc)
-  { invokeOnEach( begin(), end(), fnc); }
+  {
+    if ( resultCacheEnabled() )
+    {
+      sat::Map result( resultMap() );
+      for ( sat::Map::size_type idx = 0; idx < result.size(); ++idx )
+        if ( result.test( idx ) && ! fnc( sat::Solvable( idx ) ) )
+          break;
+      return;
+    }
+    invokeOnEach( begin(), end(), fnc);
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  namespace
+  {
+    /** The content of a repo: its solvable id range, number of solvables and repodata
+     * and the pools serial at its last content change (catches in place reloads which
+     * keep the counts).
+     */
+    typedef std::tuple<sat::detail::SolvableIdType,sat::detail::SolvableIdType,int,int,unsigned> RepoFingerprint;
+
+    inline RepoFingerprint repoFingerprint( Repository repo_r )
+    {
+      sat::detail::CRepo * repo = repo_r.get();
+      return RepoFingerprint( repo->start, repo->end, repo->nsolvables, repo->nrepodata,
+                              sat::detail::PoolMember::myPool().repoSerial( repo ) );
+    }
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class PoolQueryResultCache
+    /// \brief The PoolQuery results per repo, keyed by the query.
+    ///
+    /// The key is a copy of the complete \ref PoolQuery::Impl (compared by
+    /// its \c operator<) and the text locale localized attributes depend on.
+    /// \ref PoolQuery::serialize is not suitable as key, as it does not
+    /// distinguish e.g. word and substring matches.
+    ///////////////////////////////////////////////////////////////////
+    struct PoolQueryResultCache
+    {
+      /** Bound for the number of cached queries; the cache is cleared if exceeded. */
+      static constexpr unsigned maxEntries = 512;
+
+      struct RepoResult
+      {
+        RepoFingerprint _fingerprint;
+        std::vector<bool> _hits;	// indexed by (solvable id - repo start)
+      };
+
+      struct Entry
+      {
+        SerialNumberWatcher _watcher;	// sat::Pool serial the _result was computed for
+        std::map<sat::detail::RepoIdType,RepoResult> _repos;
+        sat::Map _result;
+        PoolQuery::size_type _count = 0;	// number of bits set in _result
+      };
+
+      typedef std::pair<PoolQuery::Impl,std::string> Key;
+
+      std::atomic<bool> _enabled { false };
+      std::mutex _mutex;		// guards all but _enabled
+      SerialNumberWatcher _watcherIDs;	// pool IDs reused: forget all
+      std::map<Key,Entry> _entries;
+    };
+
+    inline PoolQueryResultCache & resultCache()
+    {
+      static PoolQueryResultCache _cache;
+      return _cache;
+    }
+  } // namespace
+  ///////////////////////////////////////////////////////////////////
+
+  bool PoolQuery::resultCacheEnabled()
+  { return resultCache()._enabled; }
+
+  void PoolQuery::setResultCacheEnabled( bool yesno_r )
+  {
+    PoolQueryResultCache & cache( resultCache() );
+    MIL << "PoolQuery result cache " << (yesno_r ? "enabled" : "disabled") << endl;
+    std::lock_guard<std::mutex> guard( cache._mutex );
+    cache._enabled = yesno_r;
+    cache._entries.clear();
+  }
+
+  sat::Map PoolQuery::resultMap() const
+  {
+    if ( ! resultCacheEnabled() )
+    {
+      sat::Map ret( sat::Map::poolSize );
+      for_( it, begin(), end() )
+        ret.set( (*it).id() );
+      return ret;
+    }
+    sat::Map ret;
+    cachedResult( &ret );
+    return ret;
+  }
+
+  PoolQuery::size_type PoolQuery::cachedResult( sat::Map * result_r ) const
+  {
+    sat::Pool satpool( sat::Pool::instance() );
+    PoolQueryResultCache & cache( resultCache() );
+    std::lock_guard<std::mutex> guard( cache._mutex );
+    if ( cache._watcherIDs.remember( satpool.serialIDs() ) )
+      cache._entries.clear();
+
+    // Localized attributes depend on the text locale.
+    PoolQueryResultCache::Key key( *_pimpl, ZConfig::instance().textLocale().code() );
+    key.first._attrMatchList.clear();	// compiled on demand; not part of the query
+
+    auto eit = cache._entries.find( key );
+    if ( eit == cache._entries.end() )
+    {
+      if ( cache._entries.size() >= PoolQueryResultCache::maxEntries )
+        cache._entries.clear();
+      eit = cache._entries.emplace( key, PoolQueryResultCache::Entry() ).first;
+    }
+    PoolQueryResultCache::Entry & entry( eit->second );
+    if ( ! entry._watcher.isDirty( satpool.serial() ) )
+    {
+      if ( result_r )
+        *result_r = entry._result;
+      return entry._count;
+    }
+
+    // Search the repos whose content changed, take the others from the cache.
+    try
+    {
+      std::map<sat::detail::RepoIdType,PoolQueryResultCache::RepoResult> repos;
+      unsigned searched = 0;
+      for_( rit, satpool.reposBegin(), satpool.reposEnd() )
+      {
+        Repository repo( *rit );
+        RepoFingerprint fingerprint( repoFingerprint( repo ) );
+        auto old = entry._repos.find( repo.get() );
+        if ( old != entry._repos.end() && old->second._fingerprint == fingerprint )
+        {
+          repos[repo.get()] = old->second;
+          continue;
+        }
+
+        PoolQueryResultCache::RepoResult & res( repos[repo.get()] );
+        res._fingerprint = fingerprint;
+        sat::detail::SolvableIdType start = std::get<0>(fingerprint);
+        res._hits.assign( std::get<1>(fingerprint) - start, false );
+        if ( ! _pimpl->_repos.empty() && ! _pimpl->_repos.count( repo.alias() ) )
+          continue;	// not to be searched
+
+        // The same query, but restricted to this repo
+        PoolQuery query;
+        *query._pimpl = *_pimpl;
+        query._pimpl->_repos = { repo.alias() };
+        for_( it, query.begin(), query.end() )
+        {
+          sat::detail::SolvableIdType id = (*it).id();
+          if ( id >= start && id - start < res._hits.size() )
+            res._hits[id - start] = true;
+        }
+        ++searched;
+      }
+      entry._repos.swap( repos );
+
+      sat::Map result( sat::Map::poolSize );
+      size_type count = 0;
+      for ( const auto & repo : entry._repos )
+      {
+        const std::vector<bool> & hits( repo.second._hits );
+        sat::detail::SolvableIdType start = std::get<0>(repo.second._fingerprint);
+        for ( sat::detail::SolvableIdType idx = 0; idx < hits.size(); ++idx )
+          if ( hits[idx] )
+          {
+            result.set( start + idx );
+            ++count;
+          }
+      }
+      entry._result = result;
+      entry._count = count;
+      entry._watcher.remember( satpool.serial() );
+      DBG << "PoolQuery result cache: searched " << searched << " of " << entry._repos.size() << " repos" << endl;
+    }
+    catch ( ... )
+    {
+      cache._entries.erase( eit );
+      throw;
+    }
+    if ( result_r )
+      *result_r = entry._result;
+    return entry._count;
+  }
 
 
   /*DEPRECATED LEGACY:*/void PoolQuery::setRequireAll( bool ) {}
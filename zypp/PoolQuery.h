@@ -24,6 +24,7 @@
 #include <zypp/sat/LookupAttr.h>
 #include <zypp/base/StrMatcher.h>
 #include <zypp/sat/Pool.h>
+#include <zypp/sat/Map.h>
 
 ///////////////////////////////////////////////////////////////////
 namespace zypp
@@ -127,6 +128,30 @@ namespace zypp
 
     /** Number of solvables in the query result. */
     size_type size() const;
+
+    /** The query result as bitmap indexed by solvable id.
+     * If the \ref resultCacheEnabled, the result is taken from the cache.
+     * \throws sat::MatchInvalidRegexException like \ref begin.
+     */
+    sat::Map resultMap() const;
+    //@}
+
+    /** \name Query result cache (opt-in, disabled by default).
+     * If enabled, \ref resultMap, \ref empty, \ref size, \ref execute and
+     * \ref PoolQueryResult remember the results of a query per repo. They are
+     * keyed by the complete query state, the text locale and the \ref sat::Pool
+     * serial number. After the pool changed, only repos whose content changed are
+     * searched again. Iterating the query via \ref begin always searches the pool.
+     *
+     * The cache lives in memory only: results are solvable ids, which are not
+     * stable across processes. The repos solv files already are the persistent
+     * form of the searched data.
+     */
+    //@{
+    /** Whether the query result cache is enabled. */
+    static bool resultCacheEnabled();
+    /** Enable or disable (and clear) the query result cache. */
+    static void setResultCacheEnabled( bool yesno_r );
     //@}
 
     /**
@@ -482,6 +507,11 @@ namespace zypp
   public:
     class Impl;
   private:
+    /** The number of solvables in the cached \ref resultMap (\ref resultCacheEnabled).
+     * If \a result_r is not \c nullptr, a copy of the map is stored there. The cache
+     * is locked meanwhile, so concurrent queries do not invalidate the result.
+     */
+    size_type cachedResult( sat::Map * result_r = nullptr ) const;
     /** Pointer to implementation */
     RW_pointer<Impl> _pimpl;
   };
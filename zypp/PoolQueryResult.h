@@ -144,8 +144,18 @@ namespace zypp
       {
         try
         {
-          for_( it, query_r.begin(), query_r.end() )
-            _result.insert( *it );
+          if ( PoolQuery::resultCacheEnabled() )
+          {
+            sat::Map result( query_r.resultMap() );
+            for ( sat::Map::size_type idx = 0; idx < result.size(); ++idx )
+              if ( result.test( idx ) )
+                _result.insert( sat::Solvable( idx ) );
+          }
+          else
+          {
+            for_( it, query_r.begin(), query_r.end() )
+              _result.insert( *it );
+          }
         }
         catch ( const Exception & )
         {}
@@ -18,6 +18,7 @@
 #include <zypp/PoolQuery.h>
 #include <zypp/ResPool.h>
 #include <zypp/Resolver.h>
+#include <zypp/sat/Pool.h>
 #include <zypp/Filter.h>
 #include <zypp/ZConfig.h>
 
@@ -55,6 +56,9 @@ namespace zypp {
   };
   using GroupMap = std::unordered_map<std::string, GroupInfo>;
 
+  /** Installed packages providing a \c -debuginfo or \c -debugsource name, indexed by that name. */
+  using DebugPackageIndex = std::unordered_map<IdString, std::vector<sat::Solvable>>;
+
   struct PurgeKernels::Impl  {
 
     Impl() {
@@ -101,7 +105,11 @@ namespace zypp {
       MIL << "Kernel Edition: " << _runningKernelEdition << std::endl;
     }
 
-    bool removePackageAndCheck( const sat::Solvable slv, const std::set<sat::Solvable> &keepList , const std::set<sat::Solvable> &removeList ) const;
+    bool removePackageAndCheck( const sat::Solvable slv, const std::set<sat::Solvable> &keepList , const std::set<sat::Solvable> &removeList, const DebugPackageIndex &debugPackages ) const;
+    bool removeAllAndCheck( const std::set<sat::Solvable> &keepList , const std::set<sat::Solvable> &removeList, const DebugPackageIndex &debugPackages ) const;
+    static bool isValidRemoval( const PoolItem &p, const std::set<sat::Solvable> &keepList , const std::set<sat::Solvable> &removeList );
+    static DebugPackageIndex indexDebugPackages();
+    static std::vector<sat::Solvable> debugPackagesFor( const sat::Solvable solvable, const DebugPackageIndex &debugPackages );
     static bool versionMatch ( const Edition &a, const Edition &b );
     void parseKeepSpec();
     void fillKeepList(const GroupMap &installedKernels, std::set<sat::Solvable> &keepList , std::set<sat::Solvable> &removeList ) const;
@@ -118,11 +126,197 @@ namespace zypp {
     bool              _detectedRunning = false;
   };
 
+  /*!
+   * Collects all installed packages providing a \c -debugsource or \c -debuginfo name in a single pass,
+   * so they need not be queried for each removed package.
+   */
+  DebugPackageIndex PurgeKernels::Impl::indexDebugPackages()
+  {
+    DebugPackageIndex ret;
+    for ( sat::Solvable solv : sat::Pool::instance().findSystemRepo().solvables() ) {
+      if ( !solv.isKind( ResKind::package ) )
+        continue;
+
+      for ( const Capability &prov : solv.provides() ) {
+        const IdString name = prov.detail().name();
+        if ( !str::hasSuffix( name.c_str(), "-debugsource" ) && !str::hasSuffix( name.c_str(), "-debuginfo" ) )
+          continue;
+
+        auto &entry = ret[name];
+        if ( entry.empty() || entry.back() != solv )
+          entry.push_back( solv );
+      }
+    }
+    return ret;
+  }
+
+  /*!
+   * Returns the installed -debugsource and -debuginfo packages matching name, edition and arch of \a solvable.
+   */
+  std::vector<sat::Solvable> PurgeKernels::Impl::debugPackagesFor( const sat::Solvable solvable, const DebugPackageIndex &debugPackages )
+  {
+    std::vector<sat::Solvable> ret;
+    if ( solvable.arch() == Arch_noarch ||
+         solvable.arch() == Arch_empty )
+      return ret;
+
+    for ( const char * suffix : { "-debugsource", "-debuginfo" } ) {
+      const std::string debugName = solvable.name()+suffix;
+
+      auto it = debugPackages.find( IdString( debugName ) );
+      if ( it == debugPackages.end() )
+        continue;
+
+      const Capability cap( debugName, Rel::EQ, solvable.edition() );
+      for ( sat::Solvable debugPackage : it->second ) {
+        if ( debugPackage.arch() == solvable.arch() && debugPackage.provides().matches( cap ) )
+          ret.push_back( debugPackage );
+      }
+    }
+    return ret;
+  }
+
+  /*!
+   * Checks whether the package \a p, which the solver marked for removal, may be removed.
+   * That is, we plan to remove it anyway, or it is not in the \a keepList and it is a kmod or matches the \a validRemovals regex.
+   */
+  bool PurgeKernels::Impl::isValidRemoval( const PoolItem &p, const std::set<sat::Solvable> &keepList, const std::set<sat::Solvable> &removeList )
+  {
+    //list of packages that are allowed to be removed automatically.
+    static const str::regex validRemovals("(kernel-syms(-.*)?|kgraft-patch(-.*)?|kernel-livepatch(-.*)?|.*-kmp(-.*)?)");
+
+    // if we do not plan to remove that package anyway, we need to check if its allowed to be removed ( package in removelist can never be in keep list )
+    if ( removeList.find( p.satSolvable() ) != removeList.end() )
+      return true;
+
+    if ( keepList.find( p.satSolvable() ) != keepList.end() ) {
+      MIL << "Package " << p << " is in keep spec" << std::endl;
+      return false;
+    }
+
+    /*
+     * bsc#1185325 We can not solely rely on name matching to figure out
+     * which packages are kmod's, in SLES from Leap 15.3 forward we have the
+     * kernel-flavour-extra packages ( and others similarly named ) that are basically
+     * a collection of kmod's. So checking the name for .*-kmp(-.*)? is not enough.
+     * We first check if the package provides kmod(*) or ksym(*) and only fall back to name
+     * checking if that is not the case.
+     * Just to be safe I'll leave the regex in the fallback case as well, but it should be completely
+     * redundant now.
+     */
+    bool mostLikelyKmod = false;
+    StrMatcher matchMod( "kmod(*)", Match::GLOB );
+    StrMatcher matchSym( "ksym(*)", Match::GLOB );
+    for ( const auto &prov : p.provides() ) {
+      if ( matchMod.doMatch( prov.detail().name().c_str()) || matchSym.doMatch( prov.detail().name().c_str() ) ) {
+        mostLikelyKmod = true;
+        break;
+      }
+    }
+
+    if ( mostLikelyKmod  ) {
+      MIL << "Package " << p << " is most likely a kmod " << std::endl;
+    } else {
+      str::smatch what;
+      if ( !str::regex_match( p.name(), what, validRemovals) ) {
+        MIL << "Package " << p << " should not be removed" << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*!
+   * Marks all packages in \a removeList and their debug packages for removal and solves once.
+   * The result is checked like \ref removePackageAndCheck does. Debug packages of packages the solver
+   * removed in addition are marked too, which may need another solver run.
+   * If the constraints fail the changes are reverted and \a false is returned, so the caller can
+   * fall back to removing the packages one by one.
+   */
+  bool PurgeKernels::Impl::removeAllAndCheck( const std::set<sat::Solvable> &keepList, const std::set<sat::Solvable> &removeList, const DebugPackageIndex &debugPackages ) const
+  {
+    const filter::ByStatus toBeUninstalledFilter( &ResStatus::isToBeUninstalled );
+
+    auto pool = ResPool::instance();
+
+    // make sure the pool is clean
+    if ( !pool.resolver().resolvePool() ) {
+      MIL << "Pool failed to resolve, not doing anything" << std::endl;
+      return false;
+    }
+
+    //remember which packages are already marked for removal, we do not need to check them again
+    std::set<sat::Solvable> currentSetOfRemovals;
+    for ( const PoolItem & p : pool.byStatus( toBeUninstalledFilter ) ) {
+      currentSetOfRemovals.insert( p.satSolvable() );
+    }
+
+    std::vector<PoolItem> marked;
+    const auto markForRemoval = [&marked]( const sat::Solvable slv ) {
+      PoolItem pi ( slv );
+      if ( pi.status().isToBeUninstalled() )
+        return;
+      if ( pi.status().isLocked() ) {
+        MIL << "Package " << pi << " is locked by the user, not removing." << std::endl;
+        return;
+      }
+      MIL << "Request to remove package: " << pi << std::endl;
+      pi.status().setToBeUninstalled( ResStatus::USER );
+      marked.push_back( pi );
+    };
+    const auto revert = [&marked]() {
+      for ( PoolItem & pi : marked )
+        pi.statusReset();
+    };
+
+    for ( sat::Solvable slv : removeList ) {
+      markForRemoval( slv );
+      for ( sat::Solvable debugPackage : debugPackagesFor( slv, debugPackages ) )
+        markForRemoval( debugPackage );
+    }
+
+    std::set<sat::Solvable> checked;
+    for ( size_t markedBefore = 0; markedBefore != marked.size(); ) {
+      markedBefore = marked.size();
+
+      if ( !pool.resolver().resolvePool() ) {
+        MIL << "Failed to resolve pool with all removals" << std::endl;
+        pool.resolver().problems();
+        revert();
+        return false;
+      }
+
+      std::vector<PoolItem> removedBySolver;
+      for ( const PoolItem & p : pool.byStatus( toBeUninstalledFilter ) ) {
+        if ( p.status().isByUser()      //this was set by us, ignore it
+             || (currentSetOfRemovals.find( p.satSolvable() ) != currentSetOfRemovals.end()) //this was marked before, ignore them
+             || !checked.insert( p.satSolvable() ).second ) //checked in a previous run
+          continue;
+        removedBySolver.push_back( p );
+      }
+
+      for ( const PoolItem & p : removedBySolver ) {
+        MIL << "Package " << p << " was marked by the solver for removal." << std::endl;
+        if ( !isValidRemoval( p, keepList, removeList ) ) {
+          MIL << "Reverting all removals" << std::endl;
+          revert();
+          return false;
+        }
+        // we need remove the debugsource and debuginfo packages as well
+        for ( sat::Solvable debugPackage : debugPackagesFor( p.satSolvable(), debugPackages ) )
+          markForRemoval( debugPackage );
+      }
+    }
+
+    MIL << "Successfully marked " << marked.size() << " packages for removal." << std::endl;
+    return true;
+  }
+
   /*!
    * tries to remove a the \ref PoolItem \a pi from the pool, solves and checks if no unexpected packages are removed due to the \a validRemovals regex.
    * If the constraint fails the changes are reverted and \a false is returned.
    */
-  bool PurgeKernels::Impl::removePackageAndCheck( const sat::Solvable slv, const std::set<sat::Solvable> &keepList , const std::set<sat::Solvable> &removeList ) const
+  bool PurgeKernels::Impl::removePackageAndCheck( const sat::Solvable slv, const std::set<sat::Solvable> &keepList , const std::set<sat::Solvable> &removeList, const DebugPackageIndex &debugPackages ) const
   {
     const filter::ByStatus toBeUninstalledFilter( &ResStatus::isToBeUninstalled );
 
@@ -138,9 +332,6 @@ namespace zypp {
 
     MIL << "Request to remove package: " << pi << std::endl;
 
-    //list of packages that are allowed to be removed automatically.
-    const str::regex validRemovals("(kernel-syms(-.*)?|kgraft-patch(-.*)?|kernel-livepatch(-.*)?|.*-kmp(-.*)?)");
-
     if ( pi.status().isLocked() ) {
       MIL << "Package " << pi << " is locked by the user, not removing." << std::endl;
       return false;
@@ -178,74 +369,22 @@ namespace zypp {
 
       MIL << "Package " << p << " was marked by the solver for removal." << std::endl;
 
-      // if we do not plan to remove that package anyway, we need to check if its allowed to be removed ( package in removelist can never be in keep list )
-      if ( removeList.find( p.satSolvable() ) != removeList.end() )
-        continue;
-
-      if ( keepList.find( p.satSolvable() ) != keepList.end() ) {
-        MIL << "Package " << p << " is in keep spec, skipping" << pi << std::endl;
+      if ( !isValidRemoval( p, keepList, removeList ) ) {
+        MIL << "Skipping " << pi << std::endl;
         pi.statusReset();
         return false;
       }
-
-      /*
-       * bsc#1185325 We can not solely rely on name matching to figure out
-       * which packages are kmod's, in SLES from Leap 15.3 forward we have the
-       * kernel-flavour-extra packages ( and others similarly named ) that are basically
-       * a collection of kmod's. So checking the name for .*-kmp(-.*)? is not enough.
-       * We first check if the package provides kmod(*) or ksym(*) and only fall back to name
-       * checking if that is not the case.
-       * Just to be safe I'll leave the regex in the fallback case as well, but it should be completely
-       * redundant now.
-       */
-      bool mostLikelyKmod = false;
-      StrMatcher matchMod( "kmod(*)", Match::GLOB );
-      StrMatcher matchSym( "ksym(*)", Match::GLOB );
-      for ( const auto &prov : p.provides() ) {
-        if ( matchMod.doMatch( prov.detail().name().c_str()) || matchSym.doMatch( prov.detail().name().c_str() ) ) {
-          mostLikelyKmod = true;
-          break;
-        }
-      }
-
-      if ( mostLikelyKmod  ) {
-        MIL << "Package " << p << " is most likely a kmod " << std::endl;
-      } else {
-        str::smatch what;
-        if ( !str::regex_match( p.name(), what, validRemovals) ) {
-          MIL << "Package " << p << " should not be removed, skipping " << pi << std::endl;
-          pi.statusReset();
-          return false;
-        }
-      }
     }
 
     MIL << "Successfully marked package: " << pi << " for removal."<<std::endl;
 
-    //now check and mark the -debugsource and -debuginfo packages for this package and all the packages that were removed. Maybe collect it before and just remove here
+    //now check and mark the -debugsource and -debuginfo packages for this package and all the packages that were removed.
     MIL << "Trying to remove debuginfo for: " << pi <<"."<<std::endl;
     for ( sat::Solvable solvable : removedInThisRun ) {
-
-      if ( solvable.arch() == Arch_noarch ||
-           solvable.arch() == Arch_empty )
-        continue;
-
-      for ( const char * suffix : { "-debugsource", "-debuginfo" } ) {
-        PoolQuery q;
-        q.addKind( zypp::ResKind::package );
-        q.addDependency( sat::SolvAttr::provides, Capability( solvable.name()+suffix, Rel::EQ, solvable.edition() ) );
-        q.setInstalledOnly();
-        q.setMatchExact();
-
-        for ( sat::Solvable debugPackage : q ) {
-
-          if ( debugPackage.arch() != solvable.arch() )
-            continue;
-
-          MIL << "Found debug package for " << solvable << " : " << debugPackage << std::endl;
-          //if removing the package fails it will not stop us from going on , so no need to check
-          removePackageAndCheck( debugPackage, keepList, removeList );
-        }
+      for ( sat::Solvable debugPackage : debugPackagesFor( solvable, debugPackages ) ) {
+        MIL << "Found debug package for " << solvable << " : " << debugPackage << std::endl;
+        //if removing the package fails it will not stop us from going on , so no need to check
+        removePackageAndCheck( debugPackage, keepList, removeList, debugPackages );
       }
     }
     MIL << "Finished removing debuginfo for: " << pi <<"."<<std::endl;
@@ -621,8 +760,17 @@ namespace zypp {
 
     _pimpl->fillKeepList( installedKrnlPackages, packagesToKeep, packagesToRemove );
 
+    const DebugPackageIndex debugPackages = Impl::indexDebugPackages();
+
+    // Usually all removals can be done in a single solver run. Only if this
+    // removes something it should not, we need to find out which package is
+    // to blame by removing them one by one.
+    if ( packagesToRemove.empty() || _pimpl->removeAllAndCheck( packagesToKeep, packagesToRemove, debugPackages ) )
+      return;
+
+    MIL << "Falling back to removing the packages one by one." << std::endl;
     for ( sat::Solvable slv : packagesToRemove )
-      _pimpl->removePackageAndCheck( slv, packagesToKeep, packagesToRemove );
+      _pimpl->removePackageAndCheck( slv, packagesToKeep, packagesToRemove, debugPackages );
   }
 
   void PurgeKernels::setUnameR( const std::string &val )
@@ -17,6 +17,8 @@
 #include <list>
 #include <map>
 #include <algorithm>
+#include <chrono>
+#include <future>
 
 #include <solv/solvversion.h>
 
@@ -26,6 +28,7 @@
 #include <zypp/base/DefaultIntegral.h>
 #include <zypp/base/Function.h>
 #include <zypp/base/Regex.h>
+#include <zypp/base/WorkerPool_p.h>
 #include <zypp/PathInfo.h>
 #include <zypp/TmpPath.h>
 
@@ -35,6 +38,10 @@
 
 #include <zypp/media/MediaManager.h>
 #include <zypp/media/CredentialManager.h>
+#include <zypp/media/CurlHelper.h>
+#include <zypp/zyppng/base/EventDispatcher>
+#include <zypp/zyppng/media/network/downloader.h>
+#include <zypp/zyppng/media/network/networkrequestdispatcher.h>
 #include <zypp/MediaSetAccess.h>
 #include <zypp/ExternalProgram.h>
 #include <zypp/ManagedFile.h>
@@ -45,6 +52,8 @@
 #include <zypp/repo/yum/Downloader.h>
 #include <zypp/repo/susetags/Downloader.h>
 #include <zypp/repo/PluginServices.h>
+#include <zypp/repo/SolvCacheBuilder.h>
+#include <zypp/repo/RepoMirrorRace.h>
 
 #include <zypp/Target.h> // for Target::targetDistribution() for repo index services
 #include <zypp/ZYppFactory.h> // to get the Target from ZYpp instance
@@ -598,6 +607,7 @@ namespace zypp
     RefreshCheckStatus checkIfToRefreshMetadata( const RepoInfo & info, const Url & url, RawMetadataRefreshPolicy policy );
 
     void refreshMetadata( const RepoInfo & info, RawMetadataRefreshPolicy policy, OPT_PROGRESS );
+    void refreshMetadata( const RepoInfo & info, RawMetadataRefreshPolicy policy, const Pathname & prefetched, OPT_PROGRESS );
 
     void cleanMetadata( const RepoInfo & info, OPT_PROGRESS );
 
@@ -605,6 +615,9 @@ namespace zypp
 
     void buildCache( const RepoInfo & info, CacheBuildPolicy policy, OPT_PROGRESS );
 
+    RefreshErrors refreshRepositories( const std::vector<RepoInfo> & infos, RawMetadataRefreshPolicy policy, unsigned concurrency, OPT_PROGRESS );
+    filesystem::TmpPath prefetchMetadata( const std::vector<RepoInfo> & infos, RawMetadataRefreshPolicy policy );
+
     repo::RepoType probe( const Url & url, const Pathname & path = Pathname() ) const;
     repo::RepoType probeCache( const Pathname & path_r ) const;
 
@@ -685,6 +698,17 @@ namespace zypp
 
     void touchIndexFile( const RepoInfo & info );
 
+    /** Whether the cache needs to be (re)built; an outdated cache is cleaned.
+     * Raw metadata are downloaded if missing. Their status is returned in \a raw_metadata_status_r.
+     */
+    bool cacheNeedsRebuild( const RepoInfo & info, CacheBuildPolicy policy, RepoStatus & raw_metadata_status_r, OPT_PROGRESS );
+
+    /** Assert the solv cache dir exists and return the (probed) metadata type. */
+    repo::RepoType prepareCacheBuild( const RepoInfo & info );
+
+    /** Create the solv file and solv.idx in-process or (as fallback, or if \a tryInProcess is \c false) via repo2solv. */
+    void buildSolvFile( const RepoInfo & info, const repo::RepoType & repokind, bool tryInProcess = true );
+
     template<typename OutputIterator>
     void getRepositoriesInService( const std::string & alias, OutputIterator out ) const
     {
@@ -1111,6 +1135,9 @@ namespace zypp
 
 
   void RepoManager::Impl::refreshMetadata( const RepoInfo & info, RawMetadataRefreshPolicy policy, const ProgressData::ReceiverFnc & progress )
+  { refreshMetadata( info, policy, Pathname(), progress ); }
+
+  void RepoManager::Impl::refreshMetadata( const RepoInfo & info, RawMetadataRefreshPolicy policy, const Pathname & prefetched, const ProgressData::ReceiverFnc & progress )
   {
     assert_alias(info);
     assert_urls(info);
@@ -1122,8 +1149,35 @@ namespace zypp
 
     // Suppress (interactive) media::MediaChangeReport if we in have multiple basurls (>1)
     media::ScopedDisableMediaChangeReport guard( info.baseUrlsSize() > 1 );
+
+    // Optionally rank the urls by past performance and race the first ones.
+    // The race probes the mirrors, so it is done only if a refresh is needed
+    // (or the best ranked url fails to tell), not e.g. within repo.refresh.delay.
+    std::vector<Url> urls( info.baseUrlsBegin(), info.baseUrlsEnd() );
+    const Pathname mirrorstatsfile( rawcache_path_for_repoinfo( _options, info ) / "mirrorstats" );
+    MirrorStats mirrorstats;
+    bool refreshNeeded = false;	// already checked
+    unsigned raceUrls = ZConfig::instance().repo_refresh_race_urls();
+    if ( raceUrls > 1 && urls.size() > 1 )
+    {
+      mirrorstats = MirrorStats::fromFile( mirrorstatsfile );
+      urls = mirrorstats.rank( std::move(urls) );
+      try
+      {
+        if ( checkIfToRefreshMetadata( info, urls.front(), policy ) != REFRESH_NEEDED )
+          return;
+        refreshNeeded = true;
+      }
+      catch ( const Exception & e )
+      {
+        ZYPP_CAUGHT( e );	// the race tells which urls respond
+      }
+      Pathname probefile( info.path() / ( info.type() == RepoType::YAST2 ? "content" : "repodata/repomd.xml" ) );
+      urls = raceMirrors( urls, probefile, raceUrls, mirrorstats );
+    }
+
     // try urls one by one
-    for ( RepoInfo::urls_const_iterator it = info.baseUrlsBegin(); it != info.baseUrlsEnd(); ++it )
+    for ( std::vector<Url>::const_iterator it = urls.begin(); it != urls.end(); ++it )
     {
       try
       {
@@ -1131,7 +1185,7 @@ namespace zypp
 
         // check whether to refresh metadata
         // if the check fails for this url, it throws, so another url will be checked
-        if (checkIfToRefreshMetadata(info, url, policy)!=REFRESH_NEEDED)
+        if ( ! refreshNeeded && checkIfToRefreshMetadata(info, url, policy)!=REFRESH_NEEDED)
           return;
 
         MIL << "Going to refresh metadata from " << url << endl;
@@ -1205,6 +1259,9 @@ namespace zypp
             if ( PathInfo(cachepath).isExist() )
               downloader_ptr->addCachePath(cachepath);
           }
+          // files downloaded ahead by prefetchMetadata
+          if ( ! prefetched.empty() && PathInfo(prefetched).isDir() )
+            downloader_ptr->addCachePath( prefetched );
 
           downloader_ptr->download( media, tmpdir.path() );
         }
@@ -1224,7 +1281,9 @@ namespace zypp
         }
 
         // ok we have the metadata, now exchange
-        // the contents
+        // the contents (the mirror stats go along, the live raw cache is not touched before)
+        if ( ! mirrorstats.empty() )
+          mirrorstats.saveToFile( tmpdir.path() / mirrorstatsfile.basename() );
 	filesystem::exchange( tmpdir.path(), mediarootpath );
 	if ( ! isTmpRepo( info ) )
 	  reposManip();	// remember to trigger appdata refresh
@@ -1240,7 +1299,7 @@ namespace zypp
         // remember the exception caught for the *first URL*
         // if all other URLs fail, the rexception will be thrown with the
         // cause of the problem of the first URL remembered
-        if (it == info.baseUrlsBegin())
+        if (it == urls.begin())
           rexception.remember(e);
 	else
 	  rexception.addHistory(  e.asUserString() );
@@ -1273,34 +1332,31 @@ namespace zypp
   }
 
 
-  void RepoManager::Impl::buildCache( const RepoInfo & info, CacheBuildPolicy policy, const ProgressData::ReceiverFnc & progressrcv )
+  bool RepoManager::Impl::cacheNeedsRebuild( const RepoInfo & info, CacheBuildPolicy policy, RepoStatus & raw_metadata_status_r, const ProgressData::ReceiverFnc & progressrcv )
   {
     assert_alias(info);
-    Pathname mediarootpath = rawcache_path_for_repoinfo( _options, info );
-    Pathname productdatapath = rawproductdata_path_for_repoinfo( _options, info );
 
     if( filesystem::assert_dir(_options.repoCachePath) )
     {
       Exception ex(str::form( _("Can't create %s"), _options.repoCachePath.c_str()) );
       ZYPP_THROW(ex);
     }
-    RepoStatus raw_metadata_status = metadataStatus(info);
-    if ( raw_metadata_status.empty() )
+    raw_metadata_status_r = metadataStatus(info);
+    if ( raw_metadata_status_r.empty() )
     {
        /* if there is no cache at this point, we refresh the raw
           in case this is the first time - if it's !autorefresh,
           we may still refresh */
       refreshMetadata(info, RefreshIfNeeded, progressrcv );
-      raw_metadata_status = metadataStatus(info);
+      raw_metadata_status_r = metadataStatus(info);
     }
 
-    bool needs_cleaning = false;
     if ( isCached( info ) )
     {
       MIL << info.alias() << " is already cached." << endl;
       RepoStatus cache_status = cacheStatus(info);
 
-      if ( cache_status == raw_metadata_status )
+      if ( cache_status == raw_metadata_status_r )
       {
         MIL << info.alias() << " cache is up to date with metadata." << endl;
         if ( policy == BuildIfNeeded )
@@ -1310,27 +1366,20 @@ namespace zypp
 	  if ( ! PathInfo(base/"solv.idx").isExist() )
 	    sat::updateSolvFileIndex( base/"solv" );
 
-	  return;
+	  return false;
         }
         else {
           MIL << info.alias() << " cache rebuild is forced" << endl;
         }
       }
 
-      needs_cleaning = true;
-    }
-
-    ProgressData progress(100);
-    callback::SendReport<ProgressReport> report;
-    progress.sendTo( ProgressReportAdaptor( progressrcv, report ) );
-    progress.name(str::form(_("Building repository '%s' cache"), info.label().c_str()));
-    progress.toMin();
-
-    if (needs_cleaning)
-    {
       cleanCache(info);
     }
+    return true;
+  }
 
+  repo::RepoType RepoManager::Impl::prepareCacheBuild( const RepoInfo & info )
+  {
     MIL << info.alias() << " building cache..." << info.type() << endl;
 
     Pathname base = solv_path_for_repoinfo( _options, info);
@@ -1346,7 +1395,6 @@ namespace zypp
       Exception ex(str::form( _("Can't create cache at %s - no writing permissions."), base.c_str()) );
       ZYPP_THROW(ex);
     }
-    Pathname solvfile = base / "solv";
 
     // do we have type?
     repo::RepoType repokind = info.type();
@@ -1356,13 +1404,20 @@ namespace zypp
     {
       case RepoType::NONE_e:
         // unknown, probe the local metadata
-        repokind = probeCache( productdatapath );
+        repokind = probeCache( rawproductdata_path_for_repoinfo( _options, info ) );
       break;
       default:
       break;
     }
 
     MIL << "repo type is " << repokind << endl;
+    return repokind;
+  }
+
+  void RepoManager::Impl::buildSolvFile( const RepoInfo & info, const repo::RepoType & repokind, bool tryInProcess )
+  {
+    Pathname productdatapath = rawproductdata_path_for_repoinfo( _options, info );
+    Pathname solvfile = solv_path_for_repoinfo( _options, info ) / "solv";
 
     switch ( repokind.toEnum() )
     {
@@ -1372,8 +1427,26 @@ namespace zypp
       {
         // Take care we unlink the solvfile on exception
         ManagedFile guard( solvfile, filesystem::unlink );
-        scoped_ptr<MediaMounter> forPlainDirs;
 
+        // Prefer building the solv file in-process, repo2solv is the fallback.
+        SolvCacheBuilder builder( repokind, productdatapath );
+        if ( tryInProcess && builder.supports() )
+        {
+          try
+          {
+            builder.build( solvfile );	// creates solv.idx as well
+            // We keep it.
+            guard.resetDispose();
+            break;
+          }
+          catch ( const Exception & excpt )
+          {
+            ZYPP_CAUGHT( excpt );
+            WAR << info.alias() << ": in-process solv build failed; falling back to repo2solv." << endl;
+          }
+        }
+
+        scoped_ptr<MediaMounter> forPlainDirs;
         ExternalProgram::Arguments cmd;
         cmd.push_back( PathInfo( "/usr/bin/repo2solv" ).isFile() ? "repo2solv" : "repo2solv.sh" );
         // repo2solv expects -o as 1st arg!
@@ -1422,6 +1495,22 @@ namespace zypp
         ZYPP_THROW(RepoUnknownTypeException( info, _("Unhandled repository type") ));
       break;
     }
+  }
+
+  void RepoManager::Impl::buildCache( const RepoInfo & info, CacheBuildPolicy policy, const ProgressData::ReceiverFnc & progressrcv )
+  {
+    RepoStatus raw_metadata_status;
+    if ( ! cacheNeedsRebuild( info, policy, raw_metadata_status, progressrcv ) )
+      return;
+
+    ProgressData progress(100);
+    callback::SendReport<ProgressReport> report;
+    progress.sendTo( ProgressReportAdaptor( progressrcv, report ) );
+    progress.name(str::form(_("Building repository '%s' cache"), info.label().c_str()));
+    progress.toMin();
+
+    buildSolvFile( info, prepareCacheBuild( info ) );
+
     // update timestamp and checksum
     setCacheStatus(info, raw_metadata_status);
     MIL << "Commit cache.." << endl;
@@ -1430,6 +1519,300 @@ namespace zypp
 
   ////////////////////////////////////////////////////////////////////////////
 
+  /** Download the metadata files of many rpm-md repos concurrently into a
+   * staging dir (a subdir per repo), where \ref refreshMetadata finds them
+   * by checksum. Each repos baseurls are tried in order for its repomd.xml.
+   *
+   * This is just a head start: The repomd.xml is downloaded and verified
+   * again by \ref refreshMetadata, which also does anything failing here.
+   */
+  filesystem::TmpPath RepoManager::Impl::prefetchMetadata( const std::vector<RepoInfo> & infos, RawMetadataRefreshPolicy policy )
+  {
+    filesystem::TmpPath ret;
+    const long parallel = ZConfig::instance().download_max_concurrent_connections();
+    if ( parallel < 2 || infos.size() < 2 )
+      return ret;
+
+    // A repo to prefetch and its downloading baseurls.
+    struct Job
+    {
+      RepoInfo info;
+      std::vector<Url> urls;
+      std::vector<media::TransferSettings> settings;
+      size_t current = 0;
+      Pathname stage;
+    };
+    std::list<Job> jobs;
+
+    media::CredentialManager cm( media::CredManagerOptions( ZConfig::instance().repoManagerRoot() ) );
+    for ( const RepoInfo & info : infos )
+    {
+      if ( info.type() != RepoType::RPMMD )
+        continue;	// not yet probed or nothing to gain
+      if ( policy == RefreshIfNeeded )
+      {
+        // like checkIfToRefreshMetadata: not checked within repo.refresh.delay
+        RepoStatus oldstatus( metadataStatus( info ) );
+        if ( ! oldstatus.empty()
+             && ::difftime( (Date::ValueType)Date::now(), (Date::ValueType)oldstatus.timestamp() ) / 60 < ZConfig::instance().repo_refresh_delay() )
+          continue;
+      }
+
+      Job job;
+      job.info = info;
+      for_( it, info.baseUrlsBegin(), info.baseUrlsEnd() )
+      {
+        if ( ! it->schemeIsDownloading() )
+          continue;
+        media::TransferSettings settings;
+        try
+        {
+          internal::fillSettingsFromUrl( *it, settings );
+          if ( settings.proxy().empty() )
+            internal::fillSettingsSystemProxy( *it, settings );
+        }
+        catch ( const media::MediaException & excpt )
+        {
+          ZYPP_CAUGHT( excpt );
+          continue;
+        }
+        if ( settings.userPassword().empty() )
+        {
+          media::AuthData_Ptr cred( cm.getCred( *it ) );
+          if ( cred && cred->valid() )
+          {
+            settings.setUsername( cred->username() );
+            settings.setPassword( cred->password() );
+          }
+        }
+        job.urls.push_back( internal::clearQueryString( *it ) );
+        job.settings.push_back( std::move(settings) );
+      }
+      if ( ! job.urls.empty() )
+        jobs.push_back( std::move(job) );
+    }
+    if ( jobs.size() < 2 )
+      return ret;	// refreshMetadata downloads a single repos files concurrently anyway
+
+    if ( filesystem::assert_dir( _options.repoRawCachePath ) == 0 )
+      ret = filesystem::TmpDir( _options.repoRawCachePath, ".prefetch." );	// hardlinks into the raw cache
+    if ( ! ret )
+      return ret;
+    MIL << "Prefetching the metadata of " << jobs.size() << " repos into " << ret.path() << endl;
+
+    std::shared_ptr<zyppng::EventDispatcher> ev( zyppng::EventDispatcher::instance() );
+    if ( ! ev )
+      ev = zyppng::EventDispatcher::createMain();
+
+    zyppng::Downloader downloader;
+    downloader.requestDispatcher()->setMaximumConcurrentConnections( parallel );
+
+    std::vector<zyppng::Download::Ptr> downloads;
+    std::vector<sigc::connection> connections;
+    size_t running = 0;
+    unsigned fetched = 0;
+
+    // Start downloading file_r from the jobs current url.
+    auto startDownload = [&]( Job & job_r, const OnMediaLocation & loc_r, std::function<void(Job &, bool)> done_r ) {
+      const Pathname target( job_r.stage / loc_r.filename() );
+      if ( filesystem::assert_dir( target.dirname() ) != 0 )
+        return;
+      Url url( job_r.urls[job_r.current] );
+      url.appendPathName( loc_r.filename() );
+      zyppng::Download::Ptr dl( downloader.downloadFile( url, target, loc_r.downloadSize() ) );
+      dl->settings() = job_r.settings[job_r.current];
+      connections.push_back( dl->sigFinished().connect( [&,jobp=&job_r,done_r]( zyppng::Download & dl_r ) {
+        bool success = ( dl_r.state() == zyppng::Download::Success );
+        if ( ! success )
+          DBG << "Prefetching " << dl_r.url() << " failed: " << dl_r.errorString() << endl;
+        done_r( *jobp, success );
+        if ( --running == 0 )
+          ev->quit();
+      } ) );
+      ++running;
+      dl->start();
+      downloads.push_back( std::move(dl) );
+    };
+
+    // A data file is done.
+    auto dataDone = [&]( Job &, bool success_r ) {
+      if ( success_r )
+        ++fetched;
+    };
+
+    // The repomd.xml is done: Get the files we don't have or try the next url.
+    std::function<void(Job &, bool)> repomdDone;
+    repomdDone = [&]( Job & job_r, bool success_r ) {
+      const OnMediaLocation repomd( job_r.info.path() / "repodata/repomd.xml" );
+      if ( ! success_r )
+      {
+        if ( ++job_r.current < job_r.urls.size() )
+          startDownload( job_r, repomd, repomdDone );
+        return;
+      }
+      std::vector<OnMediaLocation> files;
+      try
+      {
+        files = yum::Downloader::wantedFiles( job_r.info, job_r.stage / repomd.filename() );
+      }
+      catch ( const Exception & excpt )
+      {
+        ZYPP_CAUGHT( excpt );
+        return;
+      }
+      const Pathname rawcache( rawcache_path_for_repoinfo( _options, job_r.info ) );
+      for ( const OnMediaLocation & loc : files )
+      {
+        // The filenames contain the checksum. Zchunk files are downloaded
+        // as delta to the old ones by refreshMetadata.
+        if ( loc.checksum().empty() || str::endsWith( loc.filename().basename(), ".zck" ) || PathInfo( rawcache / loc.filename() ).isExist() )
+          continue;
+        startDownload( job_r, loc, dataDone );
+      }
+    };
+
+    for ( Job & job : jobs )
+    {
+      job.stage = ret.path() / job.info.escaped_alias();
+      startDownload( job, OnMediaLocation( job.info.path() / "repodata/repomd.xml" ), repomdDone );
+    }
+    if ( running )
+      ev->run();
+
+    // no more callbacks into this scope
+    for ( sigc::connection & conn : connections )
+      conn.disconnect();
+    downloads.clear();
+
+    MIL << "Prefetched " << fetched << " metadata files" << endl;
+    return ret;
+  }
+
+  RepoManager::RefreshErrors RepoManager::Impl::refreshRepositories( const std::vector<RepoInfo> & infos, RawMetadataRefreshPolicy policy, unsigned concurrency, const ProgressData::ReceiverFnc & progressrcv )
+  {
+    MIL << "Refreshing " << infos.size() << " repos (concurrency " << concurrency << ")" << endl;
+    RefreshErrors errors;
+
+    // The metadata files of all repos are downloaded concurrently first.
+    filesystem::TmpPath prefetched( prefetchMetadata( infos, policy ) );
+
+    // One tick for each download and each cache build.
+    ProgressData progress( infos.size() * 2 );
+    callback::SendReport<ProgressReport> report;
+    progress.sendTo( ProgressReportAdaptor( progressrcv, report ) );
+    progress.name( _("Refreshing repositories") );
+    progress.toMin();
+
+    // A solv file currently built by a worker.
+    struct PendingBuild
+    {
+      RepoInfo info;
+      RepoType repokind;
+      RepoStatus raw_metadata_status;
+      std::future<void> result;
+    };
+    std::list<PendingBuild> pending;
+
+    // Completes finished builds (all of them if wait_r) in the main thread.
+    // A failed in-process build retries with repo2solv, like buildCache does.
+    auto collect = [&]( bool wait_r ) {
+      for ( auto it = pending.begin(); it != pending.end(); )
+      {
+        if ( ! wait_r && it->result.wait_for( std::chrono::seconds(0) ) != std::future_status::ready )
+        {
+          ++it;
+          continue;
+        }
+        try
+        {
+          try
+          {
+            it->result.get();
+          }
+          catch ( const Exception & excpt )
+          {
+            ZYPP_CAUGHT( excpt );
+            WAR << it->info.alias() << ": in-process solv build failed; falling back to repo2solv." << endl;
+            buildSolvFile( it->info, it->repokind, false );
+          }
+          setCacheStatus( it->info, it->raw_metadata_status );
+          MIL << "Commit cache " << it->info.alias() << endl;
+        }
+        catch ( const Exception & excpt )
+        {
+          ZYPP_CAUGHT( excpt );
+          errors[it->info.alias()] = excpt;
+        }
+        catch ( const std::exception & excpt )
+        {
+          ZYPP_CAUGHT( excpt );
+          errors[it->info.alias()] = Exception( excpt.what() );
+        }
+        progress.incr();
+        it = pending.erase( it );
+      }
+    };
+
+    {
+      // The remaining downloads and the signature checks stay in this thread (media
+      // handlers and keyring callbacks are not thread-safe), but overlap with the
+      // solv builds of the previous repos.
+      WorkerPool workers( concurrency );
+      for ( const RepoInfo & info : infos )
+      {
+        try
+        {
+          refreshMetadata( info, policy, prefetched ? prefetched.path() / info.escaped_alias() : Pathname() );
+          progress.incr();
+
+          RepoStatus raw_metadata_status;
+          if ( cacheNeedsRebuild( info, BuildIfNeeded, raw_metadata_status ) )
+          {
+            RepoType repokind( prepareCacheBuild( info ) );
+            SolvCacheBuilder builder( repokind, rawproductdata_path_for_repoinfo( _options, info ) );
+            if ( builder.supports() )
+            {
+              Pathname solvfile( solv_path_for_repoinfo( _options, info ) / "solv" );
+              pending.push_back( { info, repokind, raw_metadata_status,
+                                   workers.submit( [builder,solvfile]() { builder.build( solvfile ); } ) } );
+            }
+            else
+            {
+              // e.g. plaindir needs the media backend to mount the repo
+              buildSolvFile( info, repokind, false );
+              setCacheStatus( info, raw_metadata_status );
+              progress.incr();
+            }
+          }
+          else
+            progress.incr();
+        }
+        catch ( const Exception & excpt )
+        {
+          ZYPP_CAUGHT( excpt );
+          errors[info.alias()] = excpt;
+          progress.incr();
+          progress.incr();
+        }
+        catch ( const std::exception & excpt )
+        {
+          ZYPP_CAUGHT( excpt );
+          errors[info.alias()] = Exception( excpt.what() );
+          progress.incr();
+          progress.incr();
+        }
+        collect( false );
+      }
+      collect( true );
+    }
+
+    progress.toMax();
+    MIL << "Refreshed " << infos.size() << " repos, " << errors.size() << " failed." << endl;
+    return errors;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+
 
   /** Probe the metadata type of a repository located at \c url.
    * Urls here may be rewritten by \ref MediaSetAccess to reflect the correct media number.
@@ -2612,6 +2995,9 @@ namespace zypp
   void RepoManager::buildCache( const RepoInfo &info, CacheBuildPolicy policy, const ProgressData::ReceiverFnc & progressrcv )
   { return _pimpl->buildCache( info, policy, progressrcv ); }
 
+  RepoManager::RefreshErrors RepoManager::refreshRepositories( const std::vector<RepoInfo> & infos, RawMetadataRefreshPolicy policy, unsigned concurrency, const ProgressData::ReceiverFnc & progressrcv )
+  { return _pimpl->refreshRepositories( infos, policy, concurrency, progressrcv ); }
+
   void RepoManager::cleanCache( const RepoInfo &info, const ProgressData::ReceiverFnc & progressrcv )
   { return _pimpl->cleanCache( info, progressrcv ); }
 
@@ -14,6 +14,8 @@
 
 #include <iosfwd>
 #include <list>
+#include <map>
+#include <vector>
 
 #include <zypp/base/PtrTypes.h>
 #include <zypp/base/Iterator.h>
@@ -120,6 +122,9 @@ namespace zypp
     typedef RepoSet::const_iterator RepoConstIterator;
     typedef RepoSet::size_type RepoSizeType;
 
+    /** Errors collected by \ref refreshRepositories (repo alias and the exception). */
+    typedef std::map<std::string,Exception> RefreshErrors;
+
   public:
    RepoManager( const RepoManagerOptions &options = RepoManagerOptions() );
    /** Dtor */
@@ -301,6 +306,32 @@ namespace zypp
                          RawMetadataRefreshPolicy policy = RefreshIfNeeded,
                          const ProgressData::ReceiverFnc & progressrcv = ProgressData::ReceiverFnc() );
 
+   /**
+    * \short Refresh local raw caches and build the solv caches of many repos.
+    *
+    * Per repo \ref refreshMetadata (according to \a policy) and
+    * \ref buildCache (\ref BuildIfNeeded) are performed. The metadata
+    * files of all rpm-md repos are first downloaded concurrently (up to
+    * \c download.max_concurrent_connections). The signature checks and
+    * what's left to download are done one after another in the calling
+    * thread, while up to \a concurrency solv files (\c 0 means one per CPU)
+    * are built in parallel on worker threads. Each repos raw cache is still
+    * replaced atomically.
+    *
+    * A failing repo does not stop the batch. Its exception is collected in
+    * the returned \ref RefreshErrors, which is empty if all repos succeeded.
+    *
+    * \code
+    *   RepoManager::RefreshErrors errors( repoManager.refreshRepositories( repos ) );
+    *   for ( const auto & err : errors )
+    *     ERR << err.first << ": " << err.second.asUserHistory() << endl;
+    * \endcode
+    */
+   RefreshErrors refreshRepositories( const std::vector<RepoInfo> & infos,
+                                      RawMetadataRefreshPolicy policy = RefreshIfNeeded,
+                                      unsigned concurrency = 0,
+                                      const ProgressData::ReceiverFnc & progressrcv = ProgressData::ReceiverFnc() );
+
    /**
     * \short Clean local metadata
     *
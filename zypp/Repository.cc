@@ -328,7 +328,7 @@ namespace zypp
         ZYPP_THROW( Exception( "Can't open solv-file: "+file_r.asString() ) );
       }
 
-      if ( myPool()._addSolv( _repo, file ) != 0 )
+      if ( myPool()._addSolv( _repo, file, file_r ) != 0 )
       {
         ZYPP_THROW( Exception( "Error reading solv-file: "+file_r.asString() ) );
       }
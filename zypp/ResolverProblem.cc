@@ -21,6 +21,8 @@
  * 02111-1307, USA.
  */
 
+#include <mutex>
+
 #include <zypp/base/LogTools.h>
 
 #include <zypp/ResolverProblem.h>
@@ -81,6 +83,17 @@ namespace zypp
     ProblemSolutionList	_solutions;
     std::vector<std::string> _completeProblemInfo;
 
+    /** Texts formatted on demand, shared by all copies. */
+    struct Formatted
+    {
+      std::once_flag _once;
+      TextFormatter _formatter;
+      std::string _description;
+      std::string _details;
+      std::vector<std::string> _completeProblemInfo;
+    };
+    std::shared_ptr<Formatted> _formatted;
+
   private:
     friend Impl * rwcowClone<Impl>( const Impl * rhs );
     /** clone for RWCOW_pointer */
@@ -105,27 +118,61 @@ namespace zypp
       : _pimpl( new Impl( std::move(description), std::move(details), std::move(completeProblemInfo) ) )
   {}
 
+  ResolverProblem::ResolverProblem( TextFormatter formatter_r )
+  : _pimpl( new Impl() )
+  {
+    _pimpl->_formatted = std::make_shared<Impl::Formatted>();
+    _pimpl->_formatted->_formatter = std::move(formatter_r);
+  }
+
   ResolverProblem::~ResolverProblem()
   {}
 
+  bool ResolverProblem::formatted() const
+  {
+    // The Impl itself is not written, as it may be shared with other copies.
+    const std::shared_ptr<Impl::Formatted> & formatted( _pimpl->_formatted );
+    if ( ! formatted )
+      return false;
+    std::call_once( formatted->_once, [&formatted]() {
+      formatted->_formatter( formatted->_description, formatted->_details, formatted->_completeProblemInfo );
+      formatted->_formatter = TextFormatter();
+    } );
+    return true;
+  }
+
+  void ResolverProblem::detachFormatted()
+  {
+    if ( formatted() )
+    {
+      Impl & impl( *_pimpl );	// RWCOW: our own copy
+      impl._description = impl._formatted->_description;
+      impl._details = impl._formatted->_details;
+      impl._completeProblemInfo = impl._formatted->_completeProblemInfo;
+      impl._formatted.reset();
+    }
+  }
 
   const std::string & ResolverProblem::description() const
-  { return _pimpl->_description; }
+  { return formatted() ? _pimpl->_formatted->_description : _pimpl->_description; }
 
   const std::string & ResolverProblem::details() const
-  { return _pimpl->_details; }
+  { return formatted() ? _pimpl->_formatted->_details : _pimpl->_details; }
 
   const ProblemSolutionList & ResolverProblem::solutions() const
   { return _pimpl->_solutions; }
 
   const std::vector<std::string> & ResolverProblem::completeProblemInfo() const
-  { return _pimpl->_completeProblemInfo; }
+  { return formatted() ? _pimpl->_formatted->_completeProblemInfo : _pimpl->_completeProblemInfo; }
 
   void ResolverProblem::setDescription( std::string description )
-  { _pimpl->_description = std::move(description); }
+  { detachFormatted(); _pimpl->_description = std::move(description); }
 
   void ResolverProblem::setDetails( std::string details )
-  { _pimpl->_details = std::move(details); }
+  { detachFormatted(); _pimpl->_details = std::move(details); }
+
+  void ResolverProblem::setCompleteProblemInfo( std::vector<std::string> completeProblemInfo )
+  { detachFormatted(); _pimpl->_completeProblemInfo = std::move(completeProblemInfo); }
 
   void ResolverProblem::addSolution( ProblemSolution_Ptr solution, bool inFront )
   {
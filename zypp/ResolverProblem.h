@@ -9,6 +9,7 @@
 #ifndef ZYPP_RESOLVERPROBLEM_H
 #define ZYPP_RESOLVERPROBLEM_H
 
+#include <functional>
 #include <list>
 #include <string>
 #include <vector>
@@ -35,6 +36,19 @@ namespace zypp
     /** Constructor. */
     ResolverProblem( std::string description, std::string details, std::vector<std::string> &&completeProblemInfo );
 
+    /** Function formatting description, details and completeProblemInfo. */
+    typedef std::function<void( std::string & description_r, std::string & details_r, std::vector<std::string> & completeProblemInfo_r )> TextFormatter;
+
+    /** Constructor taking a function to format the problems texts on demand.
+     * \a formatter_r is called once, when one of the texts is accessed for
+     * the 1st time. Copies of the problem share the result. Solutions are
+     * not formatted on demand, they are to be added via \ref addSolution.
+     *
+     * The texts are formatted at most once, even if copies of the problem
+     * are accessed from different threads concurrently.
+     */
+    ResolverProblem( TextFormatter formatter_r );
+
     /** Destructor. */
     ~ResolverProblem();
 
@@ -82,12 +96,23 @@ namespace zypp
      **/
     void setDetails( std::string details );
 
+    /**
+     * Set the one-line descriptions of the problematic rules.
+     **/
+    void setCompleteProblemInfo( std::vector<std::string> completeProblemInfo );
+
     /**
      * Add a solution to this problem. This class takes over ownership of
      * the problem and will delete it when neccessary.
      **/
     void addSolution( ProblemSolution_Ptr solution, bool inFront = false );
 
+  private:
+    /** Format the texts if pending. Whether the texts are taken from the formatter. */
+    bool formatted() const;
+    /** Take over formatted texts before modifying them. */
+    void detachFormatted();
+
   private:
     struct Impl;
     RWCOW_pointer<Impl> _pimpl;
@@ -319,17 +319,23 @@ namespace zypp
         , updateMessagesNotify		( "" )
         , repo_add_probe          	( false )
         , repo_refresh_delay      	( 10 )
+        , repo_refresh_race_urls	( 0 )
+        , repo_cache_fileprovides	( false )
         , repoLabelIsAlias              ( false )
         , download_use_deltarpm   	( true )
         , download_use_deltarpm_always  ( false )
         , download_media_prefer_download( true )
 	, download_mediaMountdir	( "/var/adm/mount" )
         , download_max_concurrent_connections( 5 )
+        , download_max_concurrent_streams( 10 )
+        , download_prefetch_files	( false )
         , download_min_download_speed	( 0 )
         , download_max_download_speed	( 0 )
         , download_max_silent_tries	( 5 )
         , download_transfer_timeout	( 180 )
         , commit_downloadMode		( DownloadDefault )
+        , commit_parallelDownloads	( 5 )
+        , commit_singleRpmTransaction	( false )
 	, gpgCheck			( true )
 	, repoGpgCheck			( indeterminate )
 	, pkgGpgCheck			( indeterminate )
@@ -343,6 +349,7 @@ namespace zypp
         , solver_cleandepsOnRemove	( false )
         , solver_upgradeTestcasesToKeep	( 2 )
         , solverUpgradeRemoveDroppedPackages( true )
+        , solver_reuseSolver		( false )
         , apply_locks_file		( true )
         , pluginsPath			( "/usr/lib/zypp/plugins" )
       {
@@ -429,6 +436,14 @@ namespace zypp
                 {
                   str::strtonum(value, repo_refresh_delay);
                 }
+                else if ( entry == "repo.refresh.race_urls" )
+                {
+                  str::strtonum(value, repo_refresh_race_urls);
+                }
+                else if ( entry == "repo.cache.fileprovides" )
+                {
+                  repo_cache_fileprovides = str::strToBool( value, repo_cache_fileprovides );
+                }
                 else if ( entry == "repo.refresh.locales" )
 		{
 		  std::vector<std::string> tmp;
@@ -462,6 +477,14 @@ namespace zypp
                 {
                   str::strtonum(value, download_max_concurrent_connections);
                 }
+                else if ( entry == "download.max_concurrent_streams" )
+                {
+                  str::strtonum(value, download_max_concurrent_streams);
+                }
+                else if ( entry == "download.prefetch_files" )
+                {
+                  download_prefetch_files.restoreToDefault( str::strToBool( value, false ) );
+                }
                 else if ( entry == "download.min_download_speed" )
                 {
                   str::strtonum(value, download_min_download_speed);
@@ -484,6 +507,14 @@ namespace zypp
                 {
                   commit_downloadMode.set( deserializeDownloadMode( value ) );
                 }
+                else if ( entry == "commit.parallelDownloads" )
+                {
+                  str::strtonum(value, commit_parallelDownloads);
+                }
+                else if ( entry == "commit.singleRpmTransaction" )
+                {
+                  commit_singleRpmTransaction = str::strToBool( value, commit_singleRpmTransaction );
+                }
                 else if ( entry == "gpgcheck" )
 		{
 		  gpgCheck.restoreToDefault( str::strToBool( value, gpgCheck ) );
@@ -548,6 +579,10 @@ namespace zypp
                 {
                   solverUpgradeRemoveDroppedPackages.restoreToDefault( str::strToBool( value, solverUpgradeRemoveDroppedPackages.getDefault() ) );
                 }
+                else if ( entry == "solver.reuseSolver" )
+                {
+                  solver_reuseSolver = str::strToBool( value, solver_reuseSolver );
+                }
                 else if ( entry == "solver.checkSystemFile" )
                 {
                   solver_checkSystemFile = Pathname(value);
@@ -660,6 +695,8 @@ namespace zypp
 
     bool	repo_add_probe;
     unsigned	repo_refresh_delay;
+    unsigned	repo_refresh_race_urls;
+    bool	repo_cache_fileprovides;
     LocaleSet	repoRefreshLocales;
     bool	repoLabelIsAlias;
 
@@ -669,12 +706,16 @@ namespace zypp
     DefaultOption<Pathname> download_mediaMountdir;
 
     int download_max_concurrent_connections;
+    int download_max_concurrent_streams;
+    DefaultOption<bool> download_prefetch_files;
     int download_min_download_speed;
     int download_max_download_speed;
     int download_max_silent_tries;
     int download_transfer_timeout;
 
     Option<DownloadMode> commit_downloadMode;
+    unsigned		commit_parallelDownloads;
+    bool		commit_singleRpmTransaction;
 
     DefaultOption<bool>		gpgCheck;
     DefaultOption<TriBool>	repoGpgCheck;
@@ -690,6 +731,7 @@ namespace zypp
     Option<bool>	solver_cleandepsOnRemove;
     Option<unsigned>	solver_upgradeTestcasesToKeep;
     DefaultOption<bool> solverUpgradeRemoveDroppedPackages;
+    bool		solver_reuseSolver;
 
     Pathname solver_checkSystemFile;
     Pathname solver_checkSystemFileDir;
@@ -1031,6 +1073,12 @@ namespace zypp
   unsigned ZConfig::repo_refresh_delay() const
   { return _pimpl->repo_refresh_delay; }
 
+  unsigned ZConfig::repo_refresh_race_urls() const
+  { return _pimpl->repo_refresh_race_urls; }
+
+  bool ZConfig::repo_cache_fileprovides() const
+  { return _pimpl->repo_cache_fileprovides; }
+
   LocaleSet ZConfig::repoRefreshLocales() const
   { return _pimpl->repoRefreshLocales.empty() ? Target::requestedLocales("") :_pimpl->repoRefreshLocales; }
 
@@ -1058,6 +1106,18 @@ namespace zypp
   long ZConfig::download_max_concurrent_connections() const
   { return _pimpl->download_max_concurrent_connections; }
 
+  long ZConfig::download_max_concurrent_streams() const
+  { return _pimpl->download_max_concurrent_streams; }
+
+  bool ZConfig::download_prefetch_files() const
+  { return _pimpl->download_prefetch_files; }
+
+  void ZConfig::set_download_prefetch_files( bool yesno_r )
+  { _pimpl->download_prefetch_files.set( yesno_r ); }
+
+  void ZConfig::set_default_download_prefetch_files()
+  { _pimpl->download_prefetch_files.restoreToDefault(); }
+
   long ZConfig::download_min_download_speed() const
   { return _pimpl->download_min_download_speed; }
 
@@ -1077,6 +1137,12 @@ namespace zypp
   DownloadMode ZConfig::commit_downloadMode() const
   { return _pimpl->commit_downloadMode; }
 
+  unsigned ZConfig::commit_parallelDownloads() const
+  { return _pimpl->commit_parallelDownloads; }
+
+  bool ZConfig::commit_singleRpmTransaction() const
+  { return _pimpl->commit_singleRpmTransaction; }
+
 
   bool ZConfig::gpgCheck() const			{ return _pimpl->gpgCheck; }
   TriBool ZConfig::repoGpgCheck() const			{ return _pimpl->repoGpgCheck; }
@@ -1117,6 +1183,9 @@ namespace zypp
   unsigned ZConfig::solver_upgradeTestcasesToKeep() const
   { return _pimpl->solver_upgradeTestcasesToKeep; }
 
+  bool ZConfig::solver_reuseSolver() const
+  { return _pimpl->solver_reuseSolver; }
+
   bool ZConfig::solverUpgradeRemoveDroppedPackages() const		{ return _pimpl->solverUpgradeRemoveDroppedPackages; }
   void ZConfig::setSolverUpgradeRemoveDroppedPackages( bool val_r )	{ _pimpl->solverUpgradeRemoveDroppedPackages.set( val_r ); }
   void ZConfig::resetSolverUpgradeRemoveDroppedPackages()		{ _pimpl->solverUpgradeRemoveDroppedPackages.restoreToDefault(); }
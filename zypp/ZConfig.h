@@ -240,6 +240,21 @@ namespace zypp
        */
       unsigned repo_refresh_delay() const;
 
+      /**
+       * Number of base URLs probed at the same time when refreshing a repo.
+       * The fastest responding URL is used first. \c 0 or \c 1 disable the race.
+       * Config option <tt>repo.refresh.race_urls (0)</tt>
+       */
+      unsigned repo_refresh_race_urls() const;
+
+      /**
+       * Whether the file provides computed when preparing the pool are
+       * remembered next to the repos solv file, so the next process can
+       * skip scanning the filelists.
+       * Config option <tt>repo.cache.fileprovides (false)</tt>
+       */
+      bool repo_cache_fileprovides() const;
+
       /**
        * List of locales for which translated package descriptions should be downloaded.
        */
@@ -266,6 +281,28 @@ namespace zypp
        */
       long download_max_concurrent_connections() const;
 
+      /**
+       * Maximum number of transfers multiplexed over a single HTTP/2 connection
+       * (\c 0 or \c 1 disables multiplexing).
+       * Config option <tt>download.max_concurrent_streams (10)</tt>
+       */
+      long download_max_concurrent_streams() const;
+
+      /**
+       * Whether \ref Fetcher downloads the files with a known checksum
+       * concurrently before providing them.
+       * Config option <tt>download.prefetch_files (false)</tt>
+       */
+      bool download_prefetch_files() const;
+      /**
+       * Set \ref download_prefetch_files to a specific value.
+       */
+      void set_download_prefetch_files( bool yesno_r );
+      /**
+       * Set \ref download_prefetch_files to the configfiles default.
+       */
+      void set_default_download_prefetch_files();
+
       /**
        * Minimum download speed (bytes per second)
        * until the connection is dropped
@@ -331,6 +368,21 @@ namespace zypp
        */
       DownloadMode commit_downloadMode() const;
 
+      /**
+       * Number of packages downloaded in parallel before a commit
+       * (\ref DownloadInAdvance and \ref DownloadInHeaps only).
+       * \c 0 or \c 1 download the packages one by one.
+       * Config option <tt>commit.parallelDownloads (5)</tt>
+       */
+      unsigned commit_parallelDownloads() const;
+
+      /**
+       * Whether to install and remove the packages of a commit in a single
+       * in-process rpm transaction rather than running rpm once per package.
+       * Config option <tt>commit.singleRpmTransaction (false)</tt>
+       */
+      bool commit_singleRpmTransaction() const;
+
       /** \name Signature checking (repodata and packages)
        * If \ref gpgcheck is \c on (the default) we will either check the signature
        * of repo metadata (packages are secured via checksum in the metadata), or the
@@ -417,6 +469,15 @@ namespace zypp
        */
       unsigned solver_upgradeTestcasesToKeep() const;
 
+      /**
+       * Whether the resolver keeps its SAT solver across solver runs.
+       * As long as the pools content and dependencies are unchanged, the
+       * package rules of the previous run are reused and only the jobs
+       * are rebuilt.
+       * Config option <tt>solver.reuseSolver (false)</tt>
+       */
+      bool solver_reuseSolver() const;
+
       /** Whether dist upgrade should remove a products dropped packages (true).
        *
        * A new product may suggest a list of old and no longer supported
@@ -19,6 +19,10 @@
   #include <zypp/base/ZckStream.h>
 #endif
 
+#ifdef ENABLE_ZSTD_COMPRESSION
+  #include <zypp/base/ZstdStream.h>
+#endif
+
 #include <zypp/PathInfo.h>
 
 using std::endl;
@@ -41,11 +45,17 @@ namespace zypp
 
     inline shared_ptr<std::istream> streamForFile ( const Pathname & file_r )
     {
+      [[maybe_unused]] const auto zType = filesystem::zipType( file_r );
 #ifdef ENABLE_ZCHUNK_COMPRESSION
-      if ( const auto zType = filesystem::zipType( file_r ); zType == filesystem::ZT_ZCHNK )
+      if ( zType == filesystem::ZT_ZCHNK )
         return shared_ptr<std::istream>( new ifzckstream( file_r.asString().c_str() ) );
 #endif
 
+#ifdef ENABLE_ZSTD_COMPRESSION
+      if ( zType == filesystem::ZT_ZSTD )
+        return shared_ptr<std::istream>( new ifzstdstream( file_r.asString().c_str() ) );
+#endif
+
       //fall back to gzstream
       return shared_ptr<std::istream>( new ifgzstream( file_r.asString().c_str() ) );
     }
@@ -9,9 +9,21 @@
 /** \file	zypp/base/LogControl.cc
  *
 */
+#include <pthread.h>
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <zypp/base/Logger.h>
 #include <zypp/base/LogControl.h>
@@ -163,6 +175,20 @@ namespace zypp
                              const char * file_r, const char * func_r, int line_r,
                              const std::string & buffer_r );
 
+      /** Interned group names.
+       * The returned string lives until the end of the process, so queued
+       * lines may refer to it, and its address identifies the group.
+       */
+      std::mutex & internMutex()
+      { static auto * _mutex = new std::mutex; return *_mutex; }
+
+      const std::string & internGroup( const char * group_r )
+      {
+        static auto * _groups = new std::unordered_set<std::string>;	// never released, statics log from their dtor
+        std::lock_guard<std::mutex> guard( internMutex() );
+        return *_groups->insert( group_r ).first;
+      }
+
       ///////////////////////////////////////////////////////////////////
       //
       //	CLASS NAME : Loglinebuf
@@ -233,7 +259,7 @@ namespace zypp
         }
 
       private:
-        std::string  _group;
+        const std::string & _group;	// interned
         LogLevel     _level;
         const char * _file;
         const char * _func;
@@ -273,6 +299,60 @@ namespace zypp
       };
       ///////////////////////////////////////////////////////////////////
 
+      ///////////////////////////////////////////////////////////////////
+      //
+      //	CLASS NAME : LogRing
+      //
+      /** Lines queued by a thread in async mode.
+       * A single producer (the owning thread), single consumer (whoever
+       * holds the \c _putStreamMutex) ring buffer.
+       */
+      struct LogRing
+      {
+        struct Entry
+        {
+          const std::string * _group = nullptr;	// interned
+          LogLevel            _level = E_DBG;
+          const char *        _file = "";
+          const char *        _func = "";
+          int                 _line = 0;
+          std::string         _message;
+          unsigned long       _seq = 0;		// global order
+        };
+        static constexpr size_t _size = 1024;
+
+        /** Producer: Returns \c false if full. */
+        bool push( Entry & entry_r )
+        {
+          size_t tail = _tail.load( std::memory_order_relaxed );
+          if ( tail - _head.load( std::memory_order_acquire ) == _size )
+            return false;
+          _entries[tail % _size] = std::move(entry_r);
+          _tail.store( tail + 1, std::memory_order_release );
+          return true;
+        }
+
+        size_t size() const
+        { return _tail.load( std::memory_order_acquire ) - _head.load( std::memory_order_acquire ); }
+
+        /** Consumer: Pass the queued entries to \a fnc_r. */
+        template <class TFnc>
+        void drain( TFnc && fnc_r )
+        {
+          size_t head = _head.load( std::memory_order_relaxed );
+          size_t tail = _tail.load( std::memory_order_acquire );
+          for ( ; head != tail; ++head )
+            fnc_r( std::move(_entries[head % _size]) );
+          _head.store( head, std::memory_order_release );
+        }
+
+        std::array<Entry,_size> _entries;
+        std::atomic<size_t> _head { 0 };	// next to read
+        std::atomic<size_t> _tail { 0 };	// next to write
+        std::atomic<bool>   _orphaned { false };	// the owning thread is gone
+      };
+      ///////////////////////////////////////////////////////////////////
+
       ///////////////////////////////////////////////////////////////////
       //
       //	CLASS NAME : LogControlImpl
@@ -297,14 +377,23 @@ namespace zypp
 
         /** NULL _lineWriter indicates no loggin. */
         void setLineWriter( const shared_ptr<LogControl::LineWriter> & writer_r )
-        { _lineWriter = writer_r; }
+        {
+          if ( _async )
+            drain();	// queued lines go to the old writer
+          std::lock_guard<std::mutex> guard( _putStreamMutex );
+          _lineWriter = writer_r;
+        }
 
-        shared_ptr<LogControl::LineWriter> getLineWriter() const
-        { return _lineWriter; }
+        shared_ptr<LogControl::LineWriter> getLineWriter()
+        {
+          std::lock_guard<std::mutex> guard( _putStreamMutex );
+          return _lineWriter;
+        }
 
         /** Assert \a _lineFormater is not NULL. */
         void setLineFormater( const shared_ptr<LogControl::LineFormater> & format_r )
         {
+          std::lock_guard<std::mutex> guard( _putStreamMutex );
           if ( format_r )
             _lineFormater = format_r;
           else
@@ -321,6 +410,44 @@ namespace zypp
             setLineWriter( shared_ptr<LogControl::LineWriter>(new log::FileLineWriter(logfile_r, mode_r)) );
         }
 
+        /** Start or stop the background writer.
+         * Switching takes \ref _asyncSwitchMutex exclusively, so no producer can
+         * queue a line once the queue was flushed and \ref _async reset.
+         */
+        void setAsync( bool yesno_r )
+        {
+          std::unique_lock<std::shared_mutex> switchGuard( _asyncSwitchMutex );
+          if ( yesno_r == bool(_writer) )
+            return;
+
+          if ( yesno_r )
+          {
+            {
+              std::lock_guard<std::mutex> guard( _ringsMutex );
+              if ( ! _mainRing )
+              {
+                _mainRing = std::make_shared<LogRing>();
+                _rings.push_back( _mainRing );
+              }
+            }
+            _asyncStop = false;
+            _writer.reset( new std::thread( [this]() { writerLoop(); } ) );
+            _async = true;
+          }
+          else
+          {
+            _async = false;
+            {
+              std::lock_guard<std::mutex> guard( _asyncMutex );
+              _asyncStop = true;
+            }
+            _asyncCond.notify_one();
+            _writer->join();
+            _writer.reset();
+            drain();	// whatever the writer left, before producers write directly
+          }
+        }
+
       private:
         std::ostream _no_stream;
         bool         _excessive;
@@ -330,7 +457,7 @@ namespace zypp
 
       public:
         /** Provide the log stream to write (logger interface) */
-        std::ostream & getStream( const std::string & group_r,
+        std::ostream & getStream( const char *        group_r,
                                   LogLevel            level_r,
                                   const char *        file_r,
                                   const char *        func_r,
@@ -341,11 +468,21 @@ namespace zypp
           if ( level_r == E_XXX && !_excessive )
             return _no_stream;
 
-          if ( !_streamtable[group_r][level_r] )
+          // Usually group_r is a string literal, so its address identifies the group.
+          // Comparing the name protects against a reused buffer.
+          StreamSet & streamset( threadStreamtable()[group_r] );
+          if ( ! streamset._group || *streamset._group != group_r )
+          {
+            streamset._group = &internGroup( group_r );
+            for ( StreamPtr & stream : streamset._streams )
+              stream.reset();
+          }
+          StreamPtr & stream( streamset._streams[level_r == E_XXX ? 0 : level_r+1] );
+          if ( !stream )
             {
-              _streamtable[group_r][level_r].reset( new Loglinestream( group_r, level_r ) );
+              stream.reset( new Loglinestream( *streamset._group, level_r ) );
             }
-          std::ostream & ret( _streamtable[group_r][level_r]->getStream( file_r, func_r, line_r ) );
+          std::ostream & ret( stream->getStream( file_r, func_r, line_r ) );
 	  if ( !ret )
 	  {
 	    ret.clear();
@@ -354,7 +491,7 @@ namespace zypp
           return ret;
         }
 
-        /** Format and write out a logline from Loglinebuf. */
+        /** Format and write out a logline from Loglinebuf (or queue it in async mode). */
         void putStream( const std::string & group_r,
                         LogLevel            level_r,
                         const char *        file_r,
@@ -362,6 +499,15 @@ namespace zypp
                         int                 line_r,
                         const std::string & message_r )
         {
+          if ( _inWriterThread )
+            return;	// e.g. a LineWriter logging; dropped (and setAsync may wait for us)
+          {
+            std::shared_lock<std::shared_mutex> switchGuard( _asyncSwitchMutex );
+            if ( _async && enqueue( group_r, level_r, file_r, func_r, line_r, message_r ) )
+              return;
+          }
+
+          std::lock_guard<std::mutex> guard( _putStreamMutex );
           if ( _lineWriter )
             _lineWriter->writeOut( _lineFormater->format( group_r, level_r,
                                                           file_r, func_r, line_r,
@@ -370,10 +516,180 @@ namespace zypp
 
       private:
         typedef shared_ptr<Loglinestream>        StreamPtr;
-        typedef std::map<LogLevel,StreamPtr>     StreamSet;
-        typedef std::map<std::string,StreamSet>  StreamTable;
+        /** The streams of a group, by level (E_XXX first). */
+        struct StreamSet
+        {
+          const std::string *     _group = nullptr;	// interned
+          std::array<StreamPtr,9> _streams;
+        };
+        /** Keyed by the group pointer passed to \ref getStream. */
+        typedef std::unordered_map<const char *,StreamSet>  StreamTable;
         /** one streambuffer per group and level */
         StreamTable _streamtable;
+        /** The thread owning \ref _streamtable (the one which created the singleton). */
+        std::thread::id _mainThread;
+
+        /** Log lines are assembled per thread, so worker threads do not mix up their output.
+         * The main thread uses \ref _streamtable, as it must be available until the singleton
+         * is destructed (statics log from their dtor).
+         */
+        StreamTable & threadStreamtable()
+        {
+          if ( std::this_thread::get_id() == _mainThread )
+            return _streamtable;
+          static thread_local StreamTable _threadStreamtable;
+          return _threadStreamtable;
+        }
+        /** Serialize formating and writing complete lines. */
+        std::mutex _putStreamMutex;
+
+      private:
+        /** The threads \ref LogRing, registered on first use and orphaned when the thread ends. */
+        struct RingHolder
+        {
+          RingHolder( LogControlImpl & impl_r )
+          : _ring( std::make_shared<LogRing>() )
+          {
+            std::lock_guard<std::mutex> guard( impl_r._ringsMutex );
+            impl_r._rings.push_back( _ring );
+          }
+          ~RingHolder()
+          { _ring->_orphaned = true; }
+
+          std::shared_ptr<LogRing> _ring;
+        };
+
+        /** Like \ref threadStreamtable the main threads ring lives as long as the singleton. */
+        LogRing & threadRing()
+        {
+          if ( std::this_thread::get_id() == _mainThread )
+            return *_mainRing;
+          static thread_local RingHolder _holder( *this );
+          return *_holder._ring;
+        }
+
+        /** Queue a line for the writer thread (\c false if not in async mode). */
+        bool enqueue( const std::string & group_r, LogLevel level_r,
+                      const char * file_r, const char * func_r, int line_r,
+                      const std::string & message_r )
+        {
+          if ( _inWriterThread )
+            return true;	// e.g. a LineWriter logging; dropped
+
+          LogRing & ring( threadRing() );
+          LogRing::Entry entry { &group_r, level_r, file_r, func_r, line_r, message_r, _seq++ };
+          while ( ! ring.push( entry ) )
+          {
+            if ( level_r == E_XXX || level_r <= E_MIL )
+            {
+              ++_dropped;
+              return true;
+            }
+            _asyncCond.notify_one();
+            std::this_thread::yield();
+            if ( ! _async )
+              return false;
+          }
+          if ( ring.size() > LogRing::_size / 2 )
+            _asyncCond.notify_one();
+          return true;
+        }
+
+        void writerLoop()
+        {
+          _inWriterThread = true;
+          std::unique_lock<std::mutex> lock( _asyncMutex );
+          while ( ! _asyncStop )
+          {
+            _asyncCond.wait_for( lock, std::chrono::milliseconds( 50 ) );
+            lock.unlock();
+            drain();
+            lock.lock();
+          }
+        }
+
+        /** Write all queued lines in their global order. */
+        void drain()
+        {
+          std::lock_guard<std::mutex> guard( _putStreamMutex );
+          std::vector<std::shared_ptr<LogRing>> rings;
+          {
+            std::lock_guard<std::mutex> ringsGuard( _ringsMutex );
+            rings = _rings;
+          }
+          for ( const auto & ring : rings )
+            ring->drain( [this]( LogRing::Entry && entry_r ) { _batch.push_back( std::move(entry_r) ); } );
+          {
+            // forget the rings of finished threads once they are empty
+            std::lock_guard<std::mutex> ringsGuard( _ringsMutex );
+            _rings.erase( std::remove_if( _rings.begin(), _rings.end(), []( const std::shared_ptr<LogRing> & ring_r ) {
+              return ring_r->_orphaned && ring_r->size() == 0;
+            } ), _rings.end() );
+          }
+
+          std::sort( _batch.begin(), _batch.end(), []( const LogRing::Entry & lhs, const LogRing::Entry & rhs ) {
+            return lhs._seq < rhs._seq;
+          } );
+          if ( _lineWriter )
+          {
+            for ( const LogRing::Entry & entry : _batch )
+              _lineWriter->writeOut( _lineFormater->format( *entry._group, entry._level,
+                                                            entry._file, entry._func, entry._line,
+                                                            entry._message ) );
+            if ( unsigned long dropped = _dropped.exchange( 0 ) )
+              _lineWriter->writeOut( _lineFormater->format( "LogControl", E_WAR, "LogControl.cc", __FUNCTION__, __LINE__,
+                                                            str::Str() << "--- " << dropped << " log lines dropped" ) );
+          }
+          _batch.clear();
+        }
+
+        std::atomic<bool> _async { false };
+        std::shared_mutex _asyncSwitchMutex;	// shared: enqueue, exclusive: setAsync
+        std::unique_ptr<std::thread> _writer;
+        std::mutex _asyncMutex;
+        std::condition_variable _asyncCond;
+        bool _asyncStop = false;
+
+        std::mutex _ringsMutex;
+        std::vector<std::shared_ptr<LogRing>> _rings;
+        std::shared_ptr<LogRing> _mainRing;
+        std::vector<LogRing::Entry> _batch;
+        std::atomic<unsigned long> _seq { 0 };
+        std::atomic<unsigned long> _dropped { 0 };
+        static thread_local bool _inWriterThread;
+
+      private:
+        /** A forked child must not find the mutexes locked, and has no writer thread. */
+        static void atforkPrepare()
+        {
+          LogControlImpl & self( instance() );
+          self._asyncSwitchMutex.lock();
+          internMutex().lock();
+          self._putStreamMutex.lock();
+          self._ringsMutex.lock();
+        }
+
+        static void atforkParent()
+        {
+          LogControlImpl & self( instance() );
+          self._ringsMutex.unlock();
+          self._putStreamMutex.unlock();
+          internMutex().unlock();
+          self._asyncSwitchMutex.unlock();
+        }
+
+        static void atforkChild()
+        {
+          atforkParent();
+          LogControlImpl & self( instance() );
+          if ( self._writer )
+          {
+            self._writer.release();	// the thread does not exist in the child
+            self._async = false;
+            for ( const auto & ring : self._rings )
+              ring->drain( []( LogRing::Entry && ) {} );	// the parent writes them
+          }
+        }
 
       private:
         /** Singleton ctor.
@@ -383,7 +699,10 @@ namespace zypp
         : _no_stream( NULL )
         , _excessive( getenv("ZYPP_FULLLOG") )
         , _lineFormater( new LogControl::LineFormater )
+        , _mainThread( std::this_thread::get_id() )
         {
+          ::pthread_atfork( &LogControlImpl::atforkPrepare, &LogControlImpl::atforkParent, &LogControlImpl::atforkChild );
+
           if ( getenv("ZYPP_LOGFILE") )
             logfile( getenv("ZYPP_LOGFILE") );
 
@@ -392,10 +711,14 @@ namespace zypp
             shared_ptr<LogControl::LineFormater> formater(new ProfilingFormater);
             setLineFormater(formater);
           }
+
+          if ( getenv("ZYPP_LOGASYNC") )
+            setAsync( true );
         }
 
         ~LogControlImpl()
         {
+          setAsync( false );
           _lineWriter.reset();
         }
 
@@ -410,6 +733,8 @@ namespace zypp
       };
       ///////////////////////////////////////////////////////////////////
 
+      thread_local bool LogControlImpl::_inWriterThread = false;
+
       // 'THE' LogControlImpl singleton
       inline LogControlImpl & LogControlImpl::instance()
       {
@@ -491,6 +816,9 @@ namespace zypp
     void LogControl::logToStdErr()
     { LogControlImpl::instance().setLineWriter( shared_ptr<LineWriter>( new log::StderrLineWriter ) ); }
 
+    void LogControl::setAsync( bool yesno_r )
+    { LogControlImpl::instance().setAsync( yesno_r ); }
+
     ///////////////////////////////////////////////////////////////////
     //
     // LogControl::TmpExcessive
@@ -145,6 +145,19 @@ namespace zypp
       /** Log to std::err. */
       void logToStdErr();
 
+    public:
+      /** Write the loglines from a background thread.
+       * The logging threads just queue their lines, each one in a ring
+       * buffer of its own, and the background thread formats and writes
+       * them in batches. If a queue is full, debug and milestone lines
+       * are dropped (the number is logged), others wait for the writer.
+       * Lines still queued if the process crashes are lost.
+       * Also enabled by \c $ZYPP_LOGASYNC.
+       * \note The file and function names passed to \ref logger::getStream
+       * must be static strings (as provided by the logging macros).
+       */
+      void setAsync( bool yesno_r );
+
     public:
       /** Get the current LineWriter */
       shared_ptr<LineWriter> getLineWriter() const;
@@ -12,6 +12,7 @@
 #ifndef ZYPP_BASE_SIMPLESTREAMBUF_H_DEFINED
 #define ZYPP_BASE_SIMPLESTREAMBUF_H_DEFINED
 
+#include <algorithm>
 #include <streambuf>
 #include <vector>
 
@@ -49,14 +50,20 @@ namespace zypp {
      * \endcode
      *
      * \note Currently only supports reading or writing at the same time, but can be extended to support both
+     *
+     * Bulk reads (e.g. \c istream::read as done by the xml parser or \ref Digest)
+     * bypass the buffer: As soon as the buffered data are consumed, chunks of at least
+     * \ref directReadMin bytes are decompressed straight into the callers memory.
      */
     template<typename Impl>
     class SimpleStreamBuf : public std::streambuf, public Impl
     {
 
       public:
+      /** Min. chunk size passed to \c readData without copying it through the buffer. */
+      static constexpr std::streamsize directReadMin = 1024;
 
-      SimpleStreamBuf( size_t bufsize_r = 512) : _buffer( bufsize_r ) { }
+      SimpleStreamBuf( size_t bufsize_r = 8192 ) : _buffer( bufsize_r ) { }
       virtual ~SimpleStreamBuf() { close(); }
 
       SimpleStreamBuf * open( const char * name_r, std::ios_base::openmode mode_r = std::ios_base::in ) {
@@ -145,6 +152,34 @@ namespace zypp {
           return ret;
         }
 
+        virtual std::streamsize xsgetn( char * s_r, std::streamsize n_r ) {
+          if ( !this->canRead() )
+            return 0;
+
+          std::streamsize ret = 0;
+          while ( ret < n_r ) {
+            std::streamsize avail = egptr() - gptr();
+            if ( avail > 0 ) {
+              // consume the buffered data first
+              const std::streamsize cnt = std::min( avail, n_r - ret );
+              traits_type::copy( s_r + ret, gptr(), cnt );
+              gbump( cnt );
+              ret += cnt;
+            }
+            else if ( n_r - ret >= directReadMin ) {
+              // buffer is empty: read straight into the callers memory
+              const std::streamsize got = this->readData( s_r + ret, n_r - ret );
+              if ( got <= 0 )
+                break;	// EOF or error
+              setg( &(_buffer[0]), &(_buffer[0]), &(_buffer[0]) );
+              ret += got;
+            }
+            else if ( traits_type::eq_int_type( underflow(), traits_type::eof() ) )
+              break;
+          }
+          return ret;
+        }
+
         virtual pos_type seekpos( pos_type pos_r, std::ios_base::openmode openMode ) {
           return seekoff( off_type(pos_r), std::ios_base::beg, openMode );
         }
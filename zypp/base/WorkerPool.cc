@@ -0,0 +1,81 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/base/WorkerPool.cc
+ */
+#include <zypp/base/WorkerPool_p.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  WorkerPool::WorkerPool( unsigned size_r )
+  {
+    if ( ! size_r )
+      size_r = defaultSize();
+    _threads.reserve( size_r );
+    for ( unsigned i = 0; i < size_r; ++i )
+      _threads.emplace_back( [this]() { run(); } );
+  }
+
+  WorkerPool::~WorkerPool()
+  {
+    {
+      std::lock_guard<std::mutex> guard( _mutex );
+      _stop = true;
+    }
+    _jobAvailable.notify_all();
+    for ( auto & thread : _threads )
+      thread.join();
+  }
+
+  unsigned WorkerPool::defaultSize()
+  {
+    unsigned ret = std::thread::hardware_concurrency();
+    return ret ? ret : 1;
+  }
+
+  void WorkerPool::wait()
+  {
+    std::unique_lock<std::mutex> lock( _mutex );
+    _jobDone.wait( lock, [this]() { return _queue.empty() && ! _busy; } );
+  }
+
+  void WorkerPool::enqueue( std::function<void()> && job_r )
+  {
+    {
+      std::lock_guard<std::mutex> guard( _mutex );
+      _queue.push_back( std::move(job_r) );
+    }
+    _jobAvailable.notify_one();
+  }
+
+  void WorkerPool::run()
+  {
+    while ( true )
+    {
+      std::function<void()> job;
+      {
+	std::unique_lock<std::mutex> lock( _mutex );
+	_jobAvailable.wait( lock, [this]() { return _stop || ! _queue.empty(); } );
+	if ( _queue.empty() )
+	  return;	// _stop and nothing left to do
+	job = std::move( _queue.front() );
+	_queue.pop_front();
+	++_busy;
+      }
+      job();	// a packaged_task: exceptions end up in the future
+      {
+	std::lock_guard<std::mutex> guard( _mutex );
+	--_busy;
+      }
+      _jobDone.notify_all();
+    }
+  }
+
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,131 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/base/WorkerPool_p.h
+ * This file contains private API, it will change without notice.
+ * You have been warned.
+*/
+#ifndef ZYPP_BASE_WORKERPOOL_P_H
+#define ZYPP_BASE_WORKERPOOL_P_H
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <zypp/APIConfig.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  /// \class WorkerPool
+  /// \brief Run jobs on a bounded number of worker threads.
+  ///
+  /// \ref submit returns a \c std::future for the jobs result. Exceptions
+  /// thrown by a job are stored in the future and rethrown by \c get.
+  /// The dtor waits for all submitted jobs to complete.
+  ///
+  /// \note Jobs run outside the main thread, so they must not send
+  /// callbacks or access the global \c sat::Pool, \ref ResPool or
+  /// \ref media::MediaManager. Report back via the future and let the
+  /// main thread do that.
+  ///
+  /// \code
+  ///   WorkerPool workers( 4 );
+  ///   std::vector<std::future<int>> results;
+  ///   for ( const auto & el : input )
+  ///     results.push_back( workers.submit( [&el]() { return compute( el ); } ) );
+  ///   for ( auto & res : results )
+  ///     use( res.get() );
+  /// \endcode
+  ///////////////////////////////////////////////////////////////////
+  class ZYPP_LOCAL WorkerPool
+  {
+  public:
+    /** Ctor starting \a size_r threads (\c 0 means \ref defaultSize). */
+    explicit WorkerPool( unsigned size_r = 0 );
+
+    WorkerPool( const WorkerPool & ) = delete;
+    WorkerPool & operator=( const WorkerPool & ) = delete;
+
+    /** Dtor waits for all pending jobs. */
+    ~WorkerPool();
+
+    /** The number of worker threads. */
+    unsigned size() const
+    { return _threads.size(); }
+
+    /** The number of hardware threads (at least \c 1). */
+    static unsigned defaultSize();
+
+  public:
+    /** Queue \a job_r for execution and return the future of its result. */
+    template <class TJob>
+    auto submit( TJob && job_r ) -> std::future<std::invoke_result_t<TJob>>
+    {
+      typedef std::invoke_result_t<TJob> Result;
+      auto task = std::make_shared<std::packaged_task<Result()>>( std::forward<TJob>(job_r) );
+      std::future<Result> ret( task->get_future() );
+      enqueue( [task]() { (*task)(); } );
+      return ret;
+    }
+
+    /** Wait until all queued jobs are done. */
+    void wait();
+
+  private:
+    void enqueue( std::function<void()> && job_r );
+    void run();
+
+  private:
+    std::vector<std::thread> _threads;
+    std::deque<std::function<void()>> _queue;
+    std::mutex _mutex;
+    std::condition_variable _jobAvailable;
+    std::condition_variable _jobDone;
+    unsigned _busy = 0;
+    bool _stop = false;
+  };
+
+  /** Call \a fnc_r for each index in <tt>[0,size_r)</tt> using up to \a threads_r threads and wait for completion.
+   * The first exception thrown by \a fnc_r is rethrown (after all jobs are done).
+   * Without extra threads (or for less than two indices) \a fnc_r is called sequentially in the calling thread.
+   */
+  template <class TFnc>
+  void parallelFor( size_t size_r, TFnc && fnc_r, unsigned threads_r = 0 )
+  {
+    if ( ! threads_r )
+      threads_r = WorkerPool::defaultSize();
+    if ( threads_r > size_r )
+      threads_r = size_r;
+    if ( threads_r < 2 )
+    {
+      for ( size_t i = 0; i < size_r; ++i )
+	fnc_r( i );
+      return;
+    }
+
+    WorkerPool pool( threads_r );
+    std::vector<std::future<void>> results;
+    results.reserve( size_r );
+    for ( size_t i = 0; i < size_r; ++i )
+      results.push_back( pool.submit( [&fnc_r,i]() { fnc_r( i ); } ) );
+    pool.wait();
+    for ( auto & res : results )
+      res.get();	// rethrow
+  }
+
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_BASE_WORKERPOOL_P_H
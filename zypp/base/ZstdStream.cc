@@ -0,0 +1,151 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#include <zypp/base/ZstdStream.h>
+#include <zypp/base/String.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+
+#include <zstd.h>
+
+namespace zypp {
+
+  namespace detail {
+
+    zstdstreambufimpl::~zstdstreambufimpl()
+    {
+      closeImpl();
+    }
+
+    bool zstdstreambufimpl::openImpl( const char *name_r, std::ios_base::openmode mode_r )
+    {
+      if ( isOpen() )
+        return false;
+
+      if ( mode_r != std::ios_base::in ) {
+        //unsupported mode
+        _lastErr = str::Format("Zstd backend does not support the given open mode.");
+        return false;
+      }
+
+      _fd = ::open( name_r, O_RDONLY | O_CLOEXEC );
+      if ( _fd < 0 ) {
+        const int errSrv = errno;
+        _lastErr = str::Format("Opening file failed: %1%") % ::strerror( errSrv );
+        return false;
+      }
+
+      _dContext = ::ZSTD_createDCtx();
+      if ( !_dContext ) {
+        _lastErr = str::Format("Failed to create the zstd decompression context.");
+        closeImpl();
+        return false;
+      }
+
+      _inBuffer.resize( ::ZSTD_DStreamInSize() );
+      _inPos = _inSize = 0;
+      _frameDone = true;
+      _currfp = 0;
+      return true;
+    }
+
+    bool zstdstreambufimpl::closeImpl()
+    {
+      if ( !isOpen() )
+        return true;
+
+      ::ZSTD_freeDCtx( _dContext );
+      _dContext = nullptr;
+      ::close( _fd );
+      _fd = -1;
+      return true;
+    }
+
+    std::streamsize zstdstreambufimpl::readData(char *buffer_r, std::streamsize maxcount_r)
+    {
+      if ( !isOpen() || !canRead() )
+        return -1;
+
+      ZSTD_outBuffer out { buffer_r, size_t(maxcount_r), 0 };
+      while ( out.pos < out.size ) {
+        if ( _inPos == _inSize ) {
+          ssize_t got = ::read( _fd, _inBuffer.data(), _inBuffer.size() );
+          if ( got < 0 ) {
+            if ( errno == EINTR )
+              continue;
+            const int errSrv = errno;
+            _lastErr = str::Format("Reading file failed: %1%") % ::strerror( errSrv );
+            return -1;
+          }
+          if ( got == 0 ) {
+            if ( !_frameDone ) {
+              _lastErr = str::Format("Unexpected end of zstd data.");
+              return -1;
+            }
+            break;	// EOF
+          }
+          _inPos = 0;
+          _inSize = got;
+        }
+
+        ZSTD_inBuffer in { _inBuffer.data(), _inSize, _inPos };
+        size_t ret = ::ZSTD_decompressStream( _dContext, &out, &in );
+        _inPos = in.pos;
+        if ( ::ZSTD_isError( ret ) ) {
+          _lastErr = ::ZSTD_getErrorName( ret );
+          return -1;
+        }
+        _frameDone = ( ret == 0 );
+      }
+
+      _currfp += out.pos;
+      return out.pos;
+    }
+
+    bool zstdstreambufimpl::writeData(const char *, std::streamsize)
+    {
+      return false;
+    }
+
+    bool zstdstreambufimpl::isOpen() const
+    {
+      return ( _fd >= 0 );
+    }
+
+    bool zstdstreambufimpl::canRead() const
+    {
+      return isOpen();
+    }
+
+    bool zstdstreambufimpl::canWrite() const
+    {
+      return false;
+    }
+
+    bool zstdstreambufimpl::canSeek( std::ios_base::seekdir ) const
+    {
+      return false;
+    }
+
+    off_t zstdstreambufimpl::seekTo(off_t, std::ios_base::seekdir , std::ios_base::openmode)
+    {
+      return -1;
+    }
+
+    off_t zstdstreambufimpl::tell() const
+    {
+      return _currfp;
+    }
+  }
+
+}
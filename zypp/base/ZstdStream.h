@@ -0,0 +1,74 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#ifndef ZYPP_BASE_ZSTDSTREAM_H
+#define ZYPP_BASE_ZSTDSTREAM_H
+
+#include <iosfwd>
+#include <streambuf>
+#include <vector>
+#include <zypp/base/SimpleStreambuf.h>
+#include <zypp/base/fXstream.h>
+
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+
+namespace zypp {
+
+  namespace detail {
+
+    /**
+     * @short Streambuffer reading zstd compressed files.
+     *
+     * Only reading is supported. Seek is not supported.
+     *
+     * This streambuf is used in @ref ifzstdstream.
+     **/
+    class zstdstreambufimpl {
+      public:
+
+        using error_type = std::string;
+
+        ~zstdstreambufimpl();
+
+        bool isOpen   () const;
+        bool canRead  () const;
+        bool canWrite () const;
+        bool canSeek  ( std::ios_base::seekdir way_r ) const;
+
+        std::streamsize readData ( char * buffer_r, std::streamsize maxcount_r  );
+        bool writeData( const char * buffer_r, std::streamsize count_r );
+        off_t seekTo( off_t off_r, std::ios_base::seekdir way_r, std::ios_base::openmode omode_r );
+        off_t tell() const;
+
+        error_type error() const { return _lastErr; }
+
+      protected:
+        bool openImpl( const char * name_r, std::ios_base::openmode mode_r );
+        bool closeImpl ();
+
+      private:
+        int _fd = -1;
+        ZSTD_DCtx *_dContext = nullptr;
+        std::vector<char> _inBuffer;	// compressed data read from _fd
+        size_t _inPos = 0;
+        size_t _inSize = 0;
+        bool _frameDone = true;	// whether the last frame was completely decoded
+        off_t _currfp = 0;
+        error_type _lastErr;
+
+    };
+    using ZstdStreamBuf = detail::SimpleStreamBuf<detail::zstdstreambufimpl>;
+  }
+
+  /**
+   * istream reading zstd compressed files.
+   **/
+  using ifzstdstream = detail::fXstream<std::istream,detail::ZstdStreamBuf>;
+}
+
+#endif
@@ -8,7 +8,10 @@
 #include <zypp/media/ProxyInfo.h>
 #include <zypp/media/MediaUserAuth.h>
 #include <zypp/media/MediaException.h>
+#include <atomic>
 #include <list>
+#include <mutex>
+#include <thread>
 
 using std::endl;
 using namespace zypp;
@@ -25,6 +28,98 @@ void globalInitCurlOnce()
   } (), true );
 }
 
+namespace
+{
+  // Dynamic initialization is done by the main thread.
+  const std::thread::id mainThread( std::this_thread::get_id() );
+
+  /** Idle connections kept by a handle or multi handle using the share. */
+  constexpr long maxSharedConnects = 32;
+
+  /** A \c CURLSH using one mutex per curl_lock_data. */
+  struct Share
+  {
+    Share( bool connections_r )
+    {
+      _share = curl_share_init();
+      if ( ! _share )
+      {
+        WAR << "curl_share_init failed; connections are not shared" << endl;
+        return;
+      }
+      curl_share_setopt( _share, CURLSHOPT_LOCKFUNC, &Share::lock );
+      curl_share_setopt( _share, CURLSHOPT_UNLOCKFUNC, &Share::unlock );
+      curl_share_setopt( _share, CURLSHOPT_USERDATA, this );
+      curl_share_setopt( _share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS );
+      curl_share_setopt( _share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION );
+#if CURLVERSION_AT_LEAST(7,57,0)
+      if ( connections_r )
+        curl_share_setopt( _share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT );
+#endif
+    }
+
+    static void lock( CURL *, curl_lock_data data_r, curl_lock_access, void * userp_r )
+    { static_cast<Share *>( userp_r )->_mutex[data_r].lock(); }
+
+    static void unlock( CURL *, curl_lock_data data_r, void * userp_r )
+    { static_cast<Share *>( userp_r )->_mutex[data_r].unlock(); }
+
+    CURLSH * _share = nullptr;
+    std::mutex _mutex[CURL_LOCK_DATA_LAST];
+  };
+
+  /** The process wide \c CURLSH objects (see \ref useGlobalShare). */
+  struct GlobalShare
+  {
+    static GlobalShare & instance()
+    {
+      // Intentionally never released: easy handles owned by other static
+      // objects may still use it at exit.
+      static GlobalShare * _instance = ( globalInitCurlOnce(), new GlobalShare );
+      return *_instance;
+    }
+
+    /** The main threads handles share connections too. A shared connection
+     * cache must not be used by handles on different threads (curl does
+     * not support it), so the other threads just share DNS and TLS sessions.
+     */
+    Share & forThisThread()
+    { return std::this_thread::get_id() == mainThread ? _main : _threads; }
+
+    Share _main { true };
+    Share _threads { false };
+    std::atomic<unsigned long> _transfers { 0 };
+    std::atomic<unsigned long> _connects { 0 };
+  };
+} // namespace
+
+void useGlobalShare( CURL * easy_r )
+{
+  CURLSH * share = GlobalShare::instance().forThisThread()._share;
+  if ( share && curl_easy_setopt( easy_r, CURLOPT_SHARE, share ) != CURLE_OK )
+    WAR << "Can't set CURLOPT_SHARE" << endl;
+  curl_easy_setopt( easy_r, CURLOPT_MAXCONNECTS, maxSharedConnects );
+}
+
+void limitSharedConnections( CURLM * multi_r )
+{ curl_multi_setopt( multi_r, CURLMOPT_MAXCONNECTS, maxSharedConnects ); }
+
+void countTransfer( CURL * easy_r )
+{
+  long connects = 0;
+  if ( curl_easy_getinfo( easy_r, CURLINFO_NUM_CONNECTS, &connects ) != CURLE_OK )
+    return;
+  GlobalShare & share( GlobalShare::instance() );
+  ++share._transfers;
+  share._connects += connects;
+}
+
+std::string connectionStats()
+{
+  GlobalShare & share( GlobalShare::instance() );
+  return str::Str() << share._transfers << " transfers, " << share._connects << " new connections";
+}
+
 int log_curl(CURL *curl, curl_infotype info,
   char *ptr, size_t len, void *max_lvl)
 {
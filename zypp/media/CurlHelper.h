@@ -41,6 +41,38 @@ namespace env {
 }
 
 void globalInitCurlOnce();
+
+/**
+ * Let \a easy_r use the process wide \c CURLSH.
+ *
+ * The DNS cache and TLS sessions are shared by all easy handles using it.
+ * Handles set up by the main thread also share their open connections, so
+ * they survive the handle and a host serving several repos is connected
+ * only once. curl does not support sharing connections across threads, so
+ * a handle must be used by the thread which called this. Must be set again
+ * after \c curl_easy_reset.
+ *
+ * At most 32 idle connections are kept (\c CURLOPT_MAXCONNECTS); a multi
+ * handle running shared handles sets its limit by \ref limitSharedConnections.
+ */
+void useGlobalShare( CURL * easy_r );
+
+/**
+ * Limit the idle connections kept by \a multi_r (\c CURLMOPT_MAXCONNECTS),
+ * like \ref useGlobalShare does for an easy handle.
+ */
+void limitSharedConnections( CURLM * multi_r );
+
+/**
+ * Count the transfer just finished by \a easy_r in the \ref connectionStats.
+ */
+void countTransfer( CURL * easy_r );
+
+/**
+ * Transfers counted and the new connections they needed, e.g.
+ * <tt>"42 transfers, 3 new connections"</tt>.
+ */
+std::string connectionStats();
 int  log_curl(CURL *curl, curl_infotype info,  char *ptr, size_t len, void *max_lvl);
 size_t log_redirects_curl( char *ptr, size_t size, size_t nmemb, void *userdata);
 
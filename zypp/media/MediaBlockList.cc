@@ -15,12 +15,16 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <fcntl.h>
+
+#include <algorithm>
 #include <vector>
 #include <iostream>
 #include <fstream>
 
 #include <zypp/media/MediaBlockList.h>
 #include <zypp/base/Logger.h>
+#include <zypp/AutoDispose.h>
 #include <zypp/base/String.h>
 
 using namespace zypp::base;
@@ -258,11 +262,62 @@ MediaBlockList::writeBlock(size_t blkno, FILE *fp, const unsigned char *buf, siz
   found[blocks.size()] = true;
 }
 
+namespace {
+  /**
+   * Sequential reader for the block scan. Reads the file in large chunks,
+   * as fetching it byte by byte via getc() dominates the scan time.
+   **/
+  class ScanReader
+  {
+  public:
+    ScanReader(FILE *fp, size_t bufsize = 256 * 1024)
+    : _fp(fp)
+    , _buf(bufsize)
+    {
+      posix_fadvise(fileno(fp), 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    /** next byte or EOF */
+    inline int getc()
+    {
+      if (_pos == _end && !fill())
+        return EOF;
+      return _buf[_pos++];
+    }
+
+    /** read up to len bytes, returns the number of bytes read */
+    size_t read(unsigned char *bp, size_t len)
+    {
+      size_t got = 0;
+      while (got < len && (_pos != _end || fill()))
+        {
+          size_t l = std::min(len - got, _end - _pos);
+          memcpy(bp + got, &_buf[_pos], l);
+          _pos += l;
+          got += l;
+        }
+      return got;
+    }
+
+  private:
+    bool fill()
+    {
+      _pos = 0;
+      _end = fread(&_buf[0], 1, _buf.size(), _fp);
+      return _end != 0;
+    }
+
+    FILE *_fp;
+    std::vector<unsigned char> _buf;
+    size_t _pos = 0;
+    size_t _end = 0;
+  };
+}
+
 static size_t
-fetchnext(FILE *fp, unsigned char *bp, size_t blksize, size_t pushback, unsigned char *pushbackp)
+fetchnext(ScanReader &reader, unsigned char *bp, size_t blksize, size_t pushback, unsigned char *pushbackp)
 {
   size_t l = blksize;
-  int c;
 
   if (pushback)
     {
@@ -271,26 +326,21 @@ fetchnext(FILE *fp, unsigned char *bp, size_t blksize, size_t pushback, unsigned
       bp += pushback;
       l -= pushback;
     }
-  while (l)
-    {
-      c = getc(fp);
-      if (c == EOF)
-        break;
-      *bp++ = c;
-      l--;
-    }
+  size_t got = reader.read(bp, l);
+  bp += got;
+  l -= got;
   if (l)
     memset(bp, 0, l);
   return blksize - l;
 }
 
-
 void
 MediaBlockList::reuseBlocks(FILE *wfp, std::string filename)
 {
-  FILE *fp;
-
-  if (!chksumlen || (fp = fopen(filename.c_str(), "r")) == 0)
+  if (!chksumlen)
+    return;
+  AutoFILE fp(fopen(filename.c_str(), "r"));
+  if (!fp)
     return;
   size_t nblks = blocks.size();
   std::vector<bool> found;
@@ -307,8 +357,7 @@ MediaBlockList::reuseBlocks(FILE *wfp, std::string filename)
       hm = hm * 2 - 1;
       if (hm < 16383)
 	hm = 16383;
-      unsigned int *ht = new unsigned int[hm + 1];
-      memset(ht, 0, (hm + 1) * sizeof(unsigned int));
+      std::vector<unsigned int> ht(hm + 1, 0);
       for (unsigned int i = 0; i < rsums.size(); i++)
 	{
 	  if (blocks[i].size != blksize && (i != nblks - 1 || rsumpad != blksize))
@@ -321,8 +370,11 @@ MediaBlockList::reuseBlocks(FILE *wfp, std::string filename)
 	  ht[h] = i + 1;
 	}
 
-      unsigned char *buf = new unsigned char[blksize];
-      unsigned char *buf2 = new unsigned char[blksize];
+      ScanReader reader(fp);
+      std::vector<unsigned char> bufv(blksize, 0);
+      std::vector<unsigned char> buf2v(blksize, 0);
+      unsigned char *buf = &bufv[0];
+      unsigned char *buf2 = &buf2v[0];
       size_t pushback = 0;
       unsigned char *pushbackp = 0;
       int bshift = 0;
@@ -331,7 +383,9 @@ MediaBlockList::reuseBlocks(FILE *wfp, std::string filename)
 	  ;
       unsigned short a, b;
       a = b = 0;
-      memset(buf, 0, blksize);
+      // rsumlen specific mask applied to the rolling checksum
+      const unsigned int amask = rsumlen >= 4 ? 65535 : rsumlen == 3 ? 255 : 0;
+      const unsigned int bmask = rsumlen >= 2 ? 65535 : 255;
       bool eof = 0;
       bool init = 1;
       int sql = nblks > 1 && chksumlen < 16 ? 2 : 1;
@@ -350,7 +404,7 @@ MediaBlockList::reuseBlocks(FILE *wfp, std::string filename)
 		      pushback--;
 		    }
 		  else
-		    c = getc(fp);
+		    c = reader.getc();
 		  if (c == EOF)
 		    {
 		      eof = true;
@@ -372,16 +426,10 @@ MediaBlockList::reuseBlocks(FILE *wfp, std::string filename)
 		    continue;
 		  init = 0;
 		}
-	      unsigned int r;
-	      if (rsumlen == 1)
-		r = ((unsigned int)b & 255);
-	      else if (rsumlen == 2)
-		r = ((unsigned int)b & 65535);
-	      else if (rsumlen == 3)
-		r = ((unsigned int)a & 255) << 16 | ((unsigned int)b & 65535);
-	      else
-		r = ((unsigned int)a & 65535) << 16 | ((unsigned int)b & 65535);
+	      unsigned int r = ((unsigned int)a & amask) << 16 | ((unsigned int)b & bmask);
 	      unsigned int h = r & hm;
+	      if (!ht[h])
+		continue;	// the common case: no candidate block
 	      unsigned int hh = 7;
 	      for (; ht[h]; h = (h + hh++) & hm)
 		{
@@ -394,7 +442,7 @@ MediaBlockList::reuseBlocks(FILE *wfp, std::string filename)
 		    {
 		      if (eof || blkno + 1 >= nblks)
 			continue;
-		      pushback = fetchnext(fp, buf2, blksize, pushback, pushbackp);
+		      pushback = fetchnext(reader, buf2, blksize, pushback, pushbackp);
 		      pushbackp = buf2;
 		      if (!pushback)
 			continue;
@@ -415,7 +463,7 @@ MediaBlockList::reuseBlocks(FILE *wfp, std::string filename)
 		  while (!eof)
 		    {
 		      blkno++;
-		      pushback = fetchnext(fp, buf2, blksize, pushback, pushbackp);
+		      pushback = fetchnext(reader, buf2, blksize, pushback, pushbackp);
 		      pushbackp = buf2;
 		      if (!pushback)
 			break;
@@ -434,9 +482,6 @@ MediaBlockList::reuseBlocks(FILE *wfp, std::string filename)
 		}
 	    }
 	}
-      delete[] buf2;
-      delete[] buf;
-      delete[] ht;
     }
   else if (chksumlen >= 16)
     {
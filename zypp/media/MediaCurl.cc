@@ -270,6 +270,7 @@ void MediaCurl::setupEasy()
     }
   }
 
+  useGlobalShare( _curl );
   curl_easy_setopt(_curl, CURLOPT_HEADERFUNCTION, log_redirects_curl);
   curl_easy_setopt(_curl, CURLOPT_HEADERDATA, &_lastRedirect);
   CURLcode ret = curl_easy_setopt( _curl, CURLOPT_ERRORBUFFER, _curlError );
@@ -576,6 +577,8 @@ void MediaCurl::disconnectFrom()
 
   if ( _curl )
   {
+    // Connections stay in the global share for the next handle.
+    MIL << "Curl connections: " << connectionStats() << endl;
     curl_easy_cleanup( _curl );
     _curl = NULL;
   }
@@ -924,6 +927,7 @@ bool MediaCurl::doGetDoesFileExist( const Pathname & filename ) const
   }
 
   CURLcode ok = curl_easy_perform( _curl );
+  countTransfer( _curl );
   MIL << "perform code: " << ok << " [ " << curl_easy_strerror(ok) << " ]" << endl;
 
   // reset curl settings
@@ -1198,6 +1202,7 @@ void MediaCurl::doGetFileCopyFile(const Pathname & filename , const Pathname & d
     }
 #endif
 
+    countTransfer( _curl );
     if ( curl_easy_setopt( _curl, CURLOPT_PROGRESSDATA, NULL ) != 0 ) {
       WAR << "Can't unset CURLOPT_PROGRESSDATA: " << _curlError << endl;;
     }
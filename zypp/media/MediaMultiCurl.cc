@@ -14,10 +14,12 @@
 #include <sys/types.h>
 #include <signal.h>
 #include <sys/wait.h>
+#include <sys/epoll.h>
 #include <netdb.h>
 #include <arpa/inet.h>
 
 #include <vector>
+#include <map>
 #include <iostream>
 #include <algorithm>
 
@@ -60,8 +62,7 @@ public:
   void disableCompetition();
 
   void checkdns();
-  void adddnsfd(fd_set &rset, int &maxfd);
-  void dnsevent(fd_set &rset);
+  void dnsevent();
 
   int _workerno;
 
@@ -84,6 +85,7 @@ public:
 
 private:
   void stealjob();
+  size_t maxblksize() const;
 
   size_t writefunction(void *ptr, size_t size);
   static size_t _writefunction(void *ptr, size_t size, size_t nmemb, void *stream);
@@ -122,6 +124,15 @@ public:
 protected:
   friend class multifetchworker;
 
+  void watchdns(multifetchworker *worker);
+  void unwatchdns(multifetchworker *worker);
+  void sleepworker(multifetchworker *worker, double until);
+  void socketaction(curl_socket_t s, int ev_bitmask);
+  int waittimeout(double now) const;
+
+  static int _socketfunction(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp);
+  static int _timerfunction(CURLM *multi, long timeout_ms, void *userp);
+
   const MediaMultiCurl *_context;
   const Pathname _filename;
   Url _baseurl;
@@ -132,6 +143,9 @@ protected:
   off_t _filesize;
 
   CURLM *_multi;
+  int _epollfd;			// curl sockets and DNS pipes
+  double _curltimer;		// when curl wants CURL_SOCKET_TIMEOUT, 0 if no timer is set
+  std::map<int, multifetchworker *> _dnsworkers;	// by DNS pipe fd
 
   std::list<multifetchworker *> _workers;
   bool _stealing;
@@ -141,8 +155,7 @@ protected:
   off_t _blkoff;
   size_t _activeworkers;
   size_t _lookupworkers;
-  size_t _sleepworkers;
-  double _minsleepuntil;
+  std::multimap<double, multifetchworker *> _sleepers;	// by wake up time
   bool _finished;
   off_t _totalsize;
   off_t _fetchedsize;
@@ -162,8 +175,9 @@ public:
   int _maxworkers;
 };
 
-#define BLKSIZE		131072
-#define MAXURLS		10
+#define BLKSIZE		131072		// initial and minimal block size
+#define MAXBLKSIZE	(32 * BLKSIZE)	// block size limit for fast mirrors
+#define BLKTIME		1.0		// aim at blocks taking about that many seconds
 
 
 //////////////////////////////////////////////////////////////////////
@@ -409,6 +423,7 @@ multifetchworker::~multifetchworker()
     }
   if (_dnspipe != -1)
     {
+      _request->unwatchdns(this);
       close(_dnspipe);
       _dnspipe = -1;
     }
@@ -499,24 +514,14 @@ multifetchworker::checkdns()
   close(pipefds[1]);
   _dnspipe = pipefds[0];
   _state = WORKER_LOOKUP;
+  _request->watchdns(this);
 }
 
 void
-multifetchworker::adddnsfd(fd_set &rset, int &maxfd)
+multifetchworker::dnsevent()
 {
   if (_state != WORKER_LOOKUP)
     return;
-  FD_SET(_dnspipe, &rset);
-  if (maxfd < _dnspipe)
-    maxfd = _dnspipe;
-}
-
-void
-multifetchworker::dnsevent(fd_set &rset)
-{
-
-  if (_state != WORKER_LOOKUP || !FD_ISSET(_dnspipe, &rset))
-    return;
   int status;
   while (waitpid(_pid, &status, 0) == -1)
     {
@@ -526,6 +531,7 @@ multifetchworker::dnsevent(fd_set &rset)
   _pid = 0;
   if (_dnspipe != -1)
     {
+      _request->unwatchdns(this);
       close(_dnspipe);
       _dnspipe = -1;
     }
@@ -657,9 +663,7 @@ multifetchworker::stealjob()
 	  if (sl > 1)
 	    sl = 1;
 	  XXX << "#" << _workerno << ": going to sleep for " << sl * 1000 << " ms" << endl;
-	  _sleepuntil = now + sl;
-	  _state = WORKER_SLEEP;
-	  _request->_sleepworkers++;
+	  _request->sleepworker(this, now + sl);
 	  return;
 	}
     }
@@ -693,6 +697,21 @@ multifetchworker::disableCompetition()
 }
 
 
+// the block size for unchecked ranges: big enough to keep a fast mirror busy
+// for BLKTIME seconds, so we do not spend the time in request roundtrips.
+size_t
+multifetchworker::maxblksize() const
+{
+  if (_avgspeed <= 0)
+    return BLKSIZE;
+  double blksize = _avgspeed * BLKTIME;
+  if (blksize >= MAXBLKSIZE)
+    return MAXBLKSIZE;
+  if (blksize <= BLKSIZE)
+    return BLKSIZE;
+  return size_t(blksize) / BLKSIZE * BLKSIZE;
+}
+
 void
 multifetchworker::nextjob()
 {
@@ -704,9 +723,10 @@ multifetchworker::nextjob()
     }
 
   MediaBlockList *blklist = _request->_blklist;
+  size_t maxsize = maxblksize();
   if (!blklist)
     {
-      _blksize = BLKSIZE;
+      _blksize = maxsize;
       if (_request->_filesize != off_t(-1))
 	{
 	  if (_request->_blkoff >= _request->_filesize)
@@ -715,8 +735,8 @@ multifetchworker::nextjob()
 	      return;
 	    }
 	  _blksize = _request->_filesize - _request->_blkoff;
-	  if (_blksize > BLKSIZE)
-	    _blksize = BLKSIZE;
+	  if (_blksize > maxsize)
+	    _blksize = maxsize;
 	}
     }
   else
@@ -733,8 +753,8 @@ multifetchworker::nextjob()
 	  _request->_blkoff = blk.off;
 	}
       _blksize = blk.off + blk.size - _request->_blkoff;
-      if (_blksize > BLKSIZE && !blklist->haveChecksum(_request->_blkno))
-	_blksize = BLKSIZE;
+      if (_blksize > maxsize && !blklist->haveChecksum(_request->_blkno))
+	_blksize = maxsize;
     }
   _blkno = _request->_blkno;
   _blkstart = _request->_blkoff;
@@ -791,6 +811,14 @@ multifetchrequest::multifetchrequest(const MediaMultiCurl *context, const Pathna
   _blklist = blklist;
   _filesize = filesize;
   _multi = multi;
+  _curltimer = 0;
+  _epollfd = epoll_create1(EPOLL_CLOEXEC);
+  if (_epollfd == -1)
+    ZYPP_THROW(MediaCurlException(_baseurl, "epoll_create1() failed", "unknown error"));
+  curl_multi_setopt(_multi, CURLMOPT_SOCKETFUNCTION, &_socketfunction);
+  curl_multi_setopt(_multi, CURLMOPT_SOCKETDATA, this);
+  curl_multi_setopt(_multi, CURLMOPT_TIMERFUNCTION, &_timerfunction);
+  curl_multi_setopt(_multi, CURLMOPT_TIMERDATA, this);
   _stealing = false;
   _havenewjob = false;
   _blkno = 0;
@@ -800,8 +828,6 @@ multifetchrequest::multifetchrequest(const MediaMultiCurl *context, const Pathna
     _blkoff = 0;
   _activeworkers = 0;
   _lookupworkers = 0;
-  _sleepworkers = 0;
-  _minsleepuntil = 0;
   _finished = false;
   _fetchedsize = 0;
   _fetchedgoodsize = 0;
@@ -834,6 +860,104 @@ multifetchrequest::~multifetchrequest()
       delete worker;
     }
   _workers.clear();
+  // all handles are removed now. The callbacks stay installed on the shared
+  // multi handle, so curl never misses reporting a change; they ignore it
+  // until the next request takes over.
+  curl_multi_setopt(_multi, CURLMOPT_SOCKETDATA, (void *)0);
+  curl_multi_setopt(_multi, CURLMOPT_TIMERDATA, (void *)0);
+  close(_epollfd);
+}
+
+// curl tells us which sockets to watch
+int
+multifetchrequest::_socketfunction(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp)
+{
+  multifetchrequest *me = reinterpret_cast<multifetchrequest *>(userp);
+  if (!me)
+    return 0;
+  if (what == CURL_POLL_REMOVE)
+    {
+      epoll_ctl(me->_epollfd, EPOLL_CTL_DEL, s, NULL);
+      return 0;
+    }
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.data.fd = s;
+  if (what & CURL_POLL_IN)
+    ev.events |= EPOLLIN;
+  if (what & CURL_POLL_OUT)
+    ev.events |= EPOLLOUT;
+  if (epoll_ctl(me->_epollfd, EPOLL_CTL_MOD, s, &ev) == -1 && errno == ENOENT)
+    epoll_ctl(me->_epollfd, EPOLL_CTL_ADD, s, &ev);
+  return 0;
+}
+
+// curl tells us when to call it even if nothing happens on the sockets
+int
+multifetchrequest::_timerfunction(CURLM *multi, long timeout_ms, void *userp)
+{
+  multifetchrequest *me = reinterpret_cast<multifetchrequest *>(userp);
+  if (!me)
+    return 0;
+  me->_curltimer = timeout_ms < 0 ? 0 : currentTime() + timeout_ms / 1000.;
+  return 0;
+}
+
+void
+multifetchrequest::watchdns(multifetchworker *worker)
+{
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.fd = worker->_dnspipe;
+  epoll_ctl(_epollfd, EPOLL_CTL_ADD, worker->_dnspipe, &ev);
+  _dnsworkers[worker->_dnspipe] = worker;
+}
+
+void
+multifetchrequest::unwatchdns(multifetchworker *worker)
+{
+  epoll_ctl(_epollfd, EPOLL_CTL_DEL, worker->_dnspipe, NULL);
+  _dnsworkers.erase(worker->_dnspipe);
+}
+
+void
+multifetchrequest::sleepworker(multifetchworker *worker, double until)
+{
+  worker->_sleepuntil = until;
+  worker->_state = WORKER_SLEEP;
+  _sleepers.insert(std::make_pair(until, worker));
+}
+
+void
+multifetchrequest::socketaction(curl_socket_t s, int ev_bitmask)
+{
+  for (;;)
+    {
+      int tasks;
+      CURLMcode mcode = curl_multi_socket_action(_multi, s, ev_bitmask, &tasks);
+      if (mcode == CURLM_CALL_MULTI_PERFORM)
+	continue;
+      if (mcode != CURLM_OK)
+	ZYPP_THROW(MediaCurlException(_baseurl, "curl_multi_socket_action", "unknown error"));
+      break;
+    }
+}
+
+// how long to wait for events (in ms)
+int
+multifetchrequest::waittimeout(double now) const
+{
+  // if we added a new job we have to call curl once
+  // to get it going. do not sleep in this case.
+  if (_havenewjob)
+    return 0;
+  double timeout = .2;
+  if (_curltimer && _curltimer - now < timeout)
+    timeout = _curltimer - now;
+  if (!_sleepers.empty() && _sleepers.begin()->first - now < timeout)
+    timeout = _sleepers.begin()->first - now;
+  return timeout > 0 ? int(timeout * 1000) : 0;
 }
 
 void
@@ -841,10 +965,11 @@ multifetchrequest::run(std::vector<Url> &urllist)
 {
   int workerno = 0;
   std::vector<Url>::iterator urliter = urllist.begin();
+  // the multi handle outlives the requests: let curl report its timer to us
+  socketaction(CURL_SOCKET_TIMEOUT, 0);
   for (;;)
     {
-      fd_set rset, wset, xset;
-      int maxfd, nqueue;
+      int nqueue;
 
       if (_finished)
 	{
@@ -852,7 +977,7 @@ multifetchrequest::run(std::vector<Url> &urllist)
 	  break;
 	}
 
-      if ((int)_activeworkers < _maxworkers && urliter != urllist.end() && _workers.size() < MAXURLS)
+      if ((int)_activeworkers < _maxworkers && urliter != urllist.end())
 	{
 	  // spawn another worker!
 	  multifetchworker *worker = new multifetchworker(workerno++, *this, *urliter);
@@ -883,70 +1008,40 @@ multifetchrequest::run(std::vector<Url> &urllist)
 	  break;
 	}
 
-      FD_ZERO(&rset);
-      FD_ZERO(&wset);
-      FD_ZERO(&xset);
-
-      curl_multi_fdset(_multi, &rset, &wset, &xset, &maxfd);
-
-      if (_lookupworkers)
-        for (std::list<multifetchworker *>::iterator workeriter = _workers.begin(); workeriter != _workers.end(); ++workeriter)
-	  (*workeriter)->adddnsfd(rset, maxfd);
+      struct epoll_event events[64];
+      int r = epoll_wait(_epollfd, events, 64, waittimeout(currentTime()));
+      if (r == -1 && errno != EINTR)
+	ZYPP_THROW(MediaCurlException(_baseurl, "epoll_wait() failed", "unknown error"));
 
-      timeval tv;
-      // if we added a new job we have to call multi_perform once
-      // to make it show up in the fd set. do not sleep in this case.
-      tv.tv_sec = 0;
-      tv.tv_usec = _havenewjob ? 0 : 200000;
-      if (_sleepworkers && !_havenewjob)
+      // run curl on the sockets with events
+      for (int i = 0; i < r; i++)
 	{
-	  if (_minsleepuntil == 0)
-	    {
-	      for (std::list<multifetchworker *>::iterator workeriter = _workers.begin(); workeriter != _workers.end(); ++workeriter)
-	        {
-		  multifetchworker *worker = *workeriter;
-		  if (worker->_state != WORKER_SLEEP)
-		    continue;
-		  if (!_minsleepuntil || _minsleepuntil > worker->_sleepuntil)
-		    _minsleepuntil = worker->_sleepuntil;
-		}
-	    }
-	  double sl = _minsleepuntil - currentTime();
-	  if (sl < 0)
+	  int fd = events[i].data.fd;
+	  std::map<int, multifetchworker *>::iterator dnsiter = _dnsworkers.find(fd);
+	  if (dnsiter != _dnsworkers.end())
 	    {
-	      sl = 0;
-	      _minsleepuntil = 0;
+	      multifetchworker *worker = dnsiter->second;
+	      worker->dnsevent();
+	      if (worker->_state != WORKER_LOOKUP)
+		_lookupworkers--;
+	      continue;
 	    }
-	  if (sl < .2)
-	    tv.tv_usec = sl * 1000000;
+	  int ev_bitmask = 0;
+	  if (events[i].events & EPOLLIN)
+	    ev_bitmask |= CURL_CSELECT_IN;
+	  if (events[i].events & EPOLLOUT)
+	    ev_bitmask |= CURL_CSELECT_OUT;
+	  if (events[i].events & (EPOLLERR | EPOLLHUP))
+	    ev_bitmask |= CURL_CSELECT_ERR;
+	  socketaction(fd, ev_bitmask);
+	}
+      // and on timeouts (or new jobs)
+      if (r <= 0 || _havenewjob || (_curltimer && currentTime() >= _curltimer))
+	{
+	  _havenewjob = false;
+	  _curltimer = 0;
+	  socketaction(CURL_SOCKET_TIMEOUT, 0);
 	}
-      int r = select(maxfd + 1, &rset, &wset, &xset, &tv);
-      if (r == -1 && errno != EINTR)
-	ZYPP_THROW(MediaCurlException(_baseurl, "select() failed", "unknown error"));
-      if (r != 0 && _lookupworkers)
-	for (std::list<multifetchworker *>::iterator workeriter = _workers.begin(); workeriter != _workers.end(); ++workeriter)
-	  {
-	    multifetchworker *worker = *workeriter;
-	    if (worker->_state != WORKER_LOOKUP)
-	      continue;
-	    (*workeriter)->dnsevent(rset);
-	    if (worker->_state != WORKER_LOOKUP)
-	      _lookupworkers--;
-	  }
-      _havenewjob = false;
-
-      // run curl
-      for (;;)
-        {
-          CURLMcode mcode;
-	  int tasks;
-          mcode = curl_multi_perform(_multi, &tasks);
-          if (mcode == CURLM_CALL_MULTI_PERFORM)
-            continue;
-	  if (mcode != CURLM_OK)
-	    ZYPP_THROW(MediaCurlException(_baseurl, "curl_multi_perform", "unknown error"));
-	  break;
-        }
 
       double now = currentTime();
 
@@ -962,22 +1057,13 @@ multifetchrequest::run(std::vector<Url> &urllist)
 	}
 
       // wake up sleepers
-      if (_sleepworkers)
+      while (!_sleepers.empty() && _sleepers.begin()->first <= now)
 	{
-	  for (std::list<multifetchworker *>::iterator workeriter = _workers.begin(); workeriter != _workers.end(); ++workeriter)
-	    {
-	      multifetchworker *worker = *workeriter;
-	      if (worker->_state != WORKER_SLEEP)
-	        continue;
-	      if (worker->_sleepuntil > now)
-		continue;
-	      if (_minsleepuntil == worker->_sleepuntil)
-		_minsleepuntil = 0;
-	      XXX << "#" << worker->_workerno << ": sleep done, wake up" << endl;
-	      _sleepworkers--;
-	      // nextjob chnages the state
-	      worker->nextjob();
-	    }
+	  multifetchworker *worker = _sleepers.begin()->second;
+	  _sleepers.erase(_sleepers.begin());
+	  XXX << "#" << worker->_workerno << ": sleep done, wake up" << endl;
+	  // nextjob chnages the state
+	  worker->nextjob();
 	}
 
       // collect all curl results, reschedule new jobs
@@ -988,6 +1074,7 @@ multifetchrequest::run(std::vector<Url> &urllist)
 	    continue;
 	  CURL *easy = msg->easy_handle;
 	  CURLcode cc = msg->data.result;
+	  internal::countTransfer(easy);
 	  multifetchworker *worker;
 	  if (curl_easy_getinfo(easy, CURLINFO_PRIVATE, &worker) != CURLE_OK)
 	    ZYPP_THROW(MediaCurlException(_baseurl, "curl_easy_getinfo", "unknown error"));
@@ -1084,9 +1171,7 @@ multifetchrequest::run(std::vector<Url> &urllist)
 		  if (ratio > .01)
 		    {
 		      XXX << "#" << worker->_workerno << ": too slow ("<< ratio << ", " << worker->_avgspeed << ", #" << maxworkerno << ": " << maxavg << "), going to sleep for " << ratio * 1000 << " ms" << endl;
-		      worker->_sleepuntil = now + ratio;
-		      worker->_state = WORKER_SLEEP;
-		      _sleepworkers++;
+		      sleepworker(worker, now + ratio);
 		      continue;
 		    }
 		}
@@ -1115,7 +1200,7 @@ multifetchrequest::run(std::vector<Url> &urllist)
 	    {
 	      worker->_state = WORKER_BROKEN;
 	      _activeworkers--;
-	      if (!_activeworkers && !(urliter != urllist.end() && _workers.size() < MAXURLS))
+	      if (!_activeworkers && urliter == urllist.end())
 		{
 		  // end of workers reached! goodbye!
 		  worker->evaluateCurlCode(Pathname(), cc, false);
@@ -1523,6 +1608,7 @@ void MediaMultiCurl::multifetch(const Pathname & filename, FILE *fp, std::vector
       _multi = curl_multi_init();
       if (!_multi)
 	ZYPP_THROW(MediaCurlInitException(baseurl));
+      internal::limitSharedConnections(_multi);
     }
 
   multifetchrequest req(this, filename, baseurl, _multi, fp, report, blklist, filesize);
@@ -1530,8 +1616,6 @@ void MediaMultiCurl::multifetch(const Pathname & filename, FILE *fp, std::vector
   req._connect_timeout = _settings.connectTimeout();
   req._maxspeed = _settings.maxDownloadSpeed();
   req._maxworkers = _settings.maxConcurrentConnections();
-  if (req._maxworkers > MAXURLS)
-    req._maxworkers = MAXURLS;
   if (req._maxworkers <= 0)
     req._maxworkers = 1;
   std::vector<Url> myurllist;
@@ -14,6 +14,10 @@
 #include <unordered_set>
 #include <iterator>
 #include <stdio.h>
+#include <pwd.h>
+#include <limits.h>
+#include <unistd.h>
+#include <zypp/base/WorkerPool_p.h>
 #include <zypp/base/LogControl.h>
 #include <zypp/base/LogTools.h>
 #include <zypp/base/String.h>
@@ -188,6 +192,105 @@ namespace zypp
       return( it.findPackage( "lsof" ) && it->tag_edition() < Edition("4.90") && !it->tag_provides().count( Capability("backported-option-Ki") ) );
     }
 
+    /////////////////////////////////////////////////////////////////
+    /// \class ProcScan
+    /// \brief Deleted files used by a PID, collected from /proc.
+    ///
+    /// The data are remembered as lsof output lines (see \ref lsofLine),
+    /// so they pass the same filter as the ones read from lsof and
+    /// the debug output file stays usable as datasource.
+    ///
+    /// Like 'lsof -K i' just the main task is looked at. Only the
+    /// executable (\c txt) and the memory mapped files (\c DEL) are
+    /// of interest; files merely opened are rejected by the filter.
+    /////////////////////////////////////////////////////////////////
+    struct ProcScan
+    {
+      std::string _pline;		//!< the p-line (pcuLR)
+      std::vector<std::string> _lines;	//!< the f-lines (ftkn)
+    };
+
+    /** Build an lsof output line: NUL terminated \a fields_r followed by a NL. */
+    inline std::string lsofLine( std::initializer_list<std::string> fields_r )
+    {
+      std::string ret;
+      for ( const std::string & field : fields_r )
+      { ret += field; ret += '\0'; }
+      ret += '\n';
+      return ret;
+    }
+
+    /** Collect the deleted files used by \a pid_r into \a ret_r.
+     * Returns whether any file was found. The p-line is built only in this case.
+     */
+    bool scanPid( pid_t pid_r, ProcScan & ret_r )
+    {
+      static const std::string deleted { " (deleted)" };
+      const Pathname pidDir = Pathname("/proc") / asString(pid_r);
+
+      // the executable: the link target ends with ' (deleted)'. It's stripped,
+      // so the name matches the executables mapping found below.
+      char buf[PATH_MAX];
+      ssize_t len = ::readlink( (pidDir/"exe").c_str(), buf, sizeof(buf)-1 );
+      if ( len > 0 )
+      {
+        std::string exe( buf, len );
+        if ( str::hasSuffix( exe, deleted ) )
+          ret_r._lines.push_back( lsofLine( { "ftxt", "tREG", "k0", "n"+str::stripSuffix( exe, deleted ) } ) );
+      }
+
+      // mapped files: lsof reports them as DEL without the ' (deleted)'
+      std::ifstream maps( (pidDir/"maps").c_str() );
+      std::unordered_set<std::string> seen;
+      for ( std::string line; std::getline( maps, line ); )
+      {
+        if ( ! str::hasSuffix( line, deleted ) )
+          continue;
+        std::string::size_type pos = line.find( " /" );	// the pathname column (no '/' before)
+        if ( pos == std::string::npos )
+          continue;
+        std::string name( line, pos+1, line.size()-pos-1-deleted.size() );
+        if ( seen.insert( name ).second )
+          ret_r._lines.push_back( lsofLine( { "fDEL", "tREG", "n"+name } ) );
+      }
+
+      if ( ret_r._lines.empty() )
+        return false;
+
+      std::string comm;
+      std::string ppid;
+      std::string uid;
+      std::ifstream status( (pidDir/"status").c_str() );
+      for ( std::string line; std::getline( status, line ); )
+      {
+        if ( str::hasPrefix( line, "Name:" ) )
+          comm = str::trim( line.substr( 5 ) );
+        else if ( str::hasPrefix( line, "PPid:" ) )
+          ppid = str::trim( line.substr( 5 ) );
+        else if ( str::hasPrefix( line, "Uid:" ) )
+        {
+          std::vector<std::string> words;
+          str::split( line.substr( 4 ), std::back_inserter(words) );
+          if ( ! words.empty() )
+            uid = words[0];	// the real uid
+          break;		// Uid follows Name and PPid
+        }
+      }
+
+      std::string login;
+      if ( ! uid.empty() )
+      {
+        struct passwd pwd;
+        struct passwd * result = nullptr;
+        char pwbuf[1024];
+        if ( ::getpwuid_r( str::strtonum<uid_t>( uid ), &pwd, pwbuf, sizeof(pwbuf), &result ) == 0 && result )
+          login = result->pw_name;
+      }
+
+      ret_r._pline = lsofLine( { "p"+asString(pid_r), "c"+comm, "u"+uid, "L"+login, "R"+ppid } );
+      return true;
+    }
+
   } //namespace
   /////////////////////////////////////////////////////////////////
 
@@ -200,6 +303,7 @@ namespace zypp
     void addCacheIf( CacheEntry & cache_r, const std::string & line_r, std::vector<std::string> *debMap = nullptr );
 
     std::map<pid_t,CacheEntry> filterInput( externalprogram::ExternalDataSource &source );
+    std::map<pid_t,CacheEntry> scanProc();
     CheckAccessDeleted::size_type createProcInfo( const std::map<pid_t,CacheEntry> &in );
 
     std::vector<CheckAccessDeleted::ProcInfo> _data;
@@ -263,8 +367,9 @@ namespace zypp
           if ( pinfo.command.empty() ) {
             commandname = &*(ch+1);
             // the lsof command name might be truncated, so we prefer /proc/<pid>/exe
+            // (without the ' (deleted)' appended if the executable was deleted)
             if (!_fromLsofFileMode)
-              pinfo.command = filesystem::readlink( Pathname("/proc")/pinfo.pid/"exe" ).basename();
+              pinfo.command = str::stripSuffix( filesystem::readlink( Pathname("/proc")/pinfo.pid/"exe" ).basename(), " (deleted)" );
             if ( pinfo.command.empty() )
               pinfo.command = std::move(commandname);
             if ( debMap )
@@ -427,15 +532,69 @@ namespace zypp
     return cachemap;
   }
 
+  std::map<pid_t,CacheEntry> CheckAccessDeleted::Impl::scanProc()
+  {
+    // cachemap: PID => (deleted files)
+    // NOTE: omit PIDs running in a (lxc/docker) container
+    std::map<pid_t,CacheEntry> cachemap;
+
+    bool debugEnabled = !_debugFile.empty();
+
+    std::vector<pid_t> pids;
+    filesystem::dirForEach( "/proc", [&pids]( const Pathname &, const char *const name_r ) {
+      if ( *name_r >= '1' && *name_r <= '9' )
+        pids.push_back( str::strtonum<pid_t>( name_r ) );
+      return true;
+    });
+
+    std::vector<ProcScan> scans( pids.size() );
+    FilterRunsInContainer runsInLXC;
+    MIL << "Silently scanning /proc for " << pids.size() << " processes..." << endl;
+    zypp::base::LogControl::TmpLineWriter shutUp;	// suppress excessive readdir etc. logging in runsInLXC
+    parallelFor( pids.size(), [&]( size_t idx_r ) {
+      // Processes may vanish meanwhile, which simply leaves no data.
+      ProcScan & scan { scans[idx_r] };
+      if ( scanPid( pids[idx_r], scan ) && runsInLXC( pids[idx_r] ) )
+        scan._lines.clear();	// ignore this pid
+    });
+
+    for ( size_t idx = 0; idx < pids.size(); ++idx )
+    {
+      ProcScan & scan { scans[idx] };
+      if ( scan._lines.empty() )
+        continue;
+
+      pid_t cachepid = pids[idx];
+      if ( debugEnabled ) {
+        auto &pidMad = debugMap[cachepid];
+        if ( pidMad.empty() )
+          pidMad.push_back( scan._pline );
+        else
+          pidMad.front() = scan._pline;
+      }
+      CacheEntry & entry { cachemap[cachepid] };
+      entry.first.swap( scan._pline );
+      for ( const std::string & line : scan._lines )
+        addCacheIf( entry, line, debugEnabled ? &debugMap[cachepid] : nullptr );
+    }
+    return cachemap;
+  }
+
   CheckAccessDeleted::size_type CheckAccessDeleted::check( bool verbose_r  )
   {
+    _pimpl->_verbose = verbose_r;
+    _pimpl->_fromLsofFileMode = false;
+
+    // Scanning /proc ourselves is much faster than having lsof stat every
+    // open file of every process. lsof remains the fallback if /proc is not
+    // usable or $ZYPP_CHECKACCESSDELETED_LSOF is set.
+    if ( ! ::getenv( "ZYPP_CHECKACCESSDELETED_LSOF" ) && PathInfo( "/proc/self/maps" ).isFile() )
+      return _pimpl->createProcInfo( _pimpl->scanProc() );
+
     static const char* argv[] = { "lsof", "-n", "-FpcuLRftkn0", "-K", "i", NULL };
     if ( lsofNoOptKi() )
       argv[3] = NULL;
 
-    _pimpl->_verbose = verbose_r;
-    _pimpl->_fromLsofFileMode = false;
-
     ExternalProgram prog( argv, ExternalProgram::Discard_Stderr );
     std::map<pid_t,CacheEntry> cachemap;
 
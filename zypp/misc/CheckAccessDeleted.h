@@ -84,6 +84,10 @@ namespace zypp
        * A verbose check will omit this test and collect all processes using
        * any deleted file.
        *
+       * The data are collected by scanning \c /proc in parallel. If \c /proc
+       * is not usable or \c $ZYPP_CHECKACCESSDELETED_LSOF is set, \c lsof
+       * is run instead.
+       *
        * \return the number of processes found.
        * \throws Exception On error collecting the data (e.g. no lsof installed)
        */
@@ -9,6 +9,10 @@
 /** \file	zypp/pool/PoolImpl.cc
  *
 */
+extern "C"
+{
+#include <solv/repo.h>
+}
 #include <iostream>
 #include <zypp/base/LogTools.h>
 
@@ -52,6 +56,167 @@ namespace zypp
     PoolImpl::~PoolImpl()
     {}
 
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** The \ref PoolImpl::id2item key of \a solv_r. */
+      inline sat::detail::IdType id2itemKey( const sat::Solvable & solv_r )
+      {
+        sat::detail::IdType id = solv_r.ident().id();
+        if ( solv_r.isKind( ResKind::srcpackage ) )
+          id = -id;
+        return id;
+      }
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
+    const PoolImpl::ContainerT & PoolImpl::store() const
+    {
+      checkSerial();
+      if ( _storeDirty )
+      {
+        sat::Pool pool( satpool() );
+        bool addedItems = false;
+        bool reusedIDs = _watcherIDs.remember( pool.serialIDs() );
+        std::list<PoolItem> addedProducts;
+
+        SolvableIdType oldCapacity = _store.size();
+        SolvableIdType capacity = pool.capacity();
+        if ( capacity < oldCapacity )
+          reusedIDs = true;	// can't happen without, but be safe
+
+        // The id ranges to check. Unless IDs were reused, a solvable id is not
+        // handed out again. So only the ranges of the repos added, removed or
+        // changed since the last update, and the ids beyond the old capacity
+        // may have changed.
+        std::map<sat::detail::RepoIdType,std::tuple<SolvableIdType,SolvableIdType,size_type>> repoRanges;
+        for_( it, pool.reposBegin(), pool.reposEnd() )
+        {
+          sat::detail::CRepo * repo = Repository( *it ).get();
+          repoRanges[repo] = std::make_tuple( SolvableIdType(repo->start), SolvableIdType(repo->end), size_type(repo->nsolvables) );
+        }
+
+        std::vector<std::pair<SolvableIdType,SolvableIdType>> ranges;
+        if ( reusedIDs )
+        {
+          ranges.push_back( std::make_pair( 1, capacity ) );
+        }
+        else
+        {
+          for ( const auto & old : _repoRanges )
+          {
+            auto it = repoRanges.find( old.first );
+            if ( it == repoRanges.end() || it->second != old.second )
+              ranges.push_back( std::make_pair( std::get<0>(old.second), std::min( std::get<1>(old.second), capacity ) ) );
+          }
+          for ( const auto & now : repoRanges )
+          {
+            auto it = _repoRanges.find( now.first );
+            if ( it == _repoRanges.end() || it->second != now.second )
+              ranges.push_back( std::make_pair( std::get<0>(now.second), std::get<1>(now.second) ) );
+          }
+          if ( capacity > oldCapacity )
+            ranges.push_back( std::make_pair( std::max( oldCapacity, SolvableIdType(1) ), capacity ) );
+        }
+        _repoRanges.swap( repoRanges );
+
+        // A valid _id2item is updated along with the store.
+        if ( reusedIDs )
+        {
+          _id2itemDirty = true;
+          _id2item.clear();
+        }
+        bool updateId2item = ! _id2itemDirty;
+
+        _store.resize( capacity );
+        _storeIdent.resize( capacity );
+
+        auto id2itemErase = [this]( sat::detail::IdType key_r, const PoolItem & pi_r ) {
+          auto range = _id2item.equal_range( key_r );
+          for ( auto it = range.first; it != range.second; ++it )
+          {
+            if ( it->second == pi_r )
+            {
+              _id2item.erase( it );
+              break;
+            }
+          }
+        };
+
+        unsigned checked = 0;
+        for ( const auto & range : ranges )
+        {
+          for ( SolvableIdType i = range.first; i < range.second; ++i )
+          {
+            ++checked;
+            sat::Solvable s( i );
+            PoolItem & pi( _store[i] );
+            if ( ! s &&  pi )
+            {
+              // the PoolItem got invalidated (e.g unloaded repo)
+              if ( updateId2item )
+                id2itemErase( _storeIdent[i], pi );
+              pi = PoolItem();
+            }
+            else if ( reusedIDs || (s && ! pi) )
+            {
+              // new PoolItem to add
+              pi = PoolItem::makePoolItem( s ); // the only way to create a new one!
+              _storeIdent[i] = id2itemKey( s );
+              if ( updateId2item )
+                _id2item.insert( std::make_pair( _storeIdent[i], pi ) );
+              // remember products for buddy processing (requires clean store)
+              if ( s.isKind( ResKind::product ) )
+                addedProducts.push_back( pi );
+              if ( !addedItems )
+                addedItems = true;
+            }
+          }
+        }
+        _storeDirty = false;
+        DBG << "Updated store: checked " << checked << " of " << capacity << " ids" << endl;
+
+        // Now, as the pool is adjusted, ....
+
+        // .... we check for product buddies.
+        if ( ! addedProducts.empty() )
+        {
+          for_( it, addedProducts.begin(), addedProducts.end() )
+          {
+            it->setBuddy( asKind<Product>(*it)->referencePackage() );
+          }
+        }
+
+        // .... we must reapply those query based hard locks.
+        if ( addedItems )
+        {
+          reapplyHardLocks();
+        }
+
+        // Compute the initial status of Patches etc.
+        if ( !_establishedStates )
+          _establishedStates.reset( new EstablishedStatesImpl );
+      }
+      return _store;
+    }
+
+    const PoolImpl::Id2ItemT & PoolImpl::id2item () const
+    {
+      store();	// updates a valid _id2item
+      if ( _id2itemDirty )
+      {
+        _id2item = Id2ItemT( size() );
+        for ( SolvableIdType i = 0; i < _store.size(); ++i )
+        {
+          if ( _store[i] )
+            _id2item.insert( std::make_pair( _storeIdent[i], _store[i] ) );
+        }
+        //INT << _id2item << endl;
+        _id2itemDirty = false;
+      }
+      return _id2item;
+    }
+
     /////////////////////////////////////////////////////////////////
   } // namespace pool
   ///////////////////////////////////////////////////////////////////
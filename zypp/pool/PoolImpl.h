@@ -13,6 +13,9 @@
 #define ZYPP_POOL_POOLIMPL_H
 
 #include <iosfwd>
+#include <map>
+#include <tuple>
+#include <vector>
 
 #include <zypp/base/Easy.h>
 #include <zypp/base/LogTools.h>
@@ -360,87 +363,17 @@ namespace zypp
        }
 
       public:
-        const ContainerT & store() const
-        {
-          checkSerial();
-          if ( _storeDirty )
-          {
-            sat::Pool pool( satpool() );
-            bool addedItems = false;
-	    bool reusedIDs = _watcherIDs.remember( pool.serialIDs() );
-            std::list<PoolItem> addedProducts;
-
-	    _store.resize( pool.capacity() );
-
-            if ( pool.capacity() )
-            {
-              for ( sat::detail::SolvableIdType i = pool.capacity()-1; i != 0; --i )
-              {
-                sat::Solvable s( i );
-                PoolItem & pi( _store[i] );
-                if ( ! s &&  pi )
-                {
-                  // the PoolItem got invalidated (e.g unloaded repo)
-                  pi = PoolItem();
-                }
-                else if ( reusedIDs || (s && ! pi) )
-                {
-                  // new PoolItem to add
-                  pi = PoolItem::makePoolItem( s ); // the only way to create a new one!
-                  // remember products for buddy processing (requires clean store)
-                  if ( s.isKind( ResKind::product ) )
-                    addedProducts.push_back( pi );
-                  if ( !addedItems )
-                    addedItems = true;
-                }
-              }
-            }
-            _storeDirty = false;
-
-            // Now, as the pool is adjusted, ....
-
-            // .... we check for product buddies.
-            if ( ! addedProducts.empty() )
-            {
-              for_( it, addedProducts.begin(), addedProducts.end() )
-              {
-                it->setBuddy( asKind<Product>(*it)->referencePackage() );
-              }
-            }
-
-            // .... we must reapply those query based hard locks.
-            if ( addedItems )
-            {
-              reapplyHardLocks();
-            }
-
-	    // Compute the initial status of Patches etc.
-            if ( !_establishedStates )
-	      _establishedStates.reset( new EstablishedStatesImpl );
-          }
-          return _store;
-        }
+        /** The PoolItems indexed by solvable id.
+         * After the sat pool changed, only the solvable id ranges of the
+         * repos added, removed or changed since the last call are updated
+         * (unless the sat pool reused the IDs).
+         */
+        const ContainerT & store() const;
 
-	const Id2ItemT & id2item () const
-	{
-	  checkSerial();
-	  if ( _id2itemDirty )
-	  {
-	    store();
-	    _id2item = Id2ItemT( size() );
-            for_( it, begin(), end() )
-            {
-              const sat::Solvable &s = (*it)->satSolvable();
-              sat::detail::IdType id = s.ident().id();
-              if ( s.isKind( ResKind::srcpackage ) )
-                id = -id;
-              _id2item.insert( std::make_pair( id, *it ) );
-            }
-            //INT << _id2item << endl;
-	    _id2itemDirty = false;
-          }
-	  return _id2item;
-	}
+        /** The PoolItems indexed by ident (negative for srcpackages).
+         * Once built, it's updated by \ref store along with the changed items.
+         */
+        const Id2ItemT & id2item () const;
 
         ///////////////////////////////////////////////////////////////////
         //
@@ -456,8 +389,6 @@ namespace zypp
         void invalidate() const
         {
           _storeDirty = true;
-	  _id2itemDirty = true;
-	  _id2item.clear();
           _poolProxy.reset();
 	  _establishedStates.reset();
         }
@@ -471,6 +402,10 @@ namespace zypp
         mutable DefaultIntegral<bool,true>    _storeDirty;
 	mutable Id2ItemT		      _id2item;
         mutable DefaultIntegral<bool,true>    _id2itemDirty;
+	/** The \ref id2item key of each item in \ref _store. */
+	mutable std::vector<sat::detail::IdType> _storeIdent;
+	/** Solvable id range and size of each repo as of the last \ref store update. */
+	mutable std::map<sat::detail::RepoIdType,std::tuple<SolvableIdType,SolvableIdType,size_type>> _repoRanges;
 
       private:
         mutable shared_ptr<ResPoolProxy>      _poolProxy;
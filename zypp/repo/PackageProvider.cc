@@ -13,6 +13,7 @@
 #include <fstream>
 #include <sstream>
 #include <zypp/repo/PackageDelta.h>
+#include <zypp/repo/VerifiedFileIndex_p.h>
 #include <zypp/base/Logger.h>
 #include <zypp/base/Gettext.h>
 #include <zypp/base/UserRequestException.h>
@@ -385,8 +386,9 @@ namespace zypp
 	  const OnMediaLocation & loc( _package->location() );
 	  if ( ! loc.checksum().empty() )	// no cache hit without checksum
 	  {
-	    PathInfo pi( topCache.repoPackagesCachePath / info.packagesPath().basename() / info.path() / loc.filename() );
-	    if ( pi.isExist() && loc.checksum() == CheckSum( loc.checksum().type(), std::ifstream( pi.c_str() ) ) )
+	    const Pathname & topDir( topCache.repoPackagesCachePath / info.packagesPath().basename() );
+	    PathInfo pi( topDir / info.path() / loc.filename() );
+	    if ( pi.isExist() && repo::VerifiedFileIndex::check( topDir, pi.path(), loc.checksum() ) )
 	    {
 	      report()->start( _package, pi.path().asFileUrl() );
 	      const Pathname & dest( info.packagesPath() / info.path() / loc.filename() );
@@ -509,6 +511,9 @@ namespace zypp
 	throw;
       }
 
+      // The file checker verified the download; record it for the next cache lookup.
+      repo::VerifiedFileIndex::persist( info.packagesPath(), ret, _package->location().checksum() );
+
       report()->finish( _package, repo::DownloadResolvableReport::NO_ERROR, std::string() );
       MIL << "provided Package " << _package << " at " << ret << endl;
       return ret;
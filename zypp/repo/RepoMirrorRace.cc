@@ -0,0 +1,301 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/RepoMirrorRace.cc
+ *
+*/
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <memory>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/String.h>
+#include <zypp/base/IOStream.h>
+#include <zypp/PathInfo.h>
+#include <zypp/media/MediaException.h>
+#include <zypp/media/CurlHelper.h>
+
+#include <zypp/repo/RepoMirrorRace.h>
+
+using std::endl;
+
+#undef  ZYPP_BASE_LOGGER_LOGGROUP
+#define ZYPP_BASE_LOGGER_LOGGROUP "zypp::repo::RepoMirrorRace"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  {
+    ///////////////////////////////////////////////////////////////////
+    // MirrorStats
+    ///////////////////////////////////////////////////////////////////
+
+    MirrorStats MirrorStats::fromFile( const Pathname & file_r )
+    {
+      MirrorStats ret;
+      std::ifstream str( file_r.c_str() );
+      // <avgSeconds> <samples> <lastFailed> <url>
+      iostr::forEachLine( str, [&ret]( int, std::string line_r )->bool {
+	std::vector<std::string> words;
+	if ( str::split( line_r, std::back_inserter(words) ) == 4 )
+	{
+	  Entry & entry( ret._stats[words[3]] );
+	  entry.avgSeconds = str::strtonum<double>( words[0] );
+	  entry.samples    = str::strtonum<unsigned>( words[1] );
+	  entry.lastFailed = str::strToBool( words[2], false );
+	}
+	return true;
+      } );
+      return ret;
+    }
+
+    void MirrorStats::saveToFile( const Pathname & file_r ) const
+    {
+      std::ofstream str( file_r.c_str(), std::ios_base::out|std::ios_base::trunc );
+      if ( ! str )
+      {
+	WAR << "Can't write " << file_r << endl;
+	return;
+      }
+      for ( const auto & el : _stats )
+	str << el.second.avgSeconds << " " << el.second.samples << " " << (el.second.lastFailed ? "1" : "0") << " " << el.first << endl;
+    }
+
+    void MirrorStats::addSample( const Url & url_r, double seconds_r )
+    {
+      Entry & entry( _stats[url_r.asString()] );
+      // A moving average, so mirrors getting faster or slower are noticed.
+      if ( entry.samples )
+	entry.avgSeconds = ( 3 * entry.avgSeconds + seconds_r ) / 4;
+      else
+	entry.avgSeconds = seconds_r;
+      ++entry.samples;
+      entry.lastFailed = false;
+    }
+
+    void MirrorStats::addFailure( const Url & url_r )
+    { _stats[url_r.asString()].lastFailed = true; }
+
+    MirrorStats::Entry MirrorStats::get( const Url & url_r ) const
+    {
+      auto it( _stats.find( url_r.asString() ) );
+      return it == _stats.end() ? Entry() : it->second;
+    }
+
+    std::vector<Url> MirrorStats::rank( std::vector<Url> urls_r ) const
+    {
+      if ( empty() )
+	return urls_r;
+
+      // 0: known good, 1: unknown, 2: last probe failed
+      auto group = [this]( const Url & url_r ) -> int {
+	Entry entry( get( url_r ) );
+	return entry.lastFailed ? 2 : entry.samples ? 0 : 1;
+      };
+      std::stable_sort( urls_r.begin(), urls_r.end(), [&]( const Url & lhs, const Url & rhs ) {
+	int lgroup = group( lhs );
+	int rgroup = group( rhs );
+	if ( lgroup != rgroup )
+	  return lgroup < rgroup;
+	if ( lgroup == 0 )
+	  return get( lhs ).avgSeconds < get( rhs ).avgSeconds;
+	return false;
+      } );
+      return urls_r;
+    }
+
+    ///////////////////////////////////////////////////////////////////
+    // raceMirrors
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** One HEAD request in the race. */
+      struct Probe
+      {
+	Probe( size_t idx_r, const Url & url_r )
+	: _idx( idx_r )
+	, _url( url_r )
+	{}
+
+	Probe( const Probe & ) = delete;
+	Probe & operator=( const Probe & ) = delete;
+
+	~Probe()
+	{ if ( _easy ) curl_easy_cleanup( _easy ); }
+
+	/** Setup the easy handle; returns false if the URL can't be probed. */
+	bool setup( const Pathname & probefile_r )
+	{
+	  media::TransferSettings settings;
+	  try
+	  {
+	    internal::fillSettingsFromUrl( _url, settings );
+	    if ( settings.proxy().empty() )
+	      internal::fillSettingsSystemProxy( _url, settings );
+	  }
+	  catch ( const media::MediaException & excpt )
+	  {
+	    ZYPP_CAUGHT( excpt );
+	    return false;
+	  }
+
+	  Url probeurl( internal::clearQueryString( _url ) );
+	  probeurl.setPathName( Pathname( probeurl.getPathName() ) / probefile_r );
+	  _request = probeurl.asString();
+
+	  _easy = curl_easy_init();
+	  if ( ! _easy )
+	    return false;
+	  internal::useGlobalShare( _easy );	// the winners connection is reused by the download
+	  curl_easy_setopt( _easy, CURLOPT_URL, _request.c_str() );
+	  curl_easy_setopt( _easy, CURLOPT_NOBODY, 1L );
+	  curl_easy_setopt( _easy, CURLOPT_NOSIGNAL, 1L );
+	  curl_easy_setopt( _easy, CURLOPT_FOLLOWLOCATION, 1L );
+	  curl_easy_setopt( _easy, CURLOPT_MAXREDIRS, 6L );
+	  curl_easy_setopt( _easy, CURLOPT_CONNECTTIMEOUT, settings.connectTimeout() );
+	  curl_easy_setopt( _easy, CURLOPT_TIMEOUT, settings.connectTimeout() * 2 );
+	  curl_easy_setopt( _easy, CURLOPT_USERAGENT, settings.userAgentString().c_str() );
+	  if ( settings.userPassword().size() )
+	    curl_easy_setopt( _easy, CURLOPT_USERPWD, settings.userPassword().c_str() );
+	  if ( _url.getScheme() == "https" )
+	  {
+	    if ( settings.verifyPeerEnabled() || settings.verifyHostEnabled() )
+	      curl_easy_setopt( _easy, CURLOPT_CAPATH, settings.certificateAuthoritiesPath().c_str() );
+	    curl_easy_setopt( _easy, CURLOPT_SSL_VERIFYPEER, settings.verifyPeerEnabled() ? 1L : 0L );
+	    curl_easy_setopt( _easy, CURLOPT_SSL_VERIFYHOST, settings.verifyHostEnabled() ? 2L : 0L );
+	  }
+	  if ( settings.proxyEnabled() && ! settings.proxy().empty() )
+	  {
+	    curl_easy_setopt( _easy, CURLOPT_PROXY, settings.proxy().c_str() );
+	    if ( settings.proxyUserPassword().size() )
+	      curl_easy_setopt( _easy, CURLOPT_PROXYUSERPWD, settings.proxyUserPassword().c_str() );
+	  }
+	  else if ( settings.proxy() == EXPLICITLY_NO_PROXY )
+	    curl_easy_setopt( _easy, CURLOPT_NOPROXY, "*" );
+	  return true;
+	}
+
+	/** Whether the server is alive and has the file.
+	 * Authentication errors are fine, as credentials are
+	 * asked for by the real download.
+	 */
+	bool succeeded( CURLcode result_r ) const
+	{
+	  if ( result_r != CURLE_OK )
+	    return false;
+	  if ( ! str::startsWith( _url.getScheme(), "http" ) )
+	    return true;
+	  long code = 0;
+	  curl_easy_getinfo( _easy, CURLINFO_RESPONSE_CODE, &code );
+	  return( code < 400 || code == 401 || code == 403 || code == 405 );
+	}
+
+	double seconds() const
+	{
+	  double ret = 0.0;
+	  curl_easy_getinfo( _easy, CURLINFO_TOTAL_TIME, &ret );
+	  return ret;
+	}
+
+	size_t _idx;
+	Url _url;
+	std::string _request;
+	CURL * _easy = nullptr;
+      };
+    } // namespace
+
+    std::vector<Url> raceMirrors( const std::vector<Url> & urls_r, const Pathname & probefile_r, unsigned count_r, MirrorStats & stats_r )
+    {
+      if ( count_r < 2 || urls_r.size() < 2 )
+	return urls_r;
+
+      internal::globalInitCurlOnce();
+      CURLM * multi = curl_multi_init();
+      if ( ! multi )
+	return urls_r;
+      internal::limitSharedConnections( multi );
+
+      std::vector<std::unique_ptr<Probe>> probes;
+      for ( size_t i = 0; i < urls_r.size() && probes.size() < count_r; ++i )
+      {
+	if ( ! urls_r[i].schemeIsDownloading() )
+	  continue;
+	std::unique_ptr<Probe> probe( new Probe( i, urls_r[i] ) );
+	if ( probe->setup( probefile_r ) && curl_multi_add_handle( multi, probe->_easy ) == CURLM_OK )
+	  probes.push_back( std::move(probe) );
+      }
+
+      int winner = -1;
+      std::vector<bool> failed( urls_r.size(), false );
+      if ( probes.size() >= 2 )
+      {
+	MIL << "Racing " << probes.size() << " URLs for " << probefile_r << endl;
+	int running = probes.size();
+	while ( winner < 0 && running )
+	{
+	  if ( curl_multi_perform( multi, &running ) != CURLM_OK )
+	    break;
+
+	  int left = 0;
+	  while ( CURLMsg * msg = curl_multi_info_read( multi, &left ) )
+	  {
+	    if ( msg->msg != CURLMSG_DONE )
+	      continue;
+	    auto it = std::find_if( probes.begin(), probes.end(), [msg]( const std::unique_ptr<Probe> & p ) { return p->_easy == msg->easy_handle; } );
+	    if ( it == probes.end() )
+	      continue;
+
+	    const Probe & probe( **it );
+	    if ( probe.succeeded( msg->data.result ) )
+	    {
+	      DBG << "Probe " << probe._url << " succeeded in " << probe.seconds() << "s" << endl;
+	      stats_r.addSample( probe._url, probe.seconds() );
+	      winner = probe._idx;
+	      break;	// the rest is cancelled
+	    }
+	    DBG << "Probe " << probe._url << " failed: " << curl_easy_strerror( msg->data.result ) << endl;
+	    stats_r.addFailure( probe._url );
+	    failed[probe._idx] = true;
+	  }
+
+	  if ( winner < 0 && running )
+	    curl_multi_wait( multi, nullptr, 0, 100, nullptr );
+	}
+      }
+
+      for ( const auto & probe : probes )
+	curl_multi_remove_handle( multi, probe->_easy );
+      probes.clear();
+      curl_multi_cleanup( multi );
+
+      if ( winner < 0 )
+      {
+	MIL << "No URL won the race, keeping the order." << endl;
+	return urls_r;
+      }
+
+      std::vector<Url> ret;
+      ret.reserve( urls_r.size() );
+      ret.push_back( urls_r[winner] );
+      for ( size_t i = 0; i < urls_r.size(); ++i )
+	if ( int(i) != winner && ! failed[i] )
+	  ret.push_back( urls_r[i] );
+      for ( size_t i = 0; i < urls_r.size(); ++i )
+	if ( failed[i] )
+	  ret.push_back( urls_r[i] );
+      MIL << "Race winner: " << ret.front() << endl;
+      return ret;
+    }
+
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
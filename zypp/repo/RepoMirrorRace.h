@@ -0,0 +1,96 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/RepoMirrorRace.h
+ *
+*/
+#ifndef ZYPP_REPO_REPOMIRRORRACE_H
+#define ZYPP_REPO_REPOMIRRORRACE_H
+
+#include <map>
+#include <vector>
+
+#include <zypp/Url.h>
+#include <zypp/Pathname.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// \class MirrorStats
+    /// \brief Response time statistics for a repos base URLs.
+    ///
+    /// Remembers a moving average of the probe times and whether the
+    /// last probe of an URL failed. The data are kept in a small text
+    /// file in the repos raw metadata cache, so the next refresh can
+    /// \ref rank the URLs by past performance. The file is updated
+    /// along with the metadata, i.e. only if the refresh succeeds.
+    ///////////////////////////////////////////////////////////////////
+    class MirrorStats
+    {
+    public:
+      /** Per URL data. */
+      struct Entry
+      {
+	double   avgSeconds = 0.0;	///< moving average of successful probes
+	unsigned samples = 0;		///< number of successful probes
+	bool     lastFailed = false;	///< whether the last probe failed
+      };
+
+    public:
+      /** Read the statistics from \a file_r (empty if it does not exist). */
+      static MirrorStats fromFile( const Pathname & file_r );
+
+      /** Write the statistics to \a file_r. */
+      void saveToFile( const Pathname & file_r ) const;
+
+    public:
+      /** Remember a successful probe of \a url_r which took \a seconds_r. */
+      void addSample( const Url & url_r, double seconds_r );
+
+      /** Remember a failed probe of \a url_r. */
+      void addFailure( const Url & url_r );
+
+      /** The data remembered for \a url_r (default constructed if unknown). */
+      Entry get( const Url & url_r ) const;
+
+      /** Order \a urls_r by past performance.
+       * URLs known to be fast come first (fastest first), followed by the
+       * unknown ones and finally the ones whose last probe failed. URLs
+       * within the same group keep their original order.
+       */
+      std::vector<Url> rank( std::vector<Url> urls_r ) const;
+
+      bool empty() const
+      { return _stats.empty(); }
+
+    private:
+      std::map<std::string,Entry> _stats;	// by Url::asString (no password)
+    };
+
+    /** Probe up to \a count_r of the \a urls_r at the same time and return them reordered.
+     *
+     * A HEAD request for \a probefile_r (relative to the URL) is sent to the
+     * first \a count_r network URLs in parallel. The first one responding
+     * wins and is moved to the front. The remaining probes are cancelled,
+     * URLs whose probe failed before are moved to the end. Probe times and
+     * failures are recorded in \a stats_r. Non-network URLs are not probed
+     * and keep their position relative to the others.
+     *
+     * If no probe succeeds, \a urls_r are returned unchanged.
+     */
+    std::vector<Url> raceMirrors( const std::vector<Url> & urls_r, const Pathname & probefile_r, unsigned count_r, MirrorStats & stats_r );
+
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_REPO_REPOMIRRORRACE_H
@@ -215,6 +215,7 @@ namespace zypp
 
       public:
         ProvideFilePolicy _defaultPolicy;
+        Pathname _prefetchPath;
     };
     ///////////////////////////////////////////////////////////////////
 
@@ -232,6 +233,9 @@ namespace zypp
     const ProvideFilePolicy & RepoMediaAccess::defaultPolicy() const
     { return _impl->_defaultPolicy; }
 
+    void RepoMediaAccess::setPrefetchPath( const Pathname & path_r )
+    { _impl->_prefetchPath = path_r; }
+
     ManagedFile RepoMediaAccess::provideFile( RepoInfo repo_r,
                                               const OnMediaLocation & loc_rx,
                                               const ProvideFilePolicy & policy_r )
@@ -258,6 +262,11 @@ namespace zypp
       Fetcher fetcher;
       fetcher.addCachePath( repo_r.packagesPath() );
       MIL << "Added cache path " << repo_r.packagesPath() << endl;
+      if ( ! _impl->_prefetchPath.empty() )
+      {
+        fetcher.addCachePath( _impl->_prefetchPath / repo_r.alias() );
+        MIL << "Added prefetch path " << _impl->_prefetchPath / repo_r.alias() << endl;
+      }
 
       // Test whether download destination is writable, if not
       // switch into the tmpspace (e.g. bnc#755239, download and
@@ -81,6 +81,13 @@ namespace zypp
       ManagedFile provideFile( RepoInfo repo_r, const OnMediaLocation & loc_r )
       { return provideFile( repo_r, loc_r, defaultPolicy() ); }
 
+      /** Also look for files prefetched into <tt>path_r/<repo alias>/</tt>.
+       * Files found there are used if their checksum matches and are validated
+       * like downloaded ones. An empty \a path_r turns this off.
+       * \see \ref target::CommitPackagePrefetcher
+       */
+      void setPrefetchPath( const Pathname & path_r );
+
     public:
       /** Set a new default \ref ProvideFilePolicy. */
       void setDefaultPolicy( const ProvideFilePolicy & policy_r );
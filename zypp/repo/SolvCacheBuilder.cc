@@ -0,0 +1,280 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/SolvCacheBuilder.cc
+ *
+*/
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/knownid.h>
+#include <solv/repo_write.h>
+#include <solv/repo_rpmmd.h>
+#include <solv/repo_repomdxml.h>
+#include <solv/repo_updateinfoxml.h>
+#include <solv/repo_deltainfoxml.h>
+#include <solv/repo_susetags.h>
+#include <solv/repo_content.h>
+#include <solv/repo_autopattern.h>
+#include <solv/solv_xfopen.h>
+}
+
+#include <iostream>
+#include <list>
+#include <vector>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/Gettext.h>
+#include <zypp/base/String.h>
+#include <zypp/AutoDispose.h>
+#include <zypp/PathInfo.h>
+
+#include <zypp/parser/yum/RepomdFileReader.h>
+#include <zypp/repo/RepoException.h>
+#include <zypp/repo/SolvCacheBuilder.h>
+#include <zypp/sat/Pool.h>
+
+using std::endl;
+
+#undef  ZYPP_BASE_LOGGER_LOGGROUP
+#define ZYPP_BASE_LOGGER_LOGGROUP "zypp::repo::SolvCacheBuilder"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace env
+  {
+    /** Use the external repo2solv tool to build the solv files */
+    inline bool ZYPP_REPO2SOLV()
+    {
+      const char * env = getenv("ZYPP_REPO2SOLV");
+      return( env && str::strToBool( env, true ) );
+    }
+  } // namespace env
+  ///////////////////////////////////////////////////////////////////
+
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  {
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** A private libsolv pool holding the one repo we build. */
+      struct SolvBuildPool
+      {
+	SolvBuildPool()
+	: _pool( ::pool_create() )
+	, _repo( ::repo_create( _pool, "" ) )
+	{}
+
+	~SolvBuildPool()
+	{ ::pool_free( _pool ); }	// frees the repo as well
+
+	std::string errstr() const
+	{ return ::pool_errstr( _pool ); }
+
+	::s_Pool * _pool;
+	::s_Repo * _repo;
+      };
+
+      /** Open a (maybe compressed) metadata file; compression is guessed from the files suffix. */
+      AutoFILE xfopen( const Pathname & file_r )
+      {
+	AutoFILE ret( ::solv_xfopen( file_r.c_str(), "r" ) );
+	if ( ! ret )
+	{
+	  ZYPP_THROW( RepoException( str::form( _("Can't open file '%s' for reading."), file_r.c_str() ) ) );
+	}
+	return ret;
+      }
+
+      /** Call a libsolv reader on \a file_r and throw if it fails. */
+      template <class TReader>
+      void addFile( SolvBuildPool & spool_r, const Pathname & file_r, TReader && reader_r )
+      {
+	DBG << "Adding " << file_r << endl;
+	AutoFILE fp( xfopen( file_r ) );
+	if ( reader_r( fp.value() ) != 0 )
+	{
+	  RepoException ex( str::form( _("Failed to cache repo (%d)."), 1 ) );
+	  ex.remember( file_r.asString() + ": " + spool_r.errstr() );
+	  ZYPP_THROW( ex );
+	}
+      }
+
+      ///////////////////////////////////////////////////////////////////
+      /// rpm-md: repomd.xml tells us which files to load.
+      void buildRpmmd( SolvBuildPool & spool_r, const Pathname & root_r )
+      {
+	const Pathname repomd( root_r / "repodata/repomd.xml" );
+
+	Pathname primary;
+	std::vector<std::pair<Pathname,std::string>> susedata;	// file, lang
+	std::vector<Pathname> updateinfo;
+	std::vector<Pathname> deltainfo;
+
+	parser::yum::RepomdFileReader( repomd, [&]( OnMediaLocation && loc_r, const std::string & type_r ) -> bool {
+	  const Pathname file( root_r / loc_r.filename() );
+	  if ( type_r == "primary" )
+	    primary = file;
+	  else if ( type_r == "susedata" )
+	    susedata.push_back( { file, std::string() } );
+	  else if ( str::startsWith( type_r, "susedata." ) )
+	    susedata.push_back( { file, type_r.substr( 9 ) } );
+	  else if ( type_r == "updateinfo" )
+	    updateinfo.push_back( file );
+	  else if ( type_r == "deltainfo" || type_r == "prestodelta" )
+	    deltainfo.push_back( file );
+	  return true;
+	} );
+
+	if ( primary.empty() )
+	  ZYPP_THROW( RepoException( str::form( _("Failed to cache repo (%d)."), 1 ) + " (no primary)" ) );
+
+	addFile( spool_r, repomd, [&]( FILE * fp_r ) {
+	  return ::repo_add_repomdxml( spool_r._repo, fp_r, 0 );
+	} );
+
+	addFile( spool_r, primary, [&]( FILE * fp_r ) {
+	  return ::repo_add_rpmmd( spool_r._repo, fp_r, 0, REPO_NO_INTERNALIZE );
+	} );
+
+	for ( const auto & el : susedata )
+	{
+	  if ( ! PathInfo( el.first ).isFile() )
+	    continue;	// unwanted locales are not downloaded
+	  addFile( spool_r, el.first, [&]( FILE * fp_r ) {
+	    return ::repo_add_rpmmd( spool_r._repo, fp_r, el.second.empty() ? 0 : el.second.c_str(), REPO_EXTEND_SOLVABLES|REPO_NO_INTERNALIZE );
+	  } );
+	}
+
+	for ( const auto & file : updateinfo )
+	  addFile( spool_r, file, [&]( FILE * fp_r ) {
+	    return ::repo_add_updateinfoxml( spool_r._repo, fp_r, REPO_NO_INTERNALIZE );
+	  } );
+
+	for ( const auto & file : deltainfo )
+	  addFile( spool_r, file, [&]( FILE * fp_r ) {
+	    return ::repo_add_deltainfoxml( spool_r._repo, fp_r, REPO_NO_INTERNALIZE );
+	  } );
+      }
+
+      ///////////////////////////////////////////////////////////////////
+      /// susetags: the content file tells the descrdir to scan.
+      void buildSusetags( SolvBuildPool & spool_r, const Pathname & root_r )
+      {
+	addFile( spool_r, root_r / "content", [&]( FILE * fp_r ) {
+	  return ::repo_add_content( spool_r._repo, fp_r, REPO_REUSE_REPODATA|REPO_NO_INTERNALIZE );
+	} );
+
+	::Id defvendor = ::repo_lookup_id( spool_r._repo, SOLVID_META, SUSETAGS_DEFAULTVENDOR );
+	const char * descrdir = ::repo_lookup_str( spool_r._repo, SOLVID_META, SUSETAGS_DESCRDIR );
+	const Pathname descr( root_r / ( descrdir ? descrdir : "suse/setup/descr" ) );
+
+	std::list<std::string> entries;
+	if ( filesystem::readdir( entries, descr, false ) != 0 )
+	  ZYPP_THROW( RepoException( str::form( _("Can't open file '%s' for reading."), descr.c_str() ) ) );
+	entries.sort();
+
+	// packages must be loaded first, translations and diskusage extend them.
+	auto isPackages = []( const std::string & n ) { return n == "packages" || n == "packages.gz"; };
+	for ( const std::string & name : entries )
+	{
+	  if ( isPackages( name ) )
+	    addFile( spool_r, descr / name, [&]( FILE * fp_r ) {
+	      return ::repo_add_susetags( spool_r._repo, fp_r, defvendor, 0, SUSETAGS_RECORD_SHARES|REPO_NO_INTERNALIZE );
+	    } );
+	}
+
+	for ( const std::string & name : entries )
+	{
+	  if ( isPackages( name ) || ! str::startsWith( name, "packages." ) )
+	    continue;
+	  std::string ext( name.substr( 9 ) );	// DU, en, de.gz, ...
+	  if ( str::endsWith( ext, ".gz" ) )
+	    ext.erase( ext.size() - 3 );
+	  if ( ext.empty() || ext == "FL" )
+	    continue;	// filelists are not used
+	  const char * lang = ( ext == "DU" ? 0 : ext.c_str() );
+	  addFile( spool_r, descr / name, [&]( FILE * fp_r ) {
+	    return ::repo_add_susetags( spool_r._repo, fp_r, defvendor, lang, REPO_EXTEND_SOLVABLES|REPO_NO_INTERNALIZE );
+	  } );
+	}
+
+	for ( const std::string & name : entries )
+	{
+	  if ( str::endsWith( name, ".pat" ) || str::endsWith( name, ".pat.gz" ) )
+	    addFile( spool_r, descr / name, [&]( FILE * fp_r ) {
+	      return ::repo_add_susetags( spool_r._repo, fp_r, defvendor, 0, REPO_NO_INTERNALIZE );
+	    } );
+	}
+      }
+
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
+    SolvCacheBuilder::SolvCacheBuilder( const RepoType & type_r, const Pathname & metadataPath_r )
+    : _type( type_r )
+    , _metadataPath( metadataPath_r )
+    {}
+
+    bool SolvCacheBuilder::supports() const
+    {
+      if ( env::ZYPP_REPO2SOLV() )
+	return false;
+      return( _type == RepoType::RPMMD || _type == RepoType::YAST2 );
+    }
+
+    void SolvCacheBuilder::build( const Pathname & solvfile_r ) const
+    {
+      MIL << "Building " << solvfile_r << " from " << _type << " metadata in " << _metadataPath << endl;
+      SolvBuildPool spool;
+
+      switch ( _type.toEnum() )
+      {
+	case RepoType::RPMMD_e:
+	  buildRpmmd( spool, _metadataPath );
+	  break;
+	case RepoType::YAST2_e:
+	  buildSusetags( spool, _metadataPath );
+	  break;
+	default:
+	  ZYPP_THROW( RepoException( _("Unhandled repository type") ) );
+	  break;
+      }
+
+      ::repo_add_autopattern( spool._repo, 0 );	// like repo2solv -X: autogenerate pattern from pattern-package
+      ::repo_internalize( spool._repo );
+
+      {
+	AutoFILE fp( ::fopen( solvfile_r.c_str(), "we" ) );
+	if ( ! fp )
+	{
+	  ZYPP_THROW( RepoException( str::form( _("Can't open file '%s' for writing."), solvfile_r.c_str() ) ) );
+	}
+	if ( ::repo_write( spool._repo, fp ) != 0 )
+	{
+	  RepoException ex( str::form( _("Failed to cache repo (%d)."), 1 ) );
+	  ex.remember( solvfile_r.asString() + ": " + spool.errstr() );
+	  ZYPP_THROW( ex );
+	}
+	fp.resetDispose();
+	if ( ::fclose( fp ) != 0 )
+	  ZYPP_THROW( RepoException( str::form( _("Can't open file '%s' for writing."), solvfile_r.c_str() ) ) );
+      }
+
+      sat::updateSolvFileIndex( solvfile_r, spool._repo );	// content digest for zypper bash completion
+      MIL << "Built " << solvfile_r << " (" << spool._repo->nsolvables << " solvables)" << endl;
+    }
+
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
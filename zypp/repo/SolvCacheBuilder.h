@@ -0,0 +1,69 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/SolvCacheBuilder.h
+ *
+*/
+#ifndef ZYPP_REPO_SOLVCACHEBUILDER_H
+#define ZYPP_REPO_SOLVCACHEBUILDER_H
+
+#include <zypp/Pathname.h>
+#include <zypp/repo/RepoType.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// \class SolvCacheBuilder
+    /// \brief Build a repositories \c solv file in-process.
+    ///
+    /// The raw metadata are parsed by calling libsolvs \c repo_add_*
+    /// readers directly (compressed files are streamed via \c solv_xfopen).
+    /// The resulting repo is written to the \c solv file and the \c solv.idx
+    /// is created from the in-memory repo, so there is no need to fork
+    /// \c repo2solv and to re-read the written file.
+    ///
+    /// Only \ref RepoType::RPMMD and \ref RepoType::YAST2 are supported.
+    /// For other types (or if \c ZYPP_REPO2SOLV is set in the environment)
+    /// \ref supports returns \c false and the caller is expected to fall
+    /// back to \c repo2solv.
+    ///
+    /// \code
+    ///   SolvCacheBuilder builder( repokind, productdatapath );
+    ///   if ( builder.supports() )
+    ///     builder.build( solvfile );	// throws on error
+    /// \endcode
+    ///////////////////////////////////////////////////////////////////
+    class SolvCacheBuilder
+    {
+    public:
+      /** Ctor taking the metadata type and the local path to the raw metadata. */
+      SolvCacheBuilder( const RepoType & type_r, const Pathname & metadataPath_r );
+
+    public:
+      /** Whether the metadata type can be handled in-process. */
+      bool supports() const;
+
+      /** Build \a solvfile_r and it's \c solv.idx.
+       * \throws RepoException if the metadata can not be parsed or the files can not be written.
+       */
+      void build( const Pathname & solvfile_r ) const;
+
+    private:
+      RepoType _type;
+      Pathname _metadataPath;
+    };
+
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_REPO_SOLVCACHEBUILDER_H
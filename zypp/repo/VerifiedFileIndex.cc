@@ -0,0 +1,289 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/VerifiedFileIndex.cc
+ *
+*/
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+#include <zypp/repo/VerifiedFileIndex_p.h>
+
+using std::endl;
+
+#undef  ZYPP_BASE_LOGGER_LOGGROUP
+#define ZYPP_BASE_LOGGER_LOGGROUP "zypp::repo::VerifiedFileIndex"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  {
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** What identifies a files content. */
+      struct FileId
+      {
+	bool get( const Pathname & file_r )
+	{
+	  struct stat st;
+	  if ( ::stat( file_r.c_str(), &st ) != 0 || ! S_ISREG( st.st_mode ) )
+	    return false;
+	  _dev   = st.st_dev;
+	  _ino   = st.st_ino;
+	  _size  = st.st_size;
+	  _mtime = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+	  return true;
+	}
+
+	/** The device is not compared, it is not stored in the index. */
+	bool sameContent( const FileId & rhs ) const
+	{ return _ino == rhs._ino && _size == rhs._size && _mtime == rhs._mtime; }
+
+	dev_t     _dev = 0;
+	ino_t     _ino = 0;
+	off_t     _size = 0;
+	long long _mtime = 0;	// ns
+      };
+
+      struct Record
+      {
+	FileId   _id;
+	CheckSum _checksum;
+      };
+
+      ///////////////////////////////////////////////////////////////////
+      /// \class Index
+      /// \brief The index file of a cache directory.
+      ///
+      /// One line per record, the last one for a path wins:
+      /// \code
+      ///   <inode> <size> <mtime-ns> <checksum-type> <checksum> <relative-path>
+      /// \endcode
+      /// New records are appended. Outdated ones are dropped when the
+      /// file is loaded and contains too many of them.
+      ///////////////////////////////////////////////////////////////////
+      class Index
+      {
+      public:
+	Index( const Pathname & dir_r )
+	: _dir( dir_r )
+	, _file( dir_r / ".verified" )
+	{ load(); }
+
+	bool contains( const std::string & path_r, const FileId & id_r, const CheckSum & checksum_r ) const
+	{
+	  auto it = _records.find( path_r );
+	  return( it != _records.end() && it->second._id.sameContent( id_r ) && it->second._checksum == checksum_r );
+	}
+
+	void add( const std::string & path_r, const FileId & id_r, const CheckSum & checksum_r )
+	{
+	  if ( contains( path_r, id_r, checksum_r ) )
+	    return;
+	  Record & rec( _records[path_r] );
+	  rec = Record { id_r, checksum_r };
+
+	  std::ofstream out( _file.c_str(), std::ios_base::app );
+	  out << asLine( path_r, rec ) << endl;
+	  if ( ! out && ! _writeFailed )
+	  {
+	    DBG << "Can't write " << _file << endl;	// probably no permission
+	    _writeFailed = true;
+	  }
+	  ++_lines;
+	}
+
+      private:
+	static std::string asLine( const std::string & path_r, const Record & rec_r )
+	{
+	  return str::Str() << rec_r._id._ino << " " << rec_r._id._size << " " << rec_r._id._mtime
+	                    << " " << rec_r._checksum.type() << " " << rec_r._checksum.checksum() << " " << path_r;
+	}
+
+	void load()
+	{
+	  std::ifstream in( _file.c_str() );
+	  for( std::string line; std::getline( in, line ); )
+	  {
+	    ++_lines;
+	    std::vector<std::string> words;
+	    str::split( line, std::back_inserter( words ), " " );
+	    if ( words.size() < 6 )
+	      continue;
+	    std::string::size_type pos = 0;
+	    for ( unsigned i = 0; i < 5; ++i )
+	      pos = line.find( ' ', pos ) + 1;	// path may contain blanks
+
+	    Record rec;
+	    rec._id._ino   = str::strtonum<ino_t>( words[0] );
+	    rec._id._size  = str::strtonum<off_t>( words[1] );
+	    rec._id._mtime = str::strtonum<long long>( words[2] );
+	    rec._checksum  = CheckSum( words[3], words[4] );
+	    _records[line.substr( pos )] = rec;
+	  }
+	  if ( _lines > 2 * _records.size() + 64 )
+	    compact();
+	}
+
+	/** Drop records of changed or removed files and rewrite the index. */
+	void compact()
+	{
+	  for ( auto it = _records.begin(); it != _records.end(); )
+	  {
+	    FileId id;
+	    if ( id.get( _dir / it->first ) && id.sameContent( it->second._id ) )
+	      ++it;
+	    else
+	      it = _records.erase( it );
+	  }
+
+	  filesystem::TmpFile tmp( filesystem::TmpFile::makeSibling( _file ) );
+	  if ( tmp.path().empty() )
+	    return;
+	  {
+	    std::ofstream out( tmp.path().c_str() );
+	    for ( const auto & rec : _records )
+	      out << asLine( rec.first, rec.second ) << endl;
+	    if ( ! out.flush() )
+	      return;
+	  }
+	  if ( filesystem::rename( tmp.path(), _file ) == 0 )
+	  {
+	    tmp.autoCleanup( false );
+	    MIL << "Compacted " << _file << ": " << _lines << " -> " << _records.size() << " records" << endl;
+	    _lines = _records.size();
+	  }
+	}
+
+      private:
+	Pathname _dir;
+	Pathname _file;
+	std::unordered_map<std::string,Record> _records;
+	size_t _lines = 0;
+	bool _writeFailed = false;
+      };
+
+      /** The indices in use and the files verified in this process. */
+      struct Registry
+      {
+	static Registry & instance()
+	{ static Registry _instance; return _instance; }
+
+	Index & index( const Pathname & dir_r )
+	{
+	  auto it = _indices.find( dir_r.asString() );
+	  if ( it == _indices.end() )
+	    it = _indices.emplace( dir_r.asString(), Index( dir_r ) ).first;
+	  return it->second;
+	}
+
+	bool verified( const FileId & id_r, const CheckSum & checksum_r ) const
+	{
+	  auto it = _verified.find( { id_r._dev, id_r._ino } );
+	  return( it != _verified.end() && it->second._id.sameContent( id_r ) && it->second._checksum == checksum_r );
+	}
+
+	void setVerified( const FileId & id_r, const CheckSum & checksum_r )
+	{
+	  if ( _verified.size() >= 16384 )
+	    _verified.clear();
+	  _verified[{ id_r._dev, id_r._ino }] = Record { id_r, checksum_r };
+	}
+
+	std::mutex _mutex;
+	std::map<std::string,Index> _indices;
+	std::map<std::pair<dev_t,ino_t>,Record> _verified;
+      };
+
+      /** \a file_r relative to \a dir_r or empty if it is not below \a dir_r. */
+      std::string relativePath( const Pathname & dir_r, const Pathname & file_r )
+      {
+	const std::string & dir( dir_r.asString() );
+	const std::string & file( file_r.asString() );
+	if ( dir.empty() || file.size() <= dir.size() + 1 || file[dir.size()] != '/' || ! str::hasPrefix( file, dir ) )
+	  return std::string();
+	return file.substr( dir.size() + 1 );
+      }
+
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
+    bool VerifiedFileIndex::check( const Pathname & cacheDir_r, const Pathname & file_r, const CheckSum & checksum_r )
+    {
+      FileId id;
+      if ( checksum_r.empty() || ! id.get( file_r ) )
+	return false;
+
+      const std::string path( relativePath( cacheDir_r, file_r ) );
+      Registry & registry( Registry::instance() );
+      {
+	std::lock_guard<std::mutex> lock( registry._mutex );
+	bool known = registry.verified( id, checksum_r );
+	if ( ! path.empty() )
+	{
+	  Index & index( registry.index( cacheDir_r ) );
+	  if ( index.contains( path, id, checksum_r ) )
+	    return true;
+	  if ( known )
+	    index.add( path, id, checksum_r );
+	}
+	if ( known )
+	  return true;
+      }
+
+      if ( CheckSum( checksum_r.type(), filesystem::checksum( file_r, checksum_r.type() ) ) != checksum_r )
+	return false;
+
+      FileId after;
+      if ( after.get( file_r ) && after._dev == id._dev && after.sameContent( id ) )	// not modified while hashing
+      {
+	std::lock_guard<std::mutex> lock( registry._mutex );
+	registry.setVerified( id, checksum_r );
+	if ( ! path.empty() )
+	  registry.index( cacheDir_r ).add( path, id, checksum_r );
+      }
+      return true;
+    }
+
+    void VerifiedFileIndex::remember( const Pathname & file_r, const CheckSum & checksum_r )
+    {
+      FileId id;
+      if ( checksum_r.empty() || ! id.get( file_r ) )
+	return;
+      Registry & registry( Registry::instance() );
+      std::lock_guard<std::mutex> lock( registry._mutex );
+      registry.setVerified( id, checksum_r );
+    }
+
+    void VerifiedFileIndex::persist( const Pathname & cacheDir_r, const Pathname & file_r, const CheckSum & checksum_r )
+    {
+      FileId id;
+      const std::string path( relativePath( cacheDir_r, file_r ) );
+      if ( checksum_r.empty() || path.empty() || ! id.get( file_r ) )
+	return;
+      Registry & registry( Registry::instance() );
+      std::lock_guard<std::mutex> lock( registry._mutex );
+      if ( registry.verified( id, checksum_r ) )
+	registry.index( cacheDir_r ).add( path, id, checksum_r );
+    }
+
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
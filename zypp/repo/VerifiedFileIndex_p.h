@@ -0,0 +1,67 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/VerifiedFileIndex_p.h
+ * This file contains private API, it will change without notice.
+ * You have been warned.
+*/
+#ifndef ZYPP_REPO_VERIFIEDFILEINDEX_P_H
+#define ZYPP_REPO_VERIFIEDFILEINDEX_P_H
+
+#include <zypp/APIConfig.h>
+#include <zypp/Pathname.h>
+#include <zypp/CheckSum.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// \class VerifiedFileIndex
+    /// \brief Remember files in a package cache whose checksum was verified.
+    ///
+    /// Each cache directory passed to \ref check keeps an index file
+    /// (\c .verified) with the relative path, inode, size, mtime and the
+    /// verified checksum of its files. As long as a file is unchanged, a
+    /// later \ref check (even in another process) accepts it without
+    /// reading it again.
+    ///
+    /// Files in the package cache are never rewritten in place, they are
+    /// replaced (new inode). A modified file is hashed again.
+    ///
+    /// Within the process, files verified elsewhere (e.g. by the
+    /// \ref ChecksumFileChecker after download) are remembered by inode via
+    /// \ref remember. So a hardlink into the cache is not hashed twice and
+    /// can be written to the index via \ref persist.
+    ///////////////////////////////////////////////////////////////////
+    class ZYPP_LOCAL VerifiedFileIndex
+    {
+    public:
+      /** Whether \a file_r matches \a checksum_r.
+       * Known matches are accepted, otherwise the file is hashed.
+       * Matches of files below \a cacheDir_r are recorded in its index.
+       * An empty \a checksum_r never matches.
+       */
+      static bool check( const Pathname & cacheDir_r, const Pathname & file_r, const CheckSum & checksum_r );
+
+      /** Remember (in the process) that the file content was verified to match \a checksum_r. */
+      static void remember( const Pathname & file_r, const CheckSum & checksum_r );
+
+      /** Record \a file_r in the index of \a cacheDir_r, if the process knows it matches \a checksum_r.
+       * The file is not read.
+       */
+      static void persist( const Pathname & cacheDir_r, const Pathname & file_r, const CheckSum & checksum_r );
+    };
+
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_REPO_VERIFIEDFILEINDEX_P_H
@@ -72,7 +72,7 @@ namespace yum
   /// \brief Helper filtering the files offered by a RepomdFileReader
   ///
   /// Clumsy construct; basically an Impl class for Downloader, maintained
-  /// in Downloader::download only while parsing a repomd.xml.
+  /// in Downloader::wantedFiles only while parsing a repomd.xml.
   ///     File types:
   ///         type        (plain)
   ///         type_db     (sqlite, ignored by zypp)
@@ -85,10 +85,8 @@ namespace yum
     NON_COPYABLE( Impl );
     NON_MOVABLE( Impl );
 
-    Impl( Downloader & downloader_r, MediaSetAccess & media_r, const Pathname & destDir_r )
-    : _downloader { downloader_r }
-    , _media { media_r }
-    , _destDir { destDir_r }
+    Impl( const Pathname & repoPath_r )
+    : _repoPath { repoPath_r }
     {
       addWantedLocale( ZConfig::instance().textLocale() );
       for ( const Locale & it : ZConfig::instance().repoRefreshLocales() )
@@ -132,21 +130,16 @@ namespace yum
       return true;
     }
 
-    void finalize()
+    /** The files to download (path prefixed). */
+    std::vector<OnMediaLocation> files() const
     {
-      // schedule fileS for download
+      std::vector<OnMediaLocation> ret;
       for ( const auto & el : _wantedFiles )
-      {
-	const OnMediaLocation & loc { el.second };
-	const OnMediaLocation & loc_with_path { loc_with_path_prefix( loc, _downloader.repoInfo().path() ) };
-	_downloader.enqueueDigested( loc_with_path, FileChecker(), search_deltafile( deltaDir()/"repodata", loc.filename() ) );
-      }
+	ret.push_back( loc_with_path_prefix( el.second, _repoPath ) );
+      return ret;
     }
 
   private:
-    const Pathname & deltaDir() const
-    { return _downloader._deltaDir; }
-
     bool wantLocale( const Locale & locale_r ) const
     { return _wantedLocales.count( locale_r ); }
 
@@ -160,9 +153,7 @@ namespace yum
     }
 
   private:
-    Downloader & _downloader;
-    MediaSetAccess & _media;
-    const Pathname & _destDir;
+    Pathname _repoPath;
 
     LocaleSet _wantedLocales;	///< Locales do download
     std::map<std::string,OnMediaLocation> _wantedFiles;
@@ -186,15 +177,21 @@ namespace yum
     Pathname masterIndex { repoInfo().path() / "/repodata/repomd.xml" };
     defaultDownloadMasterIndex( media_r, destDir_r, masterIndex );
 
-    // setup parser
-    Impl pimpl( *this, media_r, destDir_r );
-    RepomdFileReader( destDir_r / masterIndex, std::ref(pimpl) );
-    pimpl.finalize();
+    // schedule the files for download
+    for ( const OnMediaLocation & loc : wantedFiles( repoInfo(), destDir_r / masterIndex ) )
+      enqueueDigested( loc, FileChecker(), search_deltafile( _deltaDir/"repodata", loc.filename() ) );
 
     // ready, go!
     start( destDir_r, media_r );
   }
 
+  std::vector<OnMediaLocation> Downloader::wantedFiles( const RepoInfo & info_r, const Pathname & repomd_r )
+  {
+    Impl pimpl( info_r.path() );
+    RepomdFileReader( repomd_r, std::ref(pimpl) );
+    return pimpl.files();
+  }
+
   RepoStatus Downloader::status( MediaSetAccess & media_r )
   {
     RepoStatus ret { media_r.provideOptionalFile( repoInfo().path() / "/repodata/repomd.xml" ) };
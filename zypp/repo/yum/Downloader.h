@@ -67,6 +67,13 @@ namespace zypp
          */
         RepoStatus status( MediaSetAccess & media_r ) override;
 
+        /**
+         * \short The metadata files \ref download takes from the repomd.xml at \a repomd_r
+         *
+         * The filenames are prefixed by the repos path.
+         */
+        static std::vector<OnMediaLocation> wantedFiles( const RepoInfo & info_r, const Pathname & repomd_r );
+
       private:
 	class Impl;
 	friend class Impl;
@@ -283,41 +283,34 @@ namespace zypp
     #undef ZYPP_BASE_LOGGER_LOGGROUP
     #define ZYPP_BASE_LOGGER_LOGGROUP "solvidx"
 
-    void updateSolvFileIndex( const Pathname & solvfile_r )
+    namespace
     {
-      AutoDispose<FILE*> solv( ::fopen( solvfile_r.c_str(), "re" ), ::fclose );
-      if ( solv == NULL )
-      {
-	solv.resetDispose();
-	ERR << "Can't open solv-file: " << solv << endl;
-	return;
-      }
-
-      std::string solvidxfile( solvfile_r.extend(".idx").asString() );
-      if ( ::unlink( solvidxfile.c_str() ) == -1 && errno != ENOENT )
-      {
-	ERR << "Can't unlink solv-idx: " << Errno() << endl;
-	return;
-      }
+      /** Create a fresh (empty) solv.idx file for \a solvfile_r and return its name (or an empty string on error). */
+      std::string createSolvIdxFile( const Pathname & solvfile_r )
       {
+	std::string solvidxfile( solvfile_r.extend(".idx").asString() );
+	if ( ::unlink( solvidxfile.c_str() ) == -1 && errno != ENOENT )
+	{
+	  ERR << "Can't unlink solv-idx: " << Errno() << endl;
+	  return std::string();
+	}
 	int fd = ::open( solvidxfile.c_str(), O_CREAT|O_EXCL|O_WRONLY|O_TRUNC, 0644 );
 	if ( fd == -1 )
 	{
 	  ERR << "Can't create solv-idx: " << Errno() << endl;
-	  return;
+	  return std::string();
 	}
 	::close( fd );
+	return solvidxfile;
       }
-      std::ofstream idx( solvidxfile.c_str() );
-
 
-      detail::CPool * _pool = ::pool_create();
-      detail::CRepo * _repo = ::repo_create( _pool, "" );
-      if ( ::repo_add_solv( _repo, solv, 0 ) == 0 )
+      /** Write the solv.idx lines for all solvables in \a repo_r. */
+      void writeSolvIdx( std::ostream & idx, detail::CRepo * repo_r )
       {
+	detail::CPool * _pool = repo_r->pool;
 	int _id = 0;
 	detail::CSolvable * _solv = nullptr;
-	FOR_REPO_SOLVABLES( _repo, _id, _solv )
+	FOR_REPO_SOLVABLES( repo_r, _id, _solv )
 	{
 	  if ( _solv )
 	  {
@@ -327,9 +320,34 @@ namespace zypp
 	      idx << "srcpackage:" << idstr(name) << SEP << idstr(evr) << SEP << "noarch" << endl;
 	    else
 	      idx << idstr(name) << SEP << idstr(evr) << SEP << idstr(arch) << endl;
+#undef idstr
+#undef SEP
 	  }
 	}
       }
+    } // namespace
+
+    void updateSolvFileIndex( const Pathname & solvfile_r )
+    {
+      AutoDispose<FILE*> solv( ::fopen( solvfile_r.c_str(), "re" ), ::fclose );
+      if ( solv == NULL )
+      {
+	solv.resetDispose();
+	ERR << "Can't open solv-file: " << solv << endl;
+	return;
+      }
+
+      std::string solvidxfile( createSolvIdxFile( solvfile_r ) );
+      if ( solvidxfile.empty() )
+	return;
+      std::ofstream idx( solvidxfile.c_str() );
+
+      detail::CPool * _pool = ::pool_create();
+      detail::CRepo * _repo = ::repo_create( _pool, "" );
+      if ( ::repo_add_solv( _repo, solv, 0 ) == 0 )
+      {
+	writeSolvIdx( idx, _repo );
+      }
       else
       {
 	ERR << "Can't read solv-file: " << ::pool_errstr( _pool ) << endl;
@@ -338,6 +356,18 @@ namespace zypp
       ::pool_free( _pool );
     }
 
+    void updateSolvFileIndex( const Pathname & solvfile_r, detail::CRepo * repo_r )
+    {
+      if ( ! repo_r )
+	return updateSolvFileIndex( solvfile_r );
+
+      std::string solvidxfile( createSolvIdxFile( solvfile_r ) );
+      if ( solvidxfile.empty() )
+	return;
+      std::ofstream idx( solvidxfile.c_str() );
+      writeSolvIdx( idx, repo_r );
+    }
+
     /////////////////////////////////////////////////////////////////
   } // namespace sat
   ///////////////////////////////////////////////////////////////////
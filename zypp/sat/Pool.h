@@ -301,6 +301,9 @@ namespace zypp
     /** Create solv file content digest for zypper bash completion */
     void updateSolvFileIndex( const Pathname & solvfile_r );
 
+    /** \overload Create the digest from the already loaded \a repo_r the \a solvfile_r was written from (no need to re-read the file). */
+    void updateSolvFileIndex( const Pathname & solvfile_r, detail::CRepo * repo_r );
+
     /////////////////////////////////////////////////////////////////
   } // namespace sat
   ///////////////////////////////////////////////////////////////////
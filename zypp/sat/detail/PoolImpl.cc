@@ -9,6 +9,8 @@
 /** \file	zypp/sat/detail/PoolImpl.cc
  *
 */
+#include <sys/stat.h>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <boost/mpl/int.hpp>
@@ -23,6 +25,8 @@
 #include <zypp/base/IOStream.h>
 
 #include <zypp/ZConfig.h>
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
 
 #include <zypp/sat/detail/PoolImpl.h>
 #include <zypp/sat/SolvableSet.h>
@@ -285,6 +289,7 @@ namespace zypp
           else if ( a2 ) MIL << a1 << " " << a2 << endl;
           else           MIL << a1 << endl;
         }
+        _serialDeps.setDirty();
         ::pool_freewhatprovides( _pool );
       }
 
@@ -307,7 +312,28 @@ namespace zypp
         {
           MIL << "pool_createwhatprovides..." << endl;
 
-          ::pool_addfileprovides( _pool );
+          if ( _loadedSolvs.empty() )
+            ::pool_addfileprovides( _pool );
+          else
+          {
+            // The system repo is also searched for the file dependencies of
+            // installed packages; all repos for the ones of all other packages.
+            Queue added;
+            Queue addedInstalled;
+            ::pool_addfileprovides_queue( _pool, added, addedInstalled );
+            std::set<IdType> searched( added.begin(), added.end() );
+            for ( auto & solv : const_cast<PoolImpl*>(this)->_loadedSolvs )
+            {
+              if ( isSystemRepo( solv.first ) && ! addedInstalled.empty() )
+              {
+                std::set<IdType> searchedInstalled( searched );
+                searchedInstalled.insert( addedInstalled.begin(), addedInstalled.end() );
+                const_cast<PoolImpl*>(this)->_storeFileProvides( solv.first, solv.second, searchedInstalled );
+              }
+              else
+                const_cast<PoolImpl*>(this)->_storeFileProvides( solv.first, solv.second, searched );
+            }
+          }
           ::pool_createwhatprovides( _pool );
         }
         if ( ! _pool->languages )
@@ -323,6 +349,8 @@ namespace zypp
       {
         setDirty(__FUNCTION__, name_r.c_str() );
         CRepo * ret = ::repo_create( _pool, name_r.c_str() );
+        if ( ret )
+          _repoSerials[ret] = _serial.serial();
         if ( ret && name_r == systemRepoAlias() )
           ::pool_set_installed( _pool, ret );
         return ret;
@@ -330,10 +358,12 @@ namespace zypp
 
       void PoolImpl::_deleteRepo( CRepo * repo_r )
       {
-        setDirty(__FUNCTION__, repo_r->name );
+        setRepoDirty( repo_r, __FUNCTION__ );
 	if ( isSystemRepo( repo_r ) )
 	  _autoinstalled.clear();
         eraseRepoInfo( repo_r );
+        _loadedSolvs.erase( repo_r );
+        _repoSerials.erase( repo_r );
         ::repo_free( repo_r, /*resusePoolIDs*/false );
 	// If the last repo is removed clear the pool to actually reuse all IDs.
 	// NOTE: the explicit ::repo_free above asserts all solvables are memset(0)!
@@ -344,18 +374,164 @@ namespace zypp
 	}
       }
 
-      int PoolImpl::_addSolv( CRepo * repo_r, FILE * file_r )
+      void PoolImpl::setRepoDirty( CRepo * repo_r, const char * a1 )
+      {
+        setDirty( a1, repo_r->name );
+        _repoSerials[repo_r] = _serial.serial();
+      }
+
+      int PoolImpl::_addSolv( CRepo * repo_r, FILE * file_r, const Pathname & solvfile_r )
       {
-        setDirty(__FUNCTION__, repo_r->name );
+        setRepoDirty( repo_r, __FUNCTION__ );
+        // The bulky 'vertical' attributes (descriptions, changelogs, filelists,...)
+        // are stored in pages. If the file is seekable, libsolv remembers just the
+        // page offsets (and a dup of the fd) and reads a page when a lookup needs
+        // it. Otherwise all pages are read into memory right now.
+        if ( ::ftell( file_r ) < 0 )
+          WAR << repo_r->name << ": solv file is not seekable; all paged data will be loaded." << endl;
+
+        // The file provides can be cached for repos loaded from a single solv file.
+        LoadedSolv solv;
+        struct stat st;
+        bool cacheFileProvides = ( ZConfig::instance().repo_cache_fileprovides()
+                                   && ! solvfile_r.empty()
+                                   && ! repo_r->nsolvables
+                                   && ::fstat( ::fileno( file_r ), &st ) == 0 );
+        if ( cacheFileProvides )
+        {
+          solv._file  = solvfile_r;
+          solv._stamp = str::Str() << ZConfig::instance().systemArchitecture()
+                                   << " " << st.st_dev << " " << st.st_ino
+                                   << " " << st.st_size << " " << st.st_mtime;
+          solv._begin = _pool->nsolvables;	// the solvables are appended
+        }
+        _loadedSolvs.erase( repo_r );
+
         int ret = ::repo_add_solv( repo_r, file_r, 0 );
         if ( ret == 0 )
+        {
           _postRepoAdd( repo_r );
+          if ( cacheFileProvides )
+          {
+            solv._end = _pool->nsolvables;
+            _restoreFileProvides( repo_r, solv );
+            _loadedSolvs[repo_r] = std::move(solv);
+          }
+        }
         return ret;
       }
 
+      ///////////////////////////////////////////////////////////////////
+      // The file provides cache: <solvfile>.fileprovides
+      //
+      //   # <stamp>		LoadedSolv::_stamp of the solv file
+      //   = <file>		a file dependency searched in this repo
+      //   <offset> <file>	solvable _begin+offset provides <file>
+      //
+      // Once pool_addfileprovides searched a repos filelists for a file dependency,
+      // the matching files are added to the solvables provides (behind the
+      // SOLVABLE_FILEMARKER). Restoring those provides and telling libsolv which
+      // file dependencies are covered (REPOSITORY_ADDEDFILEPROVIDES) lets it skip
+      // the search, and the filelist pages are not even loaded.
+      ///////////////////////////////////////////////////////////////////
+      namespace
+      {
+        inline Pathname fileProvidesCache( const Pathname & solvfile_r )
+        { return solvfile_r.extend( ".fileprovides" ); }
+      } // namespace
+
+      void PoolImpl::_restoreFileProvides( CRepo * repo_r, LoadedSolv & solv_r )
+      {
+        std::ifstream in( fileProvidesCache( solv_r._file ).c_str() );
+        std::string line;
+        if ( ! ( in && std::getline( in, line ) && line == "# "+solv_r._stamp ) )
+          return;	// no or outdated cache
+
+        std::set<IdType> covered;
+        unsigned provides = 0;
+        while ( std::getline( in, line ) )
+        {
+          std::string::size_type sep = line.find( ' ' );
+          if ( sep == std::string::npos || sep+1 == line.size() )
+            continue;
+          IdType file = ::pool_str2id( _pool, line.c_str()+sep+1, /*create*/1 );
+          if ( line[0] == '=' )
+          {
+            covered.insert( file );
+            continue;
+          }
+          SolvableIdType id = solv_r._begin + str::strtonum<SolvableIdType>( line.substr( 0, sep ) );
+          if ( id < solv_r._end && _pool->solvables[id].repo == repo_r )
+          {
+            CSolvable & s( _pool->solvables[id] );
+            s.provides = ::repo_addid_dep( repo_r, s.provides, file, SOLVABLE_FILEMARKER );
+            ++provides;
+          }
+        }
+
+        ::Repodata * data = ::repo_id2repodata( repo_r, 1 );	// the solv files main data
+        if ( covered.empty() || ! data )
+          return;
+        Queue q;
+        ::repodata_lookup_idarray( data, SOLVID_META, REPOSITORY_ADDEDFILEPROVIDES, q );
+        for ( IdType id : covered )
+          q.pushUnique( id );
+        ::repodata_set_idarray( data, SOLVID_META, REPOSITORY_ADDEDFILEPROVIDES, q );
+        ::repodata_internalize( data );
+
+        solv_r._covered.swap( covered );
+        MIL << repo_r->name << ": restored " << provides << " file provides for " << solv_r._covered.size() << " file dependencies." << endl;
+      }
+
+      void PoolImpl::_storeFileProvides( CRepo * repo_r, LoadedSolv & solv_r, const std::set<IdType> & searched_r )
+      {
+        if ( std::includes( solv_r._covered.begin(), solv_r._covered.end(), searched_r.begin(), searched_r.end() ) )
+          return;	// nothing new
+        solv_r._covered.insert( searched_r.begin(), searched_r.end() );
+
+        Pathname cache( fileProvidesCache( solv_r._file ) );
+        filesystem::TmpFile tmp( filesystem::TmpFile::makeSibling( cache ) );
+        if ( tmp.path().empty() )
+        {
+          DBG << "Can't write " << cache << endl;	// probably no permission
+          return;
+        }
+        {
+          std::ofstream out( tmp.path().c_str() );
+          out << "# " << solv_r._stamp << endl;
+          for ( IdType id : solv_r._covered )
+            out << "= " << IdString( id ) << endl;
+          for ( SolvableIdType id = solv_r._begin; id < solv_r._end; ++id )
+          {
+            const CSolvable & s( _pool->solvables[id] );
+            if ( s.repo != repo_r || ! s.provides )
+              continue;
+            bool files = false;
+            for ( const IdType * pp = repo_r->idarraydata + s.provides; *pp; ++pp )
+            {
+              if ( *pp == SOLVABLE_FILEMARKER )
+                files = true;
+              else if ( files && ! ISRELDEP( *pp ) )
+                out << ( id - solv_r._begin ) << " " << IdString( *pp ) << endl;
+            }
+          }
+          if ( ! out.flush() )
+          {
+            WAR << "Failed to write " << cache << endl;
+            return;
+          }
+        }
+        if ( filesystem::rename( tmp.path(), cache ) == 0 )
+        {
+          tmp.autoCleanup( false );
+          MIL << repo_r->name << ": cached the file provides for " << solv_r._covered.size() << " file dependencies." << endl;
+        }
+      }
+
       int PoolImpl::_addHelix( CRepo * repo_r, FILE * file_r )
       {
-        setDirty(__FUNCTION__, repo_r->name );
+        setRepoDirty( repo_r, __FUNCTION__ );
+        _loadedSolvs.erase( repo_r );
         int ret = ::repo_add_helix( repo_r, file_r, 0 );
         if ( ret == 0 )
           _postRepoAdd( repo_r );
@@ -364,7 +540,8 @@ namespace zypp
 
       int PoolImpl::_addTesttags(CRepo *repo_r, FILE *file_r)
       {
-        setDirty(__FUNCTION__, repo_r->name );
+        setRepoDirty( repo_r, __FUNCTION__ );
+        _loadedSolvs.erase( repo_r );
         int ret = ::testcase_add_testtags( repo_r, file_r, 0 );
         if ( ret == 0 )
           _postRepoAdd( repo_r );
@@ -417,7 +594,8 @@ namespace zypp
 
       detail::SolvableIdType PoolImpl::_addSolvables( CRepo * repo_r, unsigned count_r )
       {
-        setDirty(__FUNCTION__, repo_r->name );
+        setRepoDirty( repo_r, __FUNCTION__ );
+        _loadedSolvs.erase( repo_r );
         return ::repo_add_solvable_block( repo_r, count_r );
       }
 
@@ -634,7 +812,10 @@ namespace zypp
       }
 
       void PoolImpl::multiversionSpecChanged()
-      { _multiversionListPtr.reset(); }
+      {
+        _multiversionListPtr.reset();
+        _serialDeps.setDirty();	// the solvers package rules depend on it
+      }
 
       const PoolImpl::MultiversionList & PoolImpl::multiversionList() const
       {
@@ -71,6 +71,10 @@ namespace zypp
           const SerialNumber & serialIDs() const
           { return _serialIDs; }
 
+          /** Serial number changing whenever the dependency related indices or the multiversion spec are invalidated. */
+          const SerialNumber & serialDeps() const
+          { return _serialDeps; }
+
           /** Update housekeeping data (e.g. whatprovides).
            * \todo actually requires a watcher.
            */
@@ -133,9 +137,10 @@ namespace zypp
 
           /** Adding solv file to a repo.
            * Except for \c isSystemRepo_r, solvables of incompatible architecture
-           * are filtered out.
+           * are filtered out. If \a solvfile_r (the path of \a file_r) is known,
+           * the repos file provides may be cached (see \ref ZConfig::repo_cache_fileprovides).
           */
-          int _addSolv( CRepo * repo_r, FILE * file_r );
+          int _addSolv( CRepo * repo_r, FILE * file_r, const Pathname & solvfile_r = Pathname() );
 
           /** Adding helix file to a repo.
            * Except for \c isSystemRepo_r, solvables of incompatible architecture
@@ -156,6 +161,37 @@ namespace zypp
           /** Helper postprocessing the repo after adding solv or helix files. */
           void _postRepoAdd( CRepo * repo_r );
 
+          /** \ref setDirty because the content of \a repo_r changes. */
+          void setRepoDirty( CRepo * repo_r, const char * a1 );
+
+        public:
+          /** The pools \ref serial at the last content change of \a repo_r.
+           * Unlike the solvable ranges and counts it also changes if a repo
+           * is reloaded or extended in place.
+           */
+          unsigned repoSerial( CRepo * repo_r ) const
+          {
+            auto it = _repoSerials.find( repo_r );
+            return( it == _repoSerials.end() ? 0 : it->second );
+          }
+
+        private:
+          /** A repo loaded from a single solv file. */
+          struct LoadedSolv
+          {
+            Pathname       _file;	///< the solv file
+            std::string    _stamp;	///< identifies the files content and the system architecture
+            SolvableIdType _begin;	///< the solvables loaded from the file
+            SolvableIdType _end;
+            std::set<IdType> _covered;	///< file dependencies already searched in this repo
+          };
+
+          /** Add the file provides remembered for \a solv_r (if still valid). */
+          void _restoreFileProvides( CRepo * repo_r, LoadedSolv & solv_r );
+
+          /** Remember the file provides if new file dependencies were searched in \a repo_r. */
+          void _storeFileProvides( CRepo * repo_r, LoadedSolv & solv_r, const std::set<IdType> & searched_r );
+
         public:
           /** a \c valid \ref Solvable has a non NULL repo pointer. */
           bool validSolvable( const CSolvable & slv_r ) const
@@ -352,10 +388,16 @@ namespace zypp
           SerialNumber _serial;
           /** Serial number of IDs - changes whenever resusePoolIDs==true - ResPool must also invalidate it's PoolItems! */
           SerialNumber _serialIDs;
+          /** Serial number of dependency related indices - changes with each \ref depSetDirty and \ref multiversionSpecChanged. */
+          SerialNumber _serialDeps;
           /** Watch serial number. */
           SerialNumberWatcher _watcher;
           /** Additional \ref RepoInfo. */
           std::map<RepoIdType,RepoInfo> _repoinfos;
+          /** Repos whose file provides are cached. */
+          std::map<RepoIdType,LoadedSolv> _loadedSolvs;
+          /** \ref serial at the last content change per repo. */
+          std::map<RepoIdType,unsigned> _repoSerials;
 
           /**  */
 	  base::SetTracker<LocaleSet> _requestedLocalesTracker;
@@ -464,6 +464,27 @@ class CheckIfUpdate : public resfilter::PoolItemFilterFunctor
 };
 
 
+void
+SATResolver::solverSetFlags()
+{
+    // Set all of them on each run, a reused solver still has the previous ones.
+    solverSetFocus( *_satSolver, _focus );
+    solver_set_flag(_satSolver, SOLVER_FLAG_ADD_ALREADY_RECOMMENDED, !_ignorealreadyrecommended);
+    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_DOWNGRADE,		_allowdowngrade);
+    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_NAMECHANGE,		_allownamechange);
+    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_ARCHCHANGE,		_allowarchchange);
+    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_VENDORCHANGE,		_allowvendorchange);
+    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_UNINSTALL,		_allowuninstall);
+    solver_set_flag(_satSolver, SOLVER_FLAG_NO_UPDATEPROVIDE,		_noupdateprovide);
+    solver_set_flag(_satSolver, SOLVER_FLAG_SPLITPROVIDES,		_dosplitprovides);
+    solver_set_flag(_satSolver, SOLVER_FLAG_IGNORE_RECOMMENDED, 	false);		// resolve recommended namespaces
+    solver_set_flag(_satSolver, SOLVER_FLAG_ONLY_NAMESPACE_RECOMMENDED,	_onlyRequires);	//
+    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_DOWNGRADE,	_dup_allowdowngrade );
+    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_NAMECHANGE,	_dup_allownamechange );
+    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_ARCHCHANGE,	_dup_allowarchchange );
+    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_VENDORCHANGE,	_dup_allowvendorchange );
+}
+
 bool
 SATResolver::solving(const CapabilitySet & requires_caps,
 		     const CapabilitySet & conflict_caps)
@@ -484,21 +505,7 @@ SATResolver::solving(const CapabilitySet & requires_caps,
 	queue_push( &(_jobQueue), SOLVER_DROP_ORPHANED|SOLVER_SOLVABLE_ALL);
 	queue_push( &(_jobQueue), 0 );
     }
-    solverSetFocus( *_satSolver, _focus );
-    solver_set_flag(_satSolver, SOLVER_FLAG_ADD_ALREADY_RECOMMENDED, !_ignorealreadyrecommended);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_DOWNGRADE,		_allowdowngrade);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_NAMECHANGE,		_allownamechange);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_ARCHCHANGE,		_allowarchchange);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_VENDORCHANGE,		_allowvendorchange);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_UNINSTALL,		_allowuninstall);
-    solver_set_flag(_satSolver, SOLVER_FLAG_NO_UPDATEPROVIDE,		_noupdateprovide);
-    solver_set_flag(_satSolver, SOLVER_FLAG_SPLITPROVIDES,		_dosplitprovides);
-    solver_set_flag(_satSolver, SOLVER_FLAG_IGNORE_RECOMMENDED, 	false);		// resolve recommended namespaces
-    solver_set_flag(_satSolver, SOLVER_FLAG_ONLY_NAMESPACE_RECOMMENDED,	_onlyRequires);	//
-    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_DOWNGRADE,	_dup_allowdowngrade );
-    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_NAMECHANGE,	_dup_allownamechange );
-    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_ARCHCHANGE,	_dup_allowarchchange );
-    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_VENDORCHANGE,	_dup_allowvendorchange );
+    solverSetFlags();
 
     sat::Pool::instance().prepare();
 
@@ -665,9 +672,25 @@ SATResolver::solverInit(const PoolItemList & weakItems)
 
     MIL << "SATResolver::solverInit()" << endl;
 
-    // remove old stuff
-    solverEnd();
-    _satSolver = solver_create( _satPool );
+    // Update whatprovides now; an invalidated index would not be noticed
+    // until solving() and the reused package rules would be outdated.
+    sat::Pool::instance().prepare();
+
+    if ( _satSolver && ZConfig::instance().solver_reuseSolver() && _satSolverDeps.isClean( myPool().serialDeps() ) )
+    {
+      // Pool and dependencies unchanged: keep the solver and the package
+      // rules it created; solver_solve just adds the missing ones.
+      MIL << "SATResolver::solverInit() reusing the solver" << endl;
+      queue_empty( &_jobQueue );
+    }
+    else
+    {
+      // remove old stuff
+      solverEnd();
+      _satSolver = solver_create( _satPool );
+      _satSolverDeps.remember( myPool().serialDeps() );
+      queue_init( &_jobQueue );
+    }
     {
       // bsc#1182629: in dup allow an available -release package providing 'dup-vendor-relax(suse)'
       // to let (suse/opensuse) vendor being treated as being equivalent.
@@ -684,8 +707,6 @@ SATResolver::solverInit(const PoolItemList & weakItems)
       ::pool_set_custom_vendorcheck( _satPool, toRelax ? &relaxedVendorCheck : &vendorCheck );
     }
 
-    queue_init( &_jobQueue );
-
     // clear and rebuild: _items_to_install, _items_to_remove, _items_to_lock, _items_to_keep
     {
       SATCollectTransact collector( _items_to_install, _items_to_remove, _items_to_lock, _items_to_keep, solveSrcPackages() );
@@ -894,17 +915,7 @@ void SATResolver::doUpdate()
 	queue_push( &(_jobQueue), SOLVER_DROP_ORPHANED|SOLVER_SOLVABLE_ALL);
 	queue_push( &(_jobQueue), 0 );
     }
-    solverSetFocus( *_satSolver, _focus );
-    solver_set_flag(_satSolver, SOLVER_FLAG_ADD_ALREADY_RECOMMENDED, !_ignorealreadyrecommended);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_DOWNGRADE,		_allowdowngrade);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_NAMECHANGE,		_allownamechange);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_ARCHCHANGE,		_allowarchchange);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_VENDORCHANGE,		_allowvendorchange);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_UNINSTALL,		_allowuninstall);
-    solver_set_flag(_satSolver, SOLVER_FLAG_NO_UPDATEPROVIDE,		_noupdateprovide);
-    solver_set_flag(_satSolver, SOLVER_FLAG_SPLITPROVIDES,		_dosplitprovides);
-    solver_set_flag(_satSolver, SOLVER_FLAG_IGNORE_RECOMMENDED, 	false);		// resolve recommended namespaces
-    solver_set_flag(_satSolver, SOLVER_FLAG_ONLY_NAMESPACE_RECOMMENDED,	_onlyRequires);	//
+    solverSetFlags();
 
     sat::Pool::instance().prepare();
 
@@ -1021,64 +1032,153 @@ inline sat::Solvable mapBuddy( const PoolItem & item_r )
 inline sat::Solvable mapBuddy( sat::Solvable item_r )
 { return mapBuddy( PoolItem( item_r ) ); }
 
-PoolItem SATResolver::mapItem ( const PoolItem & item )
-{ return PoolItem( mapBuddy( item ) ); }
+//----------------------------------------------------------------------------
+// Problem snapshots
+//
+// SATResolver::problems copies what the solver knows about each problem
+// (the rules involved and the solution elements) into plain Ids. The
+// ProblemSolutions are built from this snapshot right away, as they depend
+// on the pools state. Only the (translated) problem descriptions are
+// formatted when the ResolverProblem is accessed for the 1st time. At that
+// time the solver may already be gone or reused for the next run.
+//----------------------------------------------------------------------------
+namespace
+{
 
-sat::Solvable SATResolver::mapSolvable ( const Id & id )
-{ return mapBuddy( sat::Solvable(id) ); }
+inline sat::Solvable mapBuddy( Id id_r )
+{ return mapBuddy( sat::Solvable( id_r ) ); }
 
-std::vector<std::string> SATResolver::SATgetCompleteProblemInfoStrings ( Id problem )
+/** A rule involved in a problem. */
+struct ProblemRule
 {
-  std::vector<std::string> ret;
-  sat::Queue problems;
-  solver_findallproblemrules( _satSolver, problem, problems );
-
-  bool nobad = false;
-
-  //filter out generic rule information if more explicit ones are available
-  for ( sat::Queue::size_type i = 0; i < problems.size(); i++ ) {
-    SolverRuleinfo ruleClass = solver_ruleclass( _satSolver, problems[i]);
-    if ( ruleClass != SolverRuleinfo::SOLVER_RULE_UPDATE && ruleClass != SolverRuleinfo::SOLVER_RULE_JOB ) {
-      nobad = true;
-      break;
-    }
-  }
-  for ( sat::Queue::size_type i = 0; i < problems.size(); i++ ) {
-    SolverRuleinfo ruleClass = solver_ruleclass( _satSolver, problems[i]);
-    if ( nobad && ( ruleClass == SolverRuleinfo::SOLVER_RULE_UPDATE || ruleClass == SolverRuleinfo::SOLVER_RULE_JOB ) ) {
-      continue;
-    }
+  SolverRuleinfo type = SolverRuleinfo(0);
+  Id source = 0;
+  Id target = 0;
+  Id dep = 0;
+  std::string fallback;	// libsolv's text for rule types we do not describe ourself
+};
+
+/** An element of a problems solution (see solver_next_solutionelement). */
+struct SolutionElement
+{
+  Id p = 0;
+  Id rp = 0;
+  Id how = 0;		// SOLVER_SOLUTION_JOB: the jobs SOLVER_SELECTMASK|SOLVER_JOBMASK
+  Id what = 0;		// SOLVER_SOLUTION_JOB: the jobs what
+  int illegal = 0;	// policy replacement: policy_is_illegal
+};
+
+/** A problem, the rules involved and its solutions. */
+struct ProblemSnapshot
+{
+  unsigned idx = 0;				// problem number (for the log)
+  ProblemRule rule;				// the most relevant rule
+  std::vector<ProblemRule> allRules;		// for completeProblemInfo
+  std::vector<std::vector<SolutionElement>> solutions;
+  unsigned breaksSystem = 0;			// number of solutions which would break the system (see addProblemSolutions)
+};
 
-    std::string detail;
-    Id ignore = 0;
-    std::string pInfo = SATproblemRuleInfoString( problems[i], detail, ignore );
+/** Whether \ref problemRuleInfoString describes rules of \a type_r. */
+inline bool isDescribedRuleType( SolverRuleinfo type_r )
+{
+  switch ( type_r )
+  {
+    case SOLVER_RULE_DISTUPGRADE:
+    case SOLVER_RULE_INFARCH:
+    case SOLVER_RULE_UPDATE:
+    case SOLVER_RULE_JOB:
+    case SOLVER_RULE_PKG:
+    case SOLVER_RULE_JOB_NOTHING_PROVIDES_DEP:
+    case SOLVER_RULE_JOB_UNKNOWN_PACKAGE:
+    case SOLVER_RULE_JOB_UNSUPPORTED:
+    case SOLVER_RULE_JOB_PROVIDED_BY_SYSTEM:
+    case SOLVER_RULE_PKG_NOT_INSTALLABLE:
+    case SOLVER_RULE_PKG_NOTHING_PROVIDES_DEP:
+    case SOLVER_RULE_PKG_SAME_NAME:
+    case SOLVER_RULE_PKG_CONFLICTS:
+    case SOLVER_RULE_PKG_OBSOLETES:
+    case SOLVER_RULE_PKG_INSTALLED_OBSOLETES:
+    case SOLVER_RULE_PKG_SELF_CONFLICT:
+    case SOLVER_RULE_PKG_REQUIRES:
+      return true;
+    default:
+      return false;
+  }
+}
 
-    //we get the same string multiple times, reduce the noise
-    if ( std::find( ret.begin(), ret.end(), pInfo ) == ret.end() )
-      ret.push_back( pInfo );
+ProblemRule problemRule( sat::detail::CSolver * solver_r, Id probr_r )
+{
+  ProblemRule ret;
+  ret.type = solver_ruleinfo( solver_r, probr_r, &ret.source, &ret.target, &ret.dep );
+  if ( ! isDescribedRuleType( ret.type ) )
+  {
+    DBG << "Unknown rule type(" << ret.type << ") going to query libsolv for rule information." << endl;
+    ret.fallback = str::asString( ::solver_problemruleinfo2str( solver_r, ret.type, static_cast<Id>(mapBuddy( ret.source ).id()), static_cast<Id>(mapBuddy( ret.target ).id()), ret.dep ) );
   }
   return ret;
 }
 
-std::string SATResolver::SATprobleminfoString(Id problem, std::string &detail, Id &ignoreId)
+ProblemSnapshot problemSnapshot( sat::detail::CSolver * solver_r, const sat::detail::CQueue & jobQueue_r, Id problem_r )
 {
-  // FIXME: solver_findallproblemrules to get all rules for this problem
-  // (the 'most relevabt' one returned by solver_findproblemrule is embedded
-  Id probr = solver_findproblemrule(_satSolver, problem);
-  return SATproblemRuleInfoString( probr, detail, ignoreId );
+  ProblemSnapshot ret;
+  ret.rule = problemRule( solver_r, solver_findproblemrule( solver_r, problem_r ) );
+
+  {
+    sat::Queue problems;
+    solver_findallproblemrules( solver_r, problem_r, problems );
+
+    bool nobad = false;
+
+    //filter out generic rule information if more explicit ones are available
+    for ( sat::Queue::size_type i = 0; i < problems.size(); i++ ) {
+      SolverRuleinfo ruleClass = solver_ruleclass( solver_r, problems[i]);
+      if ( ruleClass != SolverRuleinfo::SOLVER_RULE_UPDATE && ruleClass != SolverRuleinfo::SOLVER_RULE_JOB ) {
+	nobad = true;
+	break;
+      }
+    }
+    for ( sat::Queue::size_type i = 0; i < problems.size(); i++ ) {
+      SolverRuleinfo ruleClass = solver_ruleclass( solver_r, problems[i]);
+      if ( nobad && ( ruleClass == SolverRuleinfo::SOLVER_RULE_UPDATE || ruleClass == SolverRuleinfo::SOLVER_RULE_JOB ) ) {
+	continue;
+      }
+      ret.allRules.push_back( problemRule( solver_r, problems[i] ) );
+    }
+  }
+
+  Id solution = 0;
+  while ( (solution = solver_next_solution( solver_r, problem_r, solution )) != 0 ) {
+    ret.solutions.emplace_back();
+    Id element = 0;
+    SolutionElement el;
+    while ( (element = solver_next_solutionelement( solver_r, problem_r, solution, element, &el.p, &el.rp )) != 0 ) {
+      if ( el.p == SOLVER_SOLUTION_JOB ) {
+	/* job, rp is index into job queue */
+	el.what = jobQueue_r.elements[el.rp];
+	el.how = jobQueue_r.elements[el.rp-1] & (SOLVER_SELECTMASK|SOLVER_JOBMASK);
+      }
+      else if ( el.p > 0 && el.rp ) {
+	el.illegal = policy_is_illegal( solver_r, mapBuddy( el.p ).get(), mapBuddy( el.rp ).get(), 0 );
+      }
+      ret.solutions.back().push_back( el );
+      el = SolutionElement();
+    }
+  }
+  return ret;
 }
 
-std::string SATResolver::SATproblemRuleInfoString (Id probr, std::string &detail, Id &ignoreId)
+std::string problemRuleInfoString( const ProblemRule & rule_r, std::string &detail, Id &ignoreId )
 {
   std::string ret;
-  sat::detail::CPool *pool = _satSolver->pool;
-  Id dep, source, target;
-  SolverRuleinfo type = solver_ruleinfo(_satSolver, probr, &source, &target, &dep);
+  sat::detail::CPool *pool = sat::Pool::instance().get();
+  SolverRuleinfo type = rule_r.type;
+  Id source = rule_r.source;
+  Id dep = rule_r.dep;
 
   ignoreId = 0;
 
-  sat::Solvable s = mapSolvable( source );
-  sat::Solvable s2 = mapSolvable( target );
+  sat::Solvable s = mapBuddy( source );
+  sat::Solvable s2 = mapBuddy( rule_r.target );
 
   // @FIXME, these strings are a duplicate copied from the libsolv library
   // to provide translations. Instead of having duplicate code we should
@@ -1207,7 +1307,7 @@ std::string SATResolver::SATproblemRuleInfoString (Id probr, std::string &detail
 		  if (iter == providerlistInstalled.begin())
 		      detail += itemToString( *iter );
 		  else
-		      detail += "\n                   " + itemToString( mapItem(*iter) );
+		      detail += "\n                   " + itemToString( PoolItem( mapBuddy(*iter) ) );
 	      }
 	  }
 	  if (providerlistUninstalled.size() > 0) {
@@ -1219,323 +1319,369 @@ std::string SATResolver::SATproblemRuleInfoString (Id probr, std::string &detail
 		  if (iter == providerlistUninstalled.begin())
 		      detail += itemToString( *iter );
 		  else
-		      detail += "\n                   " + itemToString( mapItem(*iter) );
+		      detail += "\n                   " + itemToString( PoolItem( mapBuddy(*iter) ) );
 	      }
 	  }
 	  break;
       }
       default: {
-          DBG << "Unknown rule type(" << type << ") going to query libsolv for rule information." << endl;
-          ret = str::asString( ::solver_problemruleinfo2str( _satSolver, type, static_cast<Id>(s.id()), static_cast<Id>(s2.id()), dep ) );
+          ret = rule_r.fallback;	// libsolv's text (see problemRule)
           break;
       }
   }
   return ret;
 }
 
-ResolverProblemList
-SATResolver::problems ()
+/** The solvable whose dependencies may be ignored to solve a problem caused by \a rule_r (or \c 0). */
+inline Id problemIgnoreId( const ProblemRule & rule_r )
 {
-    ResolverProblemList resolverProblems;
-    if (_satSolver && solver_problem_count(_satSolver)) {
-	sat::detail::CPool *pool = _satSolver->pool;
-	int pcnt;
-	Id p, rp, what;
-	Id problem, solution, element;
-	sat::Solvable s, sd;
+  switch ( rule_r.type )
+  {
+    case SOLVER_RULE_PKG_NOTHING_PROVIDES_DEP:
+    case SOLVER_RULE_PKG_REQUIRES:
+      return rule_r.source;
+    default:
+      return 0;
+  }
+}
 
-	CapabilitySet system_requires = SystemCheck::instance().requiredSystemCap();
-	CapabilitySet system_conflicts = SystemCheck::instance().conflictSystemCap();
+/** Format description, details and completeProblemInfo from \a snapshot_r. */
+void formatProblem( const ProblemSnapshot & snapshot_r, std::string & description_r, std::string & details_r, std::vector<std::string> & completeProblemInfo_r )
+{
+    Id ignoreId;
+    description_r = problemRuleInfoString( snapshot_r.rule, details_r, ignoreId );
+    MIL << "Problem " <<  snapshot_r.idx << ": " << description_r << endl;
+
+    for ( const ProblemRule & rule : snapshot_r.allRules ) {
+	std::string detail;
+	Id ignore = 0;
+	std::string pInfo = problemRuleInfoString( rule, detail, ignore );
+
+	//we get the same string multiple times, reduce the noise
+	if ( std::find( completeProblemInfo_r.begin(), completeProblemInfo_r.end(), pInfo ) == completeProblemInfo_r.end() )
+	  completeProblemInfo_r.push_back( pInfo );
+    }
 
-	MIL << "Encountered problems! Here are the solutions:\n" << endl;
-	pcnt = 1;
-	problem = 0;
-	while ((problem = solver_next_problem(_satSolver, problem)) != 0) {
-	    MIL << "Problem " <<  pcnt++ << ":" << endl;
-	    MIL << "====================================" << endl;
-	    std::string detail;
-	    Id ignoreId;
-	    std::string whatString = SATprobleminfoString (problem,detail,ignoreId);
-	    MIL << whatString << endl;
-	    MIL << "------------------------------------" << endl;
-            ResolverProblem_Ptr resolverProblem = new ResolverProblem (whatString, detail, SATgetCompleteProblemInfoStrings( problem ));
-
-	    solution = 0;
-	    while ((solution = solver_next_solution(_satSolver, problem, solution)) != 0) {
-		element = 0;
-		ProblemSolutionCombi *problemSolution = new ProblemSolutionCombi;
-		while ((element = solver_next_solutionelement(_satSolver, problem, solution, element, &p, &rp)) != 0) {
-		    if (p == SOLVER_SOLUTION_JOB) {
-			/* job, rp is index into job queue */
-			what = _jobQueue.elements[rp];
-			switch (_jobQueue.elements[rp-1]&(SOLVER_SELECTMASK|SOLVER_JOBMASK))
-			{
-			    case SOLVER_INSTALL | SOLVER_SOLVABLE: {
-				s = mapSolvable (what);
-				PoolItem poolItem = _pool.find (s);
-				if (poolItem) {
-				    if (pool->installed && s.get()->repo == pool->installed) {
-					problemSolution->addSingleAction (poolItem, REMOVE);
-					std::string description = str::Format(_("remove lock to allow removal of %1%") ) % s.asString();
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    } else {
-					problemSolution->addSingleAction (poolItem, KEEP);
-					std::string description = str::Format(_("do not install %1%") ) % s.asString();
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    }
-				} else {
-				    ERR << "SOLVER_INSTALL_SOLVABLE: No item found for " << s.asString() << endl;
-				}
-			    }
-				break;
-			    case SOLVER_ERASE | SOLVER_SOLVABLE: {
-				s = mapSolvable (what);
-				PoolItem poolItem = _pool.find (s);
-				if (poolItem) {
-				    if (pool->installed && s.get()->repo == pool->installed) {
-					problemSolution->addSingleAction (poolItem, KEEP);
-					std::string description = str::Format(_("keep %1%") ) % s.asString();
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    } else {
-					problemSolution->addSingleAction (poolItem, UNLOCK);
-					std::string description = str::Format(_("remove lock to allow installation of %1%") ) % itemToString( poolItem );
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    }
-				} else {
-				    ERR << "SOLVER_ERASE_SOLVABLE: No item found for " << s.asString() << endl;
-				}
+    for ( unsigned i = 0; i < snapshot_r.breaksSystem; ++i ) {
+	// Show a better warning
+	details_r = description_r + "\n" + details_r;
+	description_r = _("This request will break your system!");
+    }
+}
+
+/** Add the solutions in \a snapshot_r to \a problem_r.
+ * As the problems description is formatted later, the number of solutions
+ * which would break the system is remembered in the snapshot.
+ */
+void addProblemSolutions( ResolverProblem & problem_r, ProblemSnapshot & snapshot_r, const ResPool & pool_r )
+{
+    sat::detail::CPool *pool = sat::Pool::instance().get();
+    Id what;
+    sat::Solvable s, sd;
+
+    CapabilitySet system_requires = SystemCheck::instance().requiredSystemCap();
+    CapabilitySet system_conflicts = SystemCheck::instance().conflictSystemCap();
+
+    snapshot_r.breaksSystem = 0;
+    Id ignoreId = problemIgnoreId( snapshot_r.rule );
+
+    for ( const auto & solution : snapshot_r.solutions ) {
+	ProblemSolutionCombi *problemSolution = new ProblemSolutionCombi;
+	for ( const SolutionElement & el : solution ) {
+	    Id p = el.p;
+	    Id rp = el.rp;
+	    if (p == SOLVER_SOLUTION_JOB) {
+		/* job: el.how and el.what were taken from the job queue */
+		what = el.what;
+		switch (el.how)
+		{
+		    case SOLVER_INSTALL | SOLVER_SOLVABLE: {
+			s = mapBuddy (what);
+			PoolItem poolItem = pool_r.find (s);
+			if (poolItem) {
+			    if (s.isSystem()) {
+				problemSolution->addSingleAction (poolItem, REMOVE);
+				std::string description = str::Format(_("remove lock to allow removal of %1%") ) % s.asString();
+				MIL << description << endl;
+				problemSolution->addDescription (description);
+			    } else {
+				problemSolution->addSingleAction (poolItem, KEEP);
+				std::string description = str::Format(_("do not install %1%") ) % s.asString();
+				MIL << description << endl;
+				problemSolution->addDescription (description);
 			    }
-				break;
-			    case SOLVER_INSTALL | SOLVER_SOLVABLE_NAME:
-				{
-				IdString ident( what );
-				SolverQueueItemInstall_Ptr install =
-				    new SolverQueueItemInstall(_pool, ident.asString(), false );
-				problemSolution->addSingleAction (install, REMOVE_SOLVE_QUEUE_ITEM);
-
-				std::string description = str::Format(_("do not install %1%") ) % ident;
+			} else {
+			    ERR << "SOLVER_INSTALL_SOLVABLE: No item found for " << s.asString() << endl;
+			}
+		    }
+			break;
+		    case SOLVER_ERASE | SOLVER_SOLVABLE: {
+			s = mapBuddy (what);
+			PoolItem poolItem = pool_r.find (s);
+			if (poolItem) {
+			    if (s.isSystem()) {
+				problemSolution->addSingleAction (poolItem, KEEP);
+				std::string description = str::Format(_("keep %1%") ) % s.asString();
 				MIL << description << endl;
 				problemSolution->addDescription (description);
-				}
-				break;
-			    case SOLVER_ERASE | SOLVER_SOLVABLE_NAME:
-				{
-				// As we do not know, if this request has come from resolvePool or
-				// resolveQueue we will have to take care for both cases.
-                                IdString ident( what );
-				FindPackage info (problemSolution, KEEP);
-				invokeOnEach( _pool.byIdentBegin( ident ),
-					      _pool.byIdentEnd( ident ),
-					      functor::chain (resfilter::ByInstalled (),			// ByInstalled
-							      resfilter::ByTransact ()),			// will be deinstalled
-					      functor::functorRef<bool,PoolItem> (info) );
-
-				SolverQueueItemDelete_Ptr del =
-				    new SolverQueueItemDelete(_pool, ident.asString(), false );
-				problemSolution->addSingleAction (del, REMOVE_SOLVE_QUEUE_ITEM);
-
-				std::string description = str::Format(_("keep %1%") ) % ident;
+			    } else {
+				problemSolution->addSingleAction (poolItem, UNLOCK);
+				std::string description = str::Format(_("remove lock to allow installation of %1%") ) % itemToString( poolItem );
 				MIL << description << endl;
 				problemSolution->addDescription (description);
-				}
-				break;
-			    case SOLVER_INSTALL | SOLVER_SOLVABLE_PROVIDES:
-				{
-				problemSolution->addSingleAction (Capability(what), REMOVE_EXTRA_REQUIRE);
-				std::string description = "";
-
-				// Checking if this problem solution would break your system
-				if (system_requires.find(Capability(what)) != system_requires.end()) {
-				    // Show a better warning
-				    resolverProblem->setDetails( resolverProblem->description() + "\n" + resolverProblem->details() );
-				    resolverProblem->setDescription(_("This request will break your system!"));
-				    description = _("ignore the warning of a broken system");
-				    description += std::string(" (requires:")+pool_dep2str(pool, what)+")";
-                                    MIL << description << endl;
-                                    problemSolution->addFrontDescription (description);
-				} else {
-				    description = str::Format(_("do not ask to install a solvable providing %1%") ) % pool_dep2str(pool, what);
-                                    MIL << description << endl;
-                                    problemSolution->addDescription (description);
-				}
-				}
-				break;
-			    case SOLVER_ERASE | SOLVER_SOLVABLE_PROVIDES:
-				{
-				problemSolution->addSingleAction (Capability(what), REMOVE_EXTRA_CONFLICT);
-				std::string description = "";
-
-				// Checking if this problem solution would break your system
-				if (system_conflicts.find(Capability(what)) != system_conflicts.end()) {
-				    // Show a better warning
-				    resolverProblem->setDetails( resolverProblem->description() + "\n" + resolverProblem->details() );
-				    resolverProblem->setDescription(_("This request will break your system!"));
-				    description = _("ignore the warning of a broken system");
-				    description += std::string(" (conflicts:")+pool_dep2str(pool, what)+")";
-                                    MIL << description << endl;
-                                    problemSolution->addFrontDescription (description);
-
-				} else {
-				    description = str::Format(_("do not ask to delete all solvables providing %1%") ) % pool_dep2str(pool, what);
-                                    MIL << description << endl;
-                                    problemSolution->addDescription (description);
-				}
-				}
-				break;
-			    case SOLVER_UPDATE | SOLVER_SOLVABLE:
-				{
-				s = mapSolvable (what);
-				PoolItem poolItem = _pool.find (s);
-				if (poolItem) {
-				    if (pool->installed && s.get()->repo == pool->installed) {
-					problemSolution->addSingleAction (poolItem, KEEP);
-					std::string description = str::Format(_("do not install most recent version of %1%") ) % s.asString();
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    } else {
-					ERR << "SOLVER_INSTALL_SOLVABLE_UPDATE " << poolItem << " is not selected for installation" << endl;
-				    }
-				} else {
-				    ERR << "SOLVER_INSTALL_SOLVABLE_UPDATE: No item found for " << s.asString() << endl;
-				}
-				}
-				break;
-			    default:
-				MIL << "- do something different" << endl;
-				ERR << "No valid solution available" << endl;
-				break;
+			    }
+			} else {
+			    ERR << "SOLVER_ERASE_SOLVABLE: No item found for " << s.asString() << endl;
+			}
+		    }
+			break;
+		    case SOLVER_INSTALL | SOLVER_SOLVABLE_NAME:
+			{
+			IdString ident( what );
+			SolverQueueItemInstall_Ptr install =
+			    new SolverQueueItemInstall(pool_r, ident.asString(), false );
+			problemSolution->addSingleAction (install, REMOVE_SOLVE_QUEUE_ITEM);
+
+			std::string description = str::Format(_("do not install %1%") ) % ident;
+			MIL << description << endl;
+			problemSolution->addDescription (description);
+			}
+			break;
+		    case SOLVER_ERASE | SOLVER_SOLVABLE_NAME:
+			{
+			// As we do not know, if this request has come from resolvePool or
+			// resolveQueue we will have to take care for both cases.
+			IdString ident( what );
+			FindPackage info (problemSolution, KEEP);
+			invokeOnEach( pool_r.byIdentBegin( ident ),
+				      pool_r.byIdentEnd( ident ),
+				      functor::chain (resfilter::ByInstalled (),			// ByInstalled
+						      resfilter::ByTransact ()),			// will be deinstalled
+				      functor::functorRef<bool,PoolItem> (info) );
+
+			SolverQueueItemDelete_Ptr del =
+			    new SolverQueueItemDelete(pool_r, ident.asString(), false );
+			problemSolution->addSingleAction (del, REMOVE_SOLVE_QUEUE_ITEM);
+
+			std::string description = str::Format(_("keep %1%") ) % ident;
+			MIL << description << endl;
+			problemSolution->addDescription (description);
 			}
-		    } else if (p == SOLVER_SOLUTION_INFARCH) {
-			s = mapSolvable (rp);
-			PoolItem poolItem = _pool.find (s);
-			if (pool->installed && s.get()->repo == pool->installed) {
-			    problemSolution->addSingleAction (poolItem, LOCK);
-			    std::string description = str::Format(_("keep %1% despite the inferior architecture") ) % s.asString();
+			break;
+		    case SOLVER_INSTALL | SOLVER_SOLVABLE_PROVIDES:
+			{
+			problemSolution->addSingleAction (Capability(what), REMOVE_EXTRA_REQUIRE);
+			std::string description = "";
+
+			// Checking if this problem solution would break your system
+			if (system_requires.find(Capability(what)) != system_requires.end()) {
+			    ++snapshot_r.breaksSystem;	// a better warning in formatProblem
+			    description = _("ignore the warning of a broken system");
+			    description += std::string(" (requires:")+pool_dep2str(pool, what)+")";
 			    MIL << description << endl;
-			    problemSolution->addDescription (description);
+			    problemSolution->addFrontDescription (description);
 			} else {
-			    problemSolution->addSingleAction (poolItem, INSTALL);
-			    std::string description = str::Format(_("install %1% despite the inferior architecture") ) % s.asString();
+			    description = str::Format(_("do not ask to install a solvable providing %1%") ) % pool_dep2str(pool, what);
 			    MIL << description << endl;
 			    problemSolution->addDescription (description);
 			}
-		    } else if (p == SOLVER_SOLUTION_DISTUPGRADE) {
-			s = mapSolvable (rp);
-			PoolItem poolItem = _pool.find (s);
-			if (pool->installed && s.get()->repo == pool->installed) {
-			    problemSolution->addSingleAction (poolItem, LOCK);
-			    std::string description = str::Format(_("keep obsolete %1%") ) % s.asString();
+			}
+			break;
+		    case SOLVER_ERASE | SOLVER_SOLVABLE_PROVIDES:
+			{
+			problemSolution->addSingleAction (Capability(what), REMOVE_EXTRA_CONFLICT);
+			std::string description = "";
+
+			// Checking if this problem solution would break your system
+			if (system_conflicts.find(Capability(what)) != system_conflicts.end()) {
+			    ++snapshot_r.breaksSystem;	// a better warning in formatProblem
+			    description = _("ignore the warning of a broken system");
+			    description += std::string(" (conflicts:")+pool_dep2str(pool, what)+")";
 			    MIL << description << endl;
-			    problemSolution->addDescription (description);
+			    problemSolution->addFrontDescription (description);
+
 			} else {
-			    problemSolution->addSingleAction (poolItem, INSTALL);
-			    std::string description = str::Format(_("install %1% from excluded repository") ) % s.asString();
+			    description = str::Format(_("do not ask to delete all solvables providing %1%") ) % pool_dep2str(pool, what);
 			    MIL << description << endl;
 			    problemSolution->addDescription (description);
 			}
-		    } else if ( p == SOLVER_SOLUTION_BLACK ) {
-			// Allow to install a blacklisted package (PTF, retracted,...).
-			// For not-installed items only
-			s = mapSolvable (rp);
-			PoolItem poolItem = _pool.find (s);
-
-			problemSolution->addSingleAction (poolItem, INSTALL);
-			std::string description;
-			if ( s.isRetracted() ) {
-			  // translator: %1% is a package name
-			  description = str::Format(_("install %1% although it has been retracted")) % s.asString();
-			} else if ( s.isPtf() ) {
-			  // translator: %1% is a package name
-			  description = str::Format(_("allow to install the PTF %1%")) % s.asString();
-			} else {
-			  // translator: %1% is a package name
-			  description = str::Format(_("install %1% although it is blacklisted")) % s.asString();
 			}
-			MIL << description << endl;
-			problemSolution->addDescription( description );
-		    } else if ( p > 0 ) {
-			/* policy, replace p with rp */
-			s = mapSolvable (p);
-			PoolItem itemFrom = _pool.find (s);
-			if (rp)
+			break;
+		    case SOLVER_UPDATE | SOLVER_SOLVABLE:
 			{
-			    int gotone = 0;
-
-			    sd = mapSolvable (rp);
-			    PoolItem itemTo = _pool.find (sd);
-			    if (itemFrom && itemTo) {
-				problemSolution->addSingleAction (itemTo, INSTALL);
-				int illegal = policy_is_illegal(_satSolver, s.get(), sd.get(), 0);
-
-				if ((illegal & POLICY_ILLEGAL_DOWNGRADE) != 0)
-				{
-				    std::string description = str::Format(_("downgrade of %1% to %2%") ) % s.asString() % sd.asString();
-				    MIL << description << endl;
-				    problemSolution->addDescription (description);
-				    gotone = 1;
-				}
-				if ((illegal & POLICY_ILLEGAL_ARCHCHANGE) != 0)
-				{
-				    std::string description = str::Format(_("architecture change of %1% to %2%") ) % s.asString() % sd.asString();
-				    MIL << description << endl;
-				    problemSolution->addDescription (description);
-				    gotone = 1;
-				}
-				if ((illegal & POLICY_ILLEGAL_VENDORCHANGE) != 0)
-				{
-                                    IdString s_vendor( s.vendor() );
-                                    IdString sd_vendor( sd.vendor() );
-				    std::string description = str::Format(_("install %1% (with vendor change)\n  %2%  -->  %3%") ) % sd.asString() % ( s_vendor ? s_vendor.c_str() : " (no vendor) " ) % ( sd_vendor ? sd_vendor.c_str() : " (no vendor) " );
-				    MIL << description << endl;
-				    problemSolution->addDescription (description);
-				    gotone = 1;
-				}
-				if (!gotone) {
-				    std::string description = str::Format(_("replacement of %1% with %2%") ) % s.asString() % sd.asString();
-				    MIL << description << endl;
-				    problemSolution->addDescription (description);
-				}
+			s = mapBuddy (what);
+			PoolItem poolItem = pool_r.find (s);
+			if (poolItem) {
+			    if (s.isSystem()) {
+				problemSolution->addSingleAction (poolItem, KEEP);
+				std::string description = str::Format(_("do not install most recent version of %1%") ) % s.asString();
+				MIL << description << endl;
+				problemSolution->addDescription (description);
 			    } else {
-				ERR << s.asString() << " or "  << sd.asString() << " not found" << endl;
+				ERR << "SOLVER_INSTALL_SOLVABLE_UPDATE " << poolItem << " is not selected for installation" << endl;
 			    }
+			} else {
+			    ERR << "SOLVER_INSTALL_SOLVABLE_UPDATE: No item found for " << s.asString() << endl;
+			}
 			}
-			else
+			break;
+		    default:
+			MIL << "- do something different" << endl;
+			ERR << "No valid solution available" << endl;
+			break;
+		}
+	    } else if (p == SOLVER_SOLUTION_INFARCH) {
+		s = mapBuddy (rp);
+		PoolItem poolItem = pool_r.find (s);
+		if (s.isSystem()) {
+		    problemSolution->addSingleAction (poolItem, LOCK);
+		    std::string description = str::Format(_("keep %1% despite the inferior architecture") ) % s.asString();
+		    MIL << description << endl;
+		    problemSolution->addDescription (description);
+		} else {
+		    problemSolution->addSingleAction (poolItem, INSTALL);
+		    std::string description = str::Format(_("install %1% despite the inferior architecture") ) % s.asString();
+		    MIL << description << endl;
+		    problemSolution->addDescription (description);
+		}
+	    } else if (p == SOLVER_SOLUTION_DISTUPGRADE) {
+		s = mapBuddy (rp);
+		PoolItem poolItem = pool_r.find (s);
+		if (s.isSystem()) {
+		    problemSolution->addSingleAction (poolItem, LOCK);
+		    std::string description = str::Format(_("keep obsolete %1%") ) % s.asString();
+		    MIL << description << endl;
+		    problemSolution->addDescription (description);
+		} else {
+		    problemSolution->addSingleAction (poolItem, INSTALL);
+		    std::string description = str::Format(_("install %1% from excluded repository") ) % s.asString();
+		    MIL << description << endl;
+		    problemSolution->addDescription (description);
+		}
+	    } else if ( p == SOLVER_SOLUTION_BLACK ) {
+		// Allow to install a blacklisted package (PTF, retracted,...).
+		// For not-installed items only
+		s = mapBuddy (rp);
+		PoolItem poolItem = pool_r.find (s);
+
+		problemSolution->addSingleAction (poolItem, INSTALL);
+		std::string description;
+		if ( s.isRetracted() ) {
+		  // translator: %1% is a package name
+		  description = str::Format(_("install %1% although it has been retracted")) % s.asString();
+		} else if ( s.isPtf() ) {
+		  // translator: %1% is a package name
+		  description = str::Format(_("allow to install the PTF %1%")) % s.asString();
+		} else {
+		  // translator: %1% is a package name
+		  description = str::Format(_("install %1% although it is blacklisted")) % s.asString();
+		}
+		MIL << description << endl;
+		problemSolution->addDescription( description );
+	    } else if ( p > 0 ) {
+		/* policy, replace p with rp */
+		s = mapBuddy (p);
+		PoolItem itemFrom = pool_r.find (s);
+		if (rp)
+		{
+		    int gotone = 0;
+
+		    sd = mapBuddy (rp);
+		    PoolItem itemTo = pool_r.find (sd);
+		    if (itemFrom && itemTo) {
+			problemSolution->addSingleAction (itemTo, INSTALL);
+			int illegal = el.illegal;
+
+			if ((illegal & POLICY_ILLEGAL_DOWNGRADE) != 0)
 			{
-			    if (itemFrom) {
-				std::string description = str::Format(_("deinstallation of %1%") ) % s.asString();
-				MIL << description << endl;
-				problemSolution->addDescription (description);
-				problemSolution->addSingleAction (itemFrom, REMOVE);
-			    }
+			    std::string description = str::Format(_("downgrade of %1% to %2%") ) % s.asString() % sd.asString();
+			    MIL << description << endl;
+			    problemSolution->addDescription (description);
+			    gotone = 1;
+			}
+			if ((illegal & POLICY_ILLEGAL_ARCHCHANGE) != 0)
+			{
+			    std::string description = str::Format(_("architecture change of %1% to %2%") ) % s.asString() % sd.asString();
+			    MIL << description << endl;
+			    problemSolution->addDescription (description);
+			    gotone = 1;
+			}
+			if ((illegal & POLICY_ILLEGAL_VENDORCHANGE) != 0)
+			{
+			    IdString s_vendor( s.vendor() );
+			    IdString sd_vendor( sd.vendor() );
+			    std::string description = str::Format(_("install %1% (with vendor change)\n  %2%  -->  %3%") ) % sd.asString() % ( s_vendor ? s_vendor.c_str() : " (no vendor) " ) % ( sd_vendor ? sd_vendor.c_str() : " (no vendor) " );
+			    MIL << description << endl;
+			    problemSolution->addDescription (description);
+			    gotone = 1;
+			}
+			if (!gotone) {
+			    std::string description = str::Format(_("replacement of %1% with %2%") ) % s.asString() % sd.asString();
+			    MIL << description << endl;
+			    problemSolution->addDescription (description);
 			}
+		    } else {
+			ERR << s.asString() << " or "  << sd.asString() << " not found" << endl;
 		    }
-		    else
-		    {
-		      INT << "Unknown solution " << p << endl;
+		}
+		else
+		{
+		    if (itemFrom) {
+			std::string description = str::Format(_("deinstallation of %1%") ) % s.asString();
+			MIL << description << endl;
+			problemSolution->addDescription (description);
+			problemSolution->addSingleAction (itemFrom, REMOVE);
 		    }
-
 		}
-		resolverProblem->addSolution (problemSolution,
-					      problemSolution->actionCount() > 1 ? true : false); // Solutions with more than 1 action will be shown first.
-		MIL << "------------------------------------" << endl;
 	    }
-
-	    if (ignoreId > 0) {
-		// There is a possibility to ignore this error by setting weak dependencies
-		PoolItem item = _pool.find (sat::Solvable(ignoreId));
-		ProblemSolutionIgnore *problemSolution = new ProblemSolutionIgnore(item);
-		resolverProblem->addSolution (problemSolution,
-					      false); // Solutions will be shown at the end
-		MIL << "ignore some dependencies of " << item << endl;
-		MIL << "------------------------------------" << endl;
+	    else
+	    {
+	      INT << "Unknown solution " << p << endl;
 	    }
 
-	    // save problem
-	    resolverProblems.push_back (resolverProblem);
+	}
+	problem_r.addSolution (problemSolution,
+			       problemSolution->actionCount() > 1 ? true : false); // Solutions with more than 1 action will be shown first.
+	MIL << "------------------------------------" << endl;
+    }
+
+    if (ignoreId > 0) {
+	// There is a possibility to ignore this error by setting weak dependencies
+	PoolItem item = pool_r.find (sat::Solvable(ignoreId));
+	ProblemSolutionIgnore *problemSolution = new ProblemSolutionIgnore(item);
+	problem_r.addSolution (problemSolution,
+			       false); // Solutions will be shown at the end
+	MIL << "ignore some dependencies of " << item << endl;
+	MIL << "------------------------------------" << endl;
+    }
+}
+
+} // namespace
+//----------------------------------------------------------------------------
+
+ResolverProblemList
+SATResolver::problems ()
+{
+    ResolverProblemList resolverProblems;
+    if (_satSolver && solver_problem_count(_satSolver)) {
+	MIL << "Encountered problems! Here are the solutions:\n" << endl;
+	unsigned pcnt = 1;
+	Id problem = 0;
+	while ((problem = solver_next_problem(_satSolver, problem)) != 0) {
+	    // Take the snapshot now, only the problems texts are formatted on demand.
+	    auto snapshot = std::make_shared<ProblemSnapshot>( problemSnapshot( _satSolver, _jobQueue, problem ) );
+	    snapshot->idx = pcnt++;
+	    MIL << "Problem " << snapshot->idx << ":" << endl;
+	    MIL << "====================================" << endl;
+	    MIL << str::asString( ::solver_problem2str( _satSolver, problem ) ) << endl;	// libsolv's text, ours is formatted on demand
+	    MIL << "------------------------------------" << endl;
+
+	    ResolverProblem_Ptr resolverProblem( new ResolverProblem(
+	      [snapshot]( std::string & description_r, std::string & details_r, std::vector<std::string> & completeProblemInfo_r ) {
+	        formatProblem( *snapshot, description_r, details_r, completeProblemInfo_r );
+	      } ) );
+	    addProblemSolutions( *resolverProblem, *snapshot, _pool );
+	    resolverProblems.push_back( resolverProblem );
 	}
     }
     return resolverProblems;
@@ -35,6 +35,7 @@ extern "C"
 #include <map>
 #include <string>
 
+#include <zypp/base/SerialNumber.h>
 #include <zypp/solver/Types.h>
 
 /////////////////////////////////////////////////////////////////////////
@@ -70,6 +71,8 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
     sat::detail::CPool *_satPool;
     sat::detail::CSolver *_satSolver;
     sat::detail::CQueue _jobQueue;
+    // pool dependency serial _satSolver was created for (solver.reuseSolver)
+    SerialNumberWatcher _satSolverDeps;
 
     // list of problematic items (orphaned)
     PoolItemList _problem_items;
@@ -108,13 +111,12 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
 
   private:
     // ---------------------------------- methods
-    std::string SATprobleminfoString (Id problem, std::string &detail, Id &ignoreId);
-    std::string SATproblemRuleInfoString (Id rule, std::string &detail, Id &ignoreId);
-    std::vector<std::string> SATgetCompleteProblemInfoStrings ( Id problem );
     void resetItemTransaction (PoolItem item);
 
     // Create a SAT solver and reset solver selection in the pool (Collecting
     void solverInit(const PoolItemList & weakItems);
+    // set focus and all solver flags (a reused solver keeps the previous ones)
+    void solverSetFlags();
     // common solver run with the _jobQueue; Save results back to pool
     bool solving(const CapabilitySet & requires_caps = CapabilitySet(),
 		 const CapabilitySet & conflict_caps = CapabilitySet());
@@ -125,15 +127,6 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
     // set requirements for a running system
     void setSystemRequirements();
 
-   // Checking if this solvable/item has a buddy which reflect the real
-   // user visible description of an item
-   // e.g. The release package has a buddy to the concerning product item.
-   // This user want's the message "Product foo conflicts with product bar" and
-   // NOT "package release-foo conflicts with package release-bar"
-   // So these functions return the concerning buddy (e.g. product item)
-    sat::Solvable mapSolvable (const Id &id);
-    PoolItem mapItem (const PoolItem &item);
-
   public:
 
     SATResolver (const ResPool & pool, sat::detail::CPool *satPool);
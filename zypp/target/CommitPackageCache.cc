@@ -102,6 +102,9 @@ namespace zypp
       return ret;
     }
 
+    void RepoProvidePackage::setPrefetchPath( const Pathname & path_r )
+    { _impl->_access.setPrefetchPath( path_r ); }
+
     ///////////////////////////////////////////////////////////////////
     //
     //	CLASS NAME : CommitPackageCache
@@ -44,6 +44,9 @@ namespace zypp
       /** Provide package optionally fron cache only. */
       ManagedFile operator()( const PoolItem & pi, bool fromCache_r );
 
+      /** Also use packages prefetched into \a path_r (\see repo::RepoMediaAccess::setPrefetchPath). */
+      void setPrefetchPath( const Pathname & path_r );
+
     private:
       struct Impl;
       RW_pointer<Impl> _impl;
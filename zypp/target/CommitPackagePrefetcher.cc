@@ -0,0 +1,277 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/target/CommitPackagePrefetcher.cc
+ *
+*/
+#include <iostream>
+#include <fstream>
+#include <future>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/Gettext.h>
+#include <zypp/base/WorkerPool_p.h>
+#include <zypp/Package.h>
+#include <zypp/SrcPackage.h>
+#include <zypp/ResPool.h>
+#include <zypp/ZConfig.h>
+#include <zypp/ZYppCallbacks.h>
+#include <zypp/PathInfo.h>
+#include <zypp/repo/Applydeltarpm.h>
+#include <zypp/repo/DeltaCandidates.h>
+#include <zypp/media/CurlHelper.h>
+#include <zypp/media/CredentialManager.h>
+#include <zypp/media/MediaException.h>
+#include <zypp/zyppng/base/EventDispatcher>
+#include <zypp/zyppng/media/network/downloader.h>
+#include <zypp/zyppng/media/network/networkrequestdispatcher.h>
+
+#include <zypp/target/CommitPackagePrefetcher_p.h>
+
+using std::endl;
+
+#undef  ZYPP_BASE_LOGGER_LOGGROUP
+#define ZYPP_BASE_LOGGER_LOGGROUP "zypp::target::prefetch"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace target
+  {
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** A package to prefetch. */
+      struct Job
+      {
+	PoolItem _pi;
+	OnMediaLocation _loc;
+	std::vector<Url> _urls;		//!< The repos downloading baseurls (mirrors)
+	std::vector<media::TransferSettings> _settings;
+	size_t _current = 0;		//!< The url in use
+	Pathname _target;
+	bool _downloaded = false;
+	std::future<bool> _checked;
+      };
+
+      /** Whether the regular download would try a deltarpm for \a pkg_r. */
+      bool mayUseDeltas( const Package::constPtr & pkg_r, const repo::DeltaCandidates & deltas_r )
+      {
+	static const bool useDeltas = ZConfig::instance().download_use_deltarpm() && applydeltarpm::haveApplydeltarpm();
+	return useDeltas && ! deltas_r.deltaRpms( pkg_r ).empty();
+      }
+
+      /** Setup the \ref Job for \a pi_r unless it needs no (or no plain) download. */
+      bool makeJob( const PoolItem & pi_r, const repo::DeltaCandidates & deltas_r, media::CredentialManager & cm_r, Job & job_r )
+      {
+	Pathname cached;
+	if ( Package::constPtr pkg = pi_r->asKind<Package>() )
+	{
+	  if ( mayUseDeltas( pkg, deltas_r ) )
+	    return false;
+	  cached = pkg->cachedLocation();
+	  job_r._loc = pkg->location();
+	}
+	else if ( SrcPackage::constPtr pkg = pi_r->asKind<SrcPackage>() )
+	{
+	  cached = pkg->cachedLocation();
+	  job_r._loc = pkg->location();
+	}
+	else
+	  return false;
+
+	if ( ! cached.empty() || job_r._loc.checksum().empty() )
+	  return false;	// in cache or no checksum to find it in staging
+
+	RepoInfo info( pi_r.repoInfo() );
+	const Pathname relpath( info.path() / job_r._loc.filename() );
+	for_( it, info.baseUrlsBegin(), info.baseUrlsEnd() )
+	{
+	  if ( ! it->schemeIsDownloading() )
+	    continue;
+	  media::TransferSettings settings;
+	  try
+	  {
+	    internal::fillSettingsFromUrl( *it, settings );
+	    if ( settings.proxy().empty() )
+	      internal::fillSettingsSystemProxy( *it, settings );
+	  }
+	  catch ( const media::MediaException & excpt )
+	  {
+	    ZYPP_CAUGHT( excpt );
+	    continue;
+	  }
+	  if ( settings.userPassword().empty() )
+	  {
+	    media::AuthData_Ptr cred( cm_r.getCred( *it ) );
+	    if ( cred && cred->valid() )
+	    {
+	      settings.setUsername( cred->username() );
+	      settings.setPassword( cred->password() );
+	    }
+	  }
+	  Url url( internal::clearQueryString( *it ) );
+	  url.appendPathName( relpath );
+	  job_r._urls.push_back( std::move(url) );
+	  job_r._settings.push_back( std::move(settings) );
+	}
+	if ( job_r._urls.empty() )
+	  return false;
+
+	job_r._pi = pi_r;
+	job_r._target = Pathname( info.alias() ) / relpath;	// relative to the staging dir
+	return true;
+      }
+
+      /** Worker thread: remove the staged file unless its checksum is ok. */
+      bool checkStaged( const Pathname & file_r, const CheckSum & checksum_r )
+      {
+	if ( checksum_r == CheckSum( checksum_r.type(), std::ifstream( file_r.c_str() ) ) )
+	  return true;
+	WAR << "Checksum mismatch, dropping prefetched " << file_r << endl;
+	filesystem::unlink( file_r );
+	return false;
+      }
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
+    CommitPackagePrefetcher::CommitPackagePrefetcher( unsigned parallel_r )
+    : _parallel( parallel_r )
+    {}
+
+    CommitPackagePrefetcher::~CommitPackagePrefetcher()
+    {}
+
+    unsigned CommitPackagePrefetcher::prefetch( const std::vector<PoolItem> & items_r )
+    {
+      if ( _parallel < 2 )
+	return 0;
+
+      std::vector<Job> jobs;
+      {
+	const ResPool & pool( ResPool::instance() );
+	repo::DeltaCandidates deltas( std::list<Repository>( pool.knownRepositoriesBegin(), pool.knownRepositoriesEnd() ) );
+	media::CredentialManager cm( media::CredManagerOptions( ZConfig::instance().repoManagerRoot() ) );
+	for ( const PoolItem & pi : items_r )
+	{
+	  Job job;
+	  if ( makeJob( pi, deltas, cm, job ) )
+	    jobs.push_back( std::move(job) );
+	}
+      }
+      if ( jobs.size() < 2 )
+	return 0;	// nothing to gain
+
+      if ( ! _dir )
+      {
+	// Next to the package cache, so the files can be hardlinked into it.
+	const Pathname parent( jobs.front()._pi.repoInfo().packagesPath().dirname() );
+	if ( filesystem::assert_dir( parent ) == 0 )
+	  _dir = filesystem::TmpDir( parent, ".prefetch." );
+	if ( ! _dir )
+	{
+	  WAR << "No staging directory in " << parent << ", not prefetching." << endl;
+	  return 0;
+	}
+      }
+      MIL << "Prefetching " << jobs.size() << " packages into " << _dir.path() << " (" << _parallel << " parallel)" << endl;
+
+      std::shared_ptr<zyppng::EventDispatcher> ev( zyppng::EventDispatcher::instance() );
+      if ( ! ev )
+	ev = zyppng::EventDispatcher::createMain();
+
+      ProgressData progress( jobs.size() );
+      progress.name( _("Downloading packages") );
+      callback::SendReport<ProgressReport> report;
+      progress.sendTo( ProgressReportAdaptor( ProgressData::ReceiverFnc(), report ) );
+      progress.toMin();
+
+      WorkerPool checkers( std::min( _parallel, WorkerPool::defaultSize() ) );
+      {
+	zyppng::Downloader downloader;
+	downloader.requestDispatcher()->setMaximumConcurrentConnections( _parallel );
+
+	std::vector<zyppng::Download::Ptr> downloads;
+	std::vector<sigc::connection> connections;
+	downloads.reserve( jobs.size() );
+	size_t running = 0;
+	bool aborted = false;
+
+	// Download the job from its current url; on failure from the next one.
+	std::function<void(Job &)> start;
+	start = [&]( Job & job_r ) {
+	  zyppng::Download::Ptr dl( downloader.downloadFile( job_r._urls[job_r._current], job_r._target, job_r._loc.downloadSize() ) );
+	  dl->settings() = job_r._settings[job_r._current];
+	  connections.push_back( dl->sigFinished().connect( [&,jobp=&job_r]( zyppng::Download & dl_r ) {
+	    --running;
+	    if ( dl_r.state() == zyppng::Download::Success )
+	    {
+	      jobp->_downloaded = true;
+	      // verify while the others are still downloading
+	      jobp->_checked = checkers.submit( [target=jobp->_target,checksum=jobp->_loc.checksum()]() {
+		return checkStaged( target, checksum );
+	      } );
+	    }
+	    else
+	    {
+	      DBG << "Prefetching " << dl_r.url() << " failed: " << dl_r.errorString() << endl;
+	      if ( ! aborted && ++jobp->_current < jobp->_urls.size() )
+	      {
+		start( *jobp );	// try the next mirror
+		return;
+	      }
+	    }
+
+	    if ( ! progress.incr() )
+	      aborted = true;
+	    if ( running == 0 || aborted )
+	      ev->quit();
+	  } ) );
+	  ++running;
+	  dl->start();
+	  downloads.push_back( std::move(dl) );
+	};
+
+	for ( Job & job : jobs )
+	{
+	  job._target = _dir.path() / job._target;
+	  if ( filesystem::assert_dir( job._target.dirname() ) != 0 )
+	    continue;
+	  start( job );
+	}
+
+	if ( running )
+	  ev->run();
+	if ( aborted )
+	  WAR << "Prefetching aborted by the user" << endl;
+
+	// pending downloads are dropped with the Downloader, but must
+	// not call back into this scope.
+	for ( sigc::connection & conn : connections )
+	  conn.disconnect();
+	downloads.clear();
+      }
+
+      unsigned staged = 0;
+      for ( Job & job : jobs )
+      {
+	if ( job._checked.valid() && job._checked.get() )
+	  ++staged;
+	else if ( ! job._downloaded )
+	  filesystem::unlink( job._target );	// maybe partially downloaded
+      }
+      progress.toMax();
+      MIL << "Prefetched " << staged << " of " << jobs.size() << " packages" << endl;
+      return staged;
+    }
+
+  } // namespace target
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
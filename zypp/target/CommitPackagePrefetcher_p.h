@@ -0,0 +1,75 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/target/CommitPackagePrefetcher_p.h
+ * This file contains private API, it will change without notice.
+ * You have been warned.
+*/
+#ifndef ZYPP_TARGET_COMMITPACKAGEPREFETCHER_P_H
+#define ZYPP_TARGET_COMMITPACKAGEPREFETCHER_P_H
+
+#include <vector>
+
+#include <zypp/APIConfig.h>
+#include <zypp/PoolItem.h>
+#include <zypp/TmpPath.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace target
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// \class CommitPackagePrefetcher
+    /// \brief Download the packages of a commit in parallel.
+    ///
+    /// Packages not yet in the cache are downloaded from the repos baseurls
+    /// (the next one if a download fails) using the zyppng \c Downloader, up
+    /// to \c parallel_r at a time. Credentials are taken from the url or the
+    /// \ref media::CredentialManager.
+    /// The checksum of each file is verified on a worker thread as soon as
+    /// it arrives.
+    ///
+    /// The files are staged in \ref path as <tt>alias/repopath/location</tt>,
+    /// a temporary directory next to the package cache, NOT in the cache
+    /// itself. Passing \ref path to \ref RepoProvidePackage::setPrefetchPath
+    /// lets the regular download find them there. So the rpm signature check and
+    /// the user callbacks still happen in commit order on the main thread, just
+    /// without waiting for the network.
+    ///
+    /// Anything that does not work out here (auth, failed mirror, deltarpms, ...)
+    /// is silently left to the regular download.
+    ///////////////////////////////////////////////////////////////////
+    class ZYPP_LOCAL CommitPackagePrefetcher
+    {
+    public:
+      /** Ctor taking the max. number of parallel downloads (\c <2 disables prefetching). */
+      explicit CommitPackagePrefetcher( unsigned parallel_r );
+
+      ~CommitPackagePrefetcher();
+
+      /** Download the packages in \a items_r which need a download.
+       * Returns the number of files successfully staged.
+       */
+      unsigned prefetch( const std::vector<PoolItem> & items_r );
+
+      /** The staging directory (empty if not available). */
+      Pathname path() const
+      { return _dir.path(); }
+
+    private:
+      unsigned _parallel;
+      filesystem::TmpPath _dir;	// created on demand
+    };
+
+  } // namespace target
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_TARGET_COMMITPACKAGEPREFETCHER_P_H
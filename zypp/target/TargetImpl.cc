@@ -47,6 +47,7 @@
 #include <zypp/target/TargetCallbackReceiver.h>
 #include <zypp/target/rpm/librpmDb.h>
 #include <zypp/target/CommitPackageCache.h>
+#include <zypp/target/CommitPackagePrefetcher_p.h>
 #include <zypp/target/RpmPostTransCollector.h>
 
 #include <zypp/parser/ProductFileReader.h>
@@ -1384,12 +1385,29 @@ namespace zypp
       if ( ! policy_r.dryRun() || policy_r.downloadMode() == DownloadOnly )
       {
 	// Prepare the package cache. Pass all items requiring download.
-        CommitPackageCache packageCache;
+        RepoProvidePackage repoProvidePackage;
+        CommitPackageCache packageCache( repoProvidePackage );
 	packageCache.setCommitList( steps.begin(), steps.end() );
+        CommitPackagePrefetcher prefetcher( ZConfig::instance().commit_parallelDownloads() );
 
         bool miss = false;
         if ( policy_r.downloadMode() != DownloadAsNeeded )
         {
+          // Download the packages in parallel first. The preload below
+          // picks them up from the staging area, checking the signatures
+          // and sending the usual callbacks in commit order.
+          {
+            std::vector<PoolItem> toDownload;
+            for ( const sat::Transaction::Step & step : steps )
+            {
+              if ( step.stepType() == sat::Transaction::TRANSACTION_INSTALL
+                || step.stepType() == sat::Transaction::TRANSACTION_MULTIINSTALL )
+                toDownload.push_back( PoolItem( step ) );
+            }
+            if ( prefetcher.prefetch( toDownload ) )
+              repoProvidePackage.setPrefetchPath( prefetcher.path() );
+          }
+
           // Preload the cache. Until now this means pre-loading all packages.
           // Once DownloadInHeaps is fully implemented, this will change and
           // we may actually have more than one heap.
@@ -1550,8 +1568,16 @@ namespace zypp
       std::vector<sat::Solvable> successfullyInstalledPackages;
       TargetImpl::PoolItemList remaining;
 
+      if ( ZConfig::instance().commit_singleRpmTransaction() )
+	abort = commitSingleRpmTransaction( policy_r, packageCache_r, result_r, successfullyInstalledPackages );
+
       for_( step, steps.begin(), steps.end() )
       {
+	if ( abort )
+	  break;
+	if ( step->stepStage() != sat::Transaction::STEP_TODO )
+	  continue;	// done in the single rpm transaction
+
 	PoolItem citem( *step );
 	if ( step->stepType() == sat::Transaction::TRANSACTION_IGNORE )
 	{
@@ -1820,6 +1846,167 @@ namespace zypp
 
     ///////////////////////////////////////////////////////////////////
 
+    bool TargetImpl::commitSingleRpmTransaction( const ZYppCommitPolicy & policy_r,
+						 CommitPackageCache & packageCache_r,
+						 ZYppCommitResult & result_r,
+						 std::vector<sat::Solvable> & successfullyInstalledPackages_r )
+    {
+      ZYppCommitResult::TransactionStepList & steps( result_r.rTransactionStepList() );
+      MIL << "TargetImpl::commitSingleRpmTransaction(<list>" << policy_r << ")" << steps.size() << endl;
+
+      // Collect the package steps and provide the rpm files first.
+      std::vector<rpm::RpmDb::TransactionElement> elements;
+      std::vector<sat::Transaction::Step *> elementSteps;
+      std::vector<ManagedFile> localfiles;	// kept until rpm is done
+
+      for ( sat::Transaction::Step & step : steps )
+      {
+	if ( step.stepType() == sat::Transaction::TRANSACTION_IGNORE || step.stepStage() != sat::Transaction::STEP_TODO )
+	  continue;
+	PoolItem citem( step );
+	if ( ! citem->isKind<Package>() )
+	  continue;
+
+	Package::constPtr p = citem->asKind<Package>();
+	rpm::RpmDb::TransactionElement element;
+	ManagedFile localfile;
+	if ( citem.status().isToBeInstalled() )
+	{
+	  try
+	  {
+	    localfile = packageCache_r.get( citem );
+	  }
+	  catch ( const AbortRequestException &e )
+	  {
+	    WAR << "commit aborted by the user" << endl;
+	    step.stepStage( sat::Transaction::STEP_ERROR );
+	    return true;
+	  }
+	  catch ( const SkipRequestException &e )
+	  {
+	    ZYPP_CAUGHT( e );
+	    WAR << "Skipping package " << p << " in commit" << endl;
+	    step.stepStage( sat::Transaction::STEP_ERROR );
+	    continue;
+	  }
+	  catch ( const Exception &e )
+	  {
+	    ZYPP_CAUGHT( e );
+	    INT << "Unexpected Error: Skipping package " << p << " in commit" << endl;
+	    step.stepStage( sat::Transaction::STEP_ERROR );
+	    continue;
+	  }
+	  element.kind      = rpm::RpmDb::TransactionElement::INSTALL;
+	  element.file      = localfile;
+	  element.noUpgrade = p->multiversionInstall();
+	}
+	else
+	{
+	  // 'rpm -e' does not like epochs (like RpmDb::removePackage)
+	  element.kind  = rpm::RpmDb::TransactionElement::ERASE;
+	  element.name  = p->name() + "-" + p->edition().version() + "-" + p->edition().release() + "." + p->arch().asString();
+	  element.epoch = p->edition().epoch();
+	}
+	elements.push_back( std::move(element) );
+	elementSteps.push_back( &step );
+	localfiles.push_back( localfile );
+      }
+
+      if ( elements.empty() )
+	return false;
+
+      // One progress report proxy per element, connected as rpm gets to it.
+      std::vector<std::unique_ptr<RpmInstallPackageReceiver>> installReceivers( elements.size() );
+      std::vector<std::unique_ptr<RpmRemovePackageReceiver>>  removeReceivers( elements.size() );
+      for ( unsigned idx = 0; idx < elements.size(); ++idx )
+      {
+	PoolItem citem( *elementSteps[idx] );
+	if ( elements[idx].kind == rpm::RpmDb::TransactionElement::INSTALL )
+	{
+	  installReceivers[idx].reset( new RpmInstallPackageReceiver( citem.resolvable() ) );
+	  installReceivers[idx]->tryLevel( target::rpm::InstallResolvableReport::RPM_NODEPS_FORCE );
+	}
+	else
+	  removeReceivers[idx].reset( new RpmRemovePackageReceiver( citem.resolvable() ) );
+      }
+
+      // Same flags as in the per-package commit.
+      rpm::RpmInstFlags flags( policy_r.rpmInstFlags() & rpm::RPMINST_JUSTDB );
+      flags |= rpm::RPMINST_NODEPS;
+      flags |= rpm::RPMINST_FORCE;
+      if (policy_r.dryRun())         flags |= rpm::RPMINST_TEST;
+      if (policy_r.rpmExcludeDocs()) flags |= rpm::RPMINST_EXCLUDEDOCS;
+      if (policy_r.rpmNoSignature()) flags |= rpm::RPMINST_NOSIGNATURE;
+
+      result_r.attemptToModify( true );
+      try
+      {
+	rpm().commitTransaction( elements, flags, [&]( unsigned idx_r ) {
+	  if ( installReceivers[idx_r] )
+	    installReceivers[idx_r]->connect();
+	  else
+	    removeReceivers[idx_r]->connect();
+	} );
+      }
+      catch ( const Exception & excpt_r )
+      {
+	// Thrown before rpm touched anything, so all elements are still PENDING.
+	// Like the elements rpm did not process, they are committed per-package below.
+	ZYPP_CAUGHT( excpt_r );
+	WAR << "Single rpm transaction failed, falling back to per-package commit." << endl;
+      }
+
+      bool abort = false;
+      for ( unsigned idx = 0; idx < elements.size(); ++idx )
+      {
+	sat::Transaction::Step & step( *elementSteps[idx] );
+	PoolItem citem( step );
+	bool install = ( elements[idx].kind == rpm::RpmDb::TransactionElement::INSTALL );
+	if ( install ? installReceivers[idx]->aborted() : removeReceivers[idx]->aborted() )
+	{
+	  WAR << "commit aborted by the user" << endl;
+	  abort = true;
+	}
+
+	switch ( elements[idx].state )
+	{
+	  case rpm::RpmDb::TransactionElement::DONE:
+	    if ( install )
+	    {
+	      HistoryLog().install( citem );
+	      if ( citem.isNeedreboot() ) {
+		auto rebootNeededFile = root() / "/run/reboot-needed";
+		if ( filesystem::assert_file( rebootNeededFile ) == EEXIST)
+		  filesystem::touch( rebootNeededFile );
+	      }
+	      if ( ! policy_r.dryRun() )
+		successfullyInstalledPackages_r.push_back( citem.satSolvable() );
+	    }
+	    else
+	      HistoryLog().remove( citem );
+
+	    if ( ! policy_r.dryRun() )
+	      citem.status().resetTransact( ResStatus::USER );
+	    step.stepStage( sat::Transaction::STEP_DONE );
+	    break;
+
+	  case rpm::RpmDb::TransactionElement::FAILED:
+	    WAR << (install ? "Install" : "Removal") << " of " << citem << " failed" << endl;
+	    localfiles[idx].resetDispose(); // keep the package file in the cache
+	    step.stepStage( sat::Transaction::STEP_ERROR );
+	    break;
+
+	  case rpm::RpmDb::TransactionElement::PENDING:
+	    // left to the per-package commit
+	    localfiles[idx].resetDispose(); // keep the package file in the cache
+	    break;
+	}
+      }
+      return abort;
+    }
+
+    ///////////////////////////////////////////////////////////////////
+
     rpm::RpmDb & TargetImpl::rpm()
     {
       return _rpm;
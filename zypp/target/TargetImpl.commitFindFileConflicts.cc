@@ -18,14 +18,28 @@ extern "C"
 #include <solv/repo_rpmdb.h>
 #include <solv/pool_fileconflicts.h>
 }
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <unordered_map>
 #include <unordered_set>
 #include <string>
+#include <vector>
 
 #include <zypp/base/LogTools.h>
 #include <zypp/base/Gettext.h>
 #include <zypp/base/Exception.h>
 #include <zypp/base/UserRequestException.h>
+#include <zypp/base/WorkerPool_p.h>
+#include <zypp/AutoDispose.h>
+#include <zypp/ByteCount.h>
 
 #include <zypp/sat/Queue.h>
 #include <zypp/sat/FileConflicts.h>
@@ -47,11 +61,162 @@ namespace zypp
     ///////////////////////////////////////////////////////////////////
     namespace
     {
+      /** Size of the rpm lead, signature and header, i.e. all but the payload (or \c 0 if not an rpm). */
+      size_t rpmHeaderExtent( const unsigned char * data_r, size_t size_r )
+      {
+	static const unsigned char leadmagic[] = { 0xed, 0xab, 0xee, 0xdb };
+	static const unsigned char headmagic[] = { 0x8e, 0xad, 0xe8, 0x01 };
+	auto getu32 = []( const unsigned char * p ) -> size_t
+	{ return size_t(p[0]) << 24 | size_t(p[1]) << 16 | size_t(p[2]) << 8 | size_t(p[3]); };
+
+	size_t off = 96;	// the lead
+	if ( size_r < off || ::memcmp( data_r, leadmagic, 4 ) != 0 )
+	  return 0;
+	for ( unsigned sect = 0; sect < 2; ++sect )	// signature, header
+	{
+	  if ( size_r < off + 16 || ::memcmp( data_r + off, headmagic, 4 ) != 0 )
+	    return 0;
+	  off += 16 + 16 * getu32( data_r + off + 8 ) + getu32( data_r + off + 12 );
+	  if ( sect == 0 )
+	    off = ( off + 7 ) & ~size_t(7);	// the signature is padded to 8 bytes
+	  if ( size_r < off )
+	    return 0;
+	}
+	return off;
+      }
+
+      /** The rpm header of \a file_r (all but the payload), read via \c mmap. Empty on error. */
+      std::string readRpmHeader( const Pathname & file_r )
+      {
+	std::string ret;
+	AutoFD fd( ::open( file_r.c_str(), O_RDONLY|O_CLOEXEC ) );
+	struct stat st;
+	if ( fd == -1 || ::fstat( fd, &st ) != 0 || st.st_size == 0 )
+	  return ret;
+
+	void * data = ::mmap( nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	if ( data == MAP_FAILED )
+	  return ret;
+	if ( size_t extent = rpmHeaderExtent( static_cast<const unsigned char *>(data), st.st_size ) )
+	  ret.assign( static_cast<const char *>(data), extent );
+	::munmap( data, st.st_size );
+	return ret;
+      }
+
+      ///////////////////////////////////////////////////////////////////
+      /// \class RpmHeaderCache
+      /// \brief The headers of the packages to check, read in parallel.
+      ///
+      /// Only the headers are kept, not the payload. As libsolv wants to parse
+      /// them from a file, \ref open provides them via a memfd. The packages
+      /// local files are remembered, so \ref Package::cachedLocation (which may
+      /// checksum the file) is evaluated just once per package.
+      ///////////////////////////////////////////////////////////////////
+      class RpmHeaderCache
+      {
+      public:
+	/** Upper limit for the cache size; packages beyond are read from disk when needed.
+	 * A 16th of the available memory, but at least 16 MiB and at most 256 MiB.
+	 */
+	static size_t maxSize()
+	{
+	  static const size_t minSize = 16 * 1024 * 1024;
+	  static const size_t topSize = 256 * 1024 * 1024;
+	  long pages = ::sysconf( _SC_AVPHYS_PAGES );
+	  long pagesize = ::sysconf( _SC_PAGESIZE );
+	  if ( pages <= 0 || pagesize <= 0 )
+	    return minSize;
+	  return std::min( topSize, std::max( minSize, size_t(pages) * size_t(pagesize) / 16 ) );
+	}
+
+	/** Read the headers of \a files_r (solvable id and rpm file). */
+	void load( const std::vector<std::pair<sat::detail::IdType,Pathname>> & files_r )
+	{
+	  for ( const auto & file : files_r )
+	    _files[file.first] = file.second;
+
+	  const size_t limit = maxSize();
+	  std::vector<std::string> headers( files_r.size() );
+	  std::atomic<size_t> total( 0 );
+	  std::atomic<unsigned> dropped( 0 );
+	  parallelFor( files_r.size(), [&]( size_t idx_r ) {
+	    if ( files_r[idx_r].second.empty() )
+	      return;
+	    std::string header( readRpmHeader( files_r[idx_r].second ) );
+	    if ( header.empty() )
+	      return;
+	    if ( total.fetch_add( header.size() ) + header.size() > limit )
+	    {
+	      total.fetch_sub( header.size() );
+	      ++dropped;
+	      return;
+	    }
+	    headers[idx_r] = std::move(header);
+	  } );
+
+	  for ( size_t idx = 0; idx < files_r.size(); ++idx )
+	  {
+	    if ( ! headers[idx].empty() )
+	      _headers[files_r[idx].first] = std::move(headers[idx]);
+	  }
+	  MIL << "Cached " << _headers.size() << " of " << files_r.size() << " package headers (" << ByteCount( size_t(total) ) << ")" << endl;
+	  if ( dropped )
+	    WAR << dropped << " package headers exceed the cache limit of " << ByteCount( limit ) << " and are read serially." << endl;
+	}
+
+	/** Whether \ref load was told about \a id_r. */
+	bool knows( sat::detail::IdType id_r ) const
+	{ return _files.count( id_r ); }
+
+	/** The local file of \a id_r passed to \ref load (or empty). */
+	Pathname location( sat::detail::IdType id_r ) const
+	{
+	  auto it = _files.find( id_r );
+	  return it == _files.end() ? Pathname() : it->second;
+	}
+
+	/** A \c FILE* to read the cached header of \a id_r (or \c nullptr) */
+	AutoFILE open( sat::detail::IdType id_r ) const
+	{
+	  auto it = _headers.find( id_r );
+	  if ( it == _headers.end() )
+	    return AutoFILE();
+
+	  AutoFD fd( ::memfd_create( "rpmheader", MFD_CLOEXEC ) );
+	  if ( fd == -1 )
+	    return AutoFILE();
+	  const std::string & header( it->second );
+	  for ( size_t written = 0; written < header.size(); )
+	  {
+	    ssize_t res = ::write( fd, header.data() + written, header.size() - written );
+	    if ( res < 0 )
+	    {
+	      if ( errno == EINTR )
+		continue;
+	      return AutoFILE();
+	    }
+	    written += res;
+	  }
+	  if ( ::lseek( fd, 0, SEEK_SET ) != 0 )
+	    return AutoFILE();
+
+	  FILE * fp = ::fdopen( fd, "r" );
+	  if ( fp )
+	    fd.resetDispose();	// owned by fp now
+	  return AutoFILE( fp );
+	}
+
+      private:
+	std::unordered_map<sat::detail::IdType,Pathname> _files;
+	std::unordered_map<sat::detail::IdType,std::string> _headers;
+      };
+
       /** libsolv::pool_findfileconflicts callback providing package header. */
       struct FileConflictsCB
       {
-	FileConflictsCB( sat::detail::CPool * pool_r, ProgressData & progress_r )
+	FileConflictsCB( sat::detail::CPool * pool_r, ProgressData & progress_r, const RpmHeaderCache & headers_r )
 	: _progress( progress_r )
+	, _headers( headers_r )
 	, _state( ::rpm_state_create( pool_r, ::pool_get_rootdir(pool_r) ), ::rpm_state_free )
 	{}
 
@@ -98,19 +263,25 @@ namespace zypp
 	  }
 	  else
 	  {
-	    Package::Ptr pkg( make<Package>( solv ) );
-	    if ( ! pkg )
-	      return nullptr;
-	    Pathname localfile( pkg->cachedLocation() );
+	    Pathname localfile;
+	    if ( _headers.knows( id_r ) )
+	      localfile = _headers.location( id_r );
+	    else if ( Package::Ptr pkg = make<Package>( solv ) )
+	      localfile = pkg->cachedLocation();
 	    if ( localfile.empty() )
 	      return nullptr;
-	    AutoDispose<FILE*> fp( ::fopen( localfile.c_str(), "re" ), ::fclose );
+	    AutoFILE fp( _headers.open( id_r ) );
+	    if ( ! fp )
+	      fp = AutoFILE( ::fopen( localfile.c_str(), "re" ) );
+	    if ( ! fp )
+	      return nullptr;
 	    return ::rpm_byfp( _state, fp, localfile.c_str() );
 	  }
 	}
 
       private:
 	ProgressData & _progress;
+	const RpmHeaderCache & _headers;
 	AutoDispose<void*> _state;
 	std::unordered_set<sat::detail::IdType> _visited;
 	sat::Queue _noFilelist;
@@ -134,7 +305,26 @@ namespace zypp
 	if ( ! report->start( progress ) )
 	  ZYPP_THROW( AbortRequestException() );
 
-	FileConflictsCB cb( sat::Pool::instance().get(), progress );
+	// Read the headers of the new packages in parallel, so the
+	// (serial) lookups in pool_findfileconflicts don't wait for the disk.
+	RpmHeaderCache headers;
+	{
+	  std::vector<std::pair<sat::detail::IdType,Pathname>> files;
+	  for ( sat::detail::IdType id : todo )
+	  {
+	    sat::Solvable solv( id );
+	    if ( solv.isSystem() )
+	      continue;
+	    Package::Ptr pkg( make<Package>( solv ) );
+	    if ( ! pkg )
+	      continue;
+	    // also remembered for packages without local file (looked up just once)
+	    files.push_back( std::make_pair( id, pkg->cachedLocation() ) );
+	  }
+	  headers.load( files );
+	}
+
+	FileConflictsCB cb( sat::Pool::instance().get(), progress, headers );
 	// lambda receives progress trigger and translates into report
 	auto sendProgress = [&]( const ProgressData & progress_r )->bool {
 	  if ( ! report->progress( progress_r, cb.noFilelist() ) )
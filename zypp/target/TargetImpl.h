@@ -212,6 +212,15 @@ namespace zypp
 		   CommitPackageCache & packageCache_r,
 		   ZYppCommitResult & result_r );
 
+      /** Commit helper installing and removing all packages in a single rpm transaction.
+       * Steps the transaction did not handle are left \c STEP_TODO for the per-package
+       * commit. Returns whether the user requested to abort.
+       */
+      bool commitSingleRpmTransaction( const ZYppCommitPolicy & policy_r,
+				       CommitPackageCache & packageCache_r,
+				       ZYppCommitResult & result_r,
+				       std::vector<sat::Solvable> & successfullyInstalledPackages_r );
+
       /** Commit helper checking for file conflicts after download. */
       void commitFindFileConflicts( const ZYppCommitPolicy & policy_r, ZYppCommitResult & result_r );
     protected:
@@ -14,6 +14,7 @@ extern "C"
 {
 #include <rpm/rpmcli.h>
 #include <rpm/rpmlog.h>
+#include <rpm/rpmpgp.h>
 }
 #include <cstdlib>
 #include <cstdio>
@@ -28,12 +29,14 @@ extern "C"
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <memory>
 
 #include <zypp/base/Logger.h>
 #include <zypp/base/String.h>
 #include <zypp/base/Gettext.h>
 #include <zypp/base/LocaleGuard.h>
 #include <zypp/base/DtorReset.h>
+#include <zypp/AutoDispose.h>
 
 #include <zypp/Date.h>
 #include <zypp/Pathname.h>
@@ -128,6 +131,12 @@ inline std::string rpmQuoteFilename( const Pathname & path_r )
 #endif
     return path_r;	// no problem with absolute pathnames
   }
+
+  // defined below, next to the package signature check
+  void invalidateCheckPackageTs();
+  bool inProcessChrootSafe( const Pathname & root_r );
+  std::string rpmImportPubkey( const Pathname & root_r, const Pathname & dbPath_r, const Pathname & keyfile_r );
+  std::string rpmEraseLabel( const Pathname & root_r, const Pathname & dbPath_r, const std::string & label_r, bool allmatches_r );
 }
 
 struct KeyRingSignalReceiver : callback::ReceiveReport<KeyRingSignals>
@@ -329,6 +338,7 @@ void RpmDb::initDatabase( Pathname root_r, bool doRebuild_r )
 
   _root   = root_r;
   _dbPath = dbPath_r;
+  invalidateCheckPackageTs();
 
   if ( doRebuild_r )
     rebuildDatabase();
@@ -369,6 +379,7 @@ void RpmDb::closeDatabase()
   // Uninit
   ///////////////////////////////////////////////////////////////////
   _root = _dbPath = Pathname();
+  invalidateCheckPackageTs();
 
   MIL << "closeDatabase: " << *this << endl;
 }
@@ -739,22 +750,10 @@ void RpmDb::importPubkey( const PublicKey & pubkey_r )
   {
     // We must explicitly delete old key IDs first (all releases,
     // that's why we don't call removePubkey here).
-    std::string keyName( "gpg-pubkey-" + keyEd.version() );
-    RpmArgVec opts;
-    opts.push_back ( "-e" );
-    opts.push_back ( "--allmatches" );
-    opts.push_back ( "--" );
-    opts.push_back ( keyName.c_str() );
-    run_rpm( opts, ExternalProgram::Stderr_To_Stdout );
-
-    std::string line;
-    while ( systemReadLine( line ) )
-    {
-      ( str::startsWith( line, "error:" ) ? WAR : DBG ) << line << endl;
-    }
-
-    if ( systemStatus() != 0 )
+    std::string error( eraseLabel( "gpg-pubkey-" + keyEd.version(), true/*allmatches*/ ) );
+    if ( ! error.empty() )
     {
+      WAR << error << endl;
       ERR << "Failed to remove key " << pubkey_r << " from RPM trusted keyring (ignored)" << endl;
     }
     else
@@ -764,32 +763,13 @@ void RpmDb::importPubkey( const PublicKey & pubkey_r )
   }
 
   // import the new key
-  RpmArgVec opts;
-  opts.push_back ( "--import" );
-  opts.push_back ( "--" );
-  std::string pubkeypath( pubkey_r.path().asString() );
-  opts.push_back ( pubkeypath.c_str() );
-  run_rpm( opts, ExternalProgram::Stderr_To_Stdout );
-
-  std::string line;
-  std::vector<std::string> excplines;
-  while ( systemReadLine( line ) )
-  {
-    if ( str::startsWith( line, "error:" ) )
-    {
-      WAR << line << endl;
-      excplines.push_back( std::move(line) );
-    }
-    else
-      DBG << line << endl;
-  }
-
-  if ( systemStatus() != 0 )
+  std::string error( rpmImportPubkey( _root, _dbPath, pubkey_r.path() ) );
+  if ( ! error.empty() )
   {
+    WAR << error << endl;
     // Translator: %1% is a gpg public key
     RpmSubprocessException excp( str::Format(_("Failed to import public key %1%") ) % pubkey_r.asString() );
-    excp.moveToHistory( excplines );
-    excp.addHistory( std::move(error_message) );
+    excp.addHistory( std::move(error) );
     ZYPP_THROW( std::move(excp) );
   }
   else
@@ -832,31 +812,13 @@ void RpmDb::removePubkey( const PublicKey & pubkey_r )
 
   std::string rpm_name("gpg-pubkey-" + found_edition->asString());
 
-  RpmArgVec opts;
-  opts.push_back ( "-e" );
-  opts.push_back ( "--" );
-  opts.push_back ( rpm_name.c_str() );
-  run_rpm( opts, ExternalProgram::Stderr_To_Stdout );
-
-  std::string line;
-  std::vector<std::string> excplines;
-  while ( systemReadLine( line ) )
-  {
-    if ( str::startsWith( line, "error:" ) )
-    {
-      WAR << line << endl;
-      excplines.push_back( std::move(line) );
-    }
-    else
-      DBG << line << endl;
-  }
-
-  if ( systemStatus() != 0 )
+  std::string error( eraseLabel( rpm_name, false/*allmatches*/ ) );
+  if ( ! error.empty() )
   {
+    WAR << error << endl;
     // Translator: %1% is a gpg public key
     RpmSubprocessException excp( str::Format(_("Failed to remove public key %1%") ) % pubkey_r.asString() );
-    excp.moveToHistory( excplines );
-    excp.addHistory( std::move(error_message) );
+    excp.addHistory( std::move(error) );
     ZYPP_THROW( std::move(excp) );
   }
   else
@@ -1147,8 +1109,214 @@ namespace
     { static Rpmlog _rpmlog; return _rpmlog; }
   };
 
+  /** Cheap fingerprint of the rpm database files in \a dbdir_r (size, mtime, inode).
+   * It changes if another process modifies the database, e.g. <tt>rpm -e gpg-pubkey-...</tt>.
+   */
+  std::string rpmDbCookie( const Pathname & dbdir_r )
+  {
+    str::Str ret;
+    for ( const char * file : { "Packages", "Packages.db", "rpmdb.sqlite", "rpmdb.sqlite-wal" } )
+    {
+      PathInfo pi( dbdir_r/file );
+      if ( pi.isFile() )
+	ret << file << ':' << pi.size() << ':' << pi.mtime() << ':' << pi.ino() << ';';
+    }
+    return ret;
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class CheckPackageTs
+  /// \brief Transaction set used to check package signatures.
+  ///
+  /// Loading the keyring from the rpm database is the expensive part
+  /// of a signature check. The keyring stays with the transaction set,
+  /// so the set is reused as long as root, dbpath and the \ref rpmDbCookie
+  /// are unchanged. It is dropped if we modify the rpm keys and on
+  /// \ref RpmDb::initDatabase and \ref RpmDb::closeDatabase. The database
+  /// itself is closed after each check.
+  ///////////////////////////////////////////////////////////////////
+  struct CheckPackageTs
+  {
+    static rpmts get( const Pathname & root_r, const Pathname & dbPath_r )
+    {
+      CheckPackageTs & self( instance() );
+      std::string cookie( rpmDbCookie( root_r / dbPath_r ) );
+      if ( ! self._ts || self._root != root_r || self._dbPath != dbPath_r || self._cookie != cookie )
+      {
+	self._ts = AutoDispose<rpmts>( ::rpmtsCreate(), ::rpmtsFree );
+	::rpmtsSetRootDir( self._ts, root_r.c_str() );
+	::rpmtsSetVSFlags( self._ts, RPMVSF_DEFAULT );
+#ifndef HAVE_NO_RPMTSSETVFYFLAGS
+	::rpmtsSetVfyFlags( self._ts, RPMVSF_DEFAULT );
+#endif
+	self._root = root_r;
+	self._dbPath = dbPath_r;
+	self._cookie = std::move(cookie);
+      }
+      return self._ts;
+    }
+
+    static void invalidate()
+    { instance()._ts.reset(); }
+
+  private:
+    static CheckPackageTs & instance()
+    { static CheckPackageTs & _val( *new CheckPackageTs ); return _val; }	// leaked: no rpm calls at exit
+
+    AutoDispose<rpmts> _ts;
+    Pathname _root;
+    Pathname _dbPath;
+    std::string _cookie;
+  };
+
+  void invalidateCheckPackageTs()
+  { CheckPackageTs::invalidate(); }
+
+  /** Whether rpm may run a transaction for \a root_r in-process.
+   * If the root is not \c /, rpmtsRun chroots the whole process into it.
+   * Every other thread (WorkerPool, async log writer, curl resolver...)
+   * would resolve its paths inside the target root meanwhile. So this is
+   * only done if ours is the only thread of the process.
+   */
+  bool inProcessChrootSafe( const Pathname & root_r )
+  {
+    if ( root_r == "/" )
+      return true;
+
+    unsigned threads = 0;
+    std::ifstream status( "/proc/self/status" );
+    for( std::string line; std::getline( status, line ); )
+    {
+      if ( str::hasPrefix( line, "Threads:" ) )
+      {
+	threads = str::strtonum<unsigned>( str::trim( line.substr( 8 ) ) );
+	break;
+      }
+    }
+    if ( threads != 1 )
+    {
+      WAR << "Not chrooting to " << root_r << " in-process: " << threads << " threads running" << endl;
+      return false;
+    }
+    return true;
+  }
+
+  /** Transaction set to modify the rpm database (like run_rpm using \c --root and \c --dbpath). */
+  AutoDispose<rpmts> writeTs( const Pathname & root_r, const Pathname & dbPath_r, std::string & error_r )
+  {
+    CheckPackageTs::invalidate();	// its keyring gets outdated
+
+    // Invalidate all outstanding database handles as the database gets modified.
+    librpmDb::dbRelease( true );
+    librpmDb::globalInit();
+    ::addMacro( NULL, "_dbpath", NULL, dbPath_r.c_str(), RMIL_CMDLINE );
+
+    AutoDispose<rpmts> ts( ::rpmtsCreate(), ::rpmtsFree );
+    ::rpmtsSetRootDir( ts, root_r.c_str() );
+    if ( ::rpmtsOpenDB( ts, O_RDWR ) )
+      error_r = str::Str() << "rpmtsOpenDB failed: " << root_r << dbPath_r;
+    return ts;
+  }
+
+  /** In-process <tt>rpm --import</tt> of the ASCII armored keys in \a keyfile_r.
+   * Like rpm, each armored block may hold more than one certificate.
+   * Returns the error message, empty on success.
+   */
+  std::string rpmImportPubkey( const Pathname & root_r, const Pathname & dbPath_r, const Pathname & keyfile_r )
+  {
+    std::ifstream in( keyfile_r.c_str() );
+    std::string armor { std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() };
+
+    static const std::string pgpmark( "-----BEGIN PGP " );
+    std::string::size_type start = armor.find( pgpmark );
+    if ( start == std::string::npos )
+      return str::Str() << keyfile_r << ": not an armored public key";
+
+    std::string error;
+    AutoDispose<rpmts> ts( writeTs( root_r, dbPath_r, error ) );
+    if ( ! error.empty() )
+      return error;
+
+    RpmlogCapture rpmlog;
+    unsigned keyno = 1;
+    for ( ; start != std::string::npos; start = armor.find( pgpmark, start + pgpmark.size() ), ++keyno )
+    {
+      uint8_t * pkt = nullptr;
+      size_t pktlen = 0;
+      if ( ::pgpParsePkts( armor.c_str() + start, &pkt, &pktlen ) != PGPARMOR_PUBKEY )
+      {
+	error += ( str::Str() << keyfile_r << ": key " << keyno << " not an armored public key\n" ).str();
+	::free( pkt );
+	continue;
+      }
+
+#ifndef HAVE_NO_PGPPUBKEYCERTLEN
+      // Iterate over the certificates in pkt
+      for ( uint8_t * pkti = pkt; pktlen > 0; )
+      {
+	size_t certlen = 0;
+	if ( ::pgpPubKeyCertLen( pkti, pktlen, &certlen ) )
+	{
+	  error += ( str::Str() << keyfile_r << ": key " << keyno << " import failed\n" ).str();
+	  break;
+	}
+	if ( ::rpmtsImportPubkey( ts, pkti, certlen ) != RPMRC_OK )
+	  error += ( str::Str() << keyfile_r << ": key " << keyno << " import failed\n" ).str();
+	pkti += certlen;
+	pktlen -= certlen;
+      }
+#else
+      if ( ::rpmtsImportPubkey( ts, pkt, pktlen ) != RPMRC_OK )
+	error += ( str::Str() << keyfile_r << ": key " << keyno << " import failed\n" ).str();
+#endif
+      ::free( pkt );
+    }
+
+    if ( ! error.empty() && ! rpmlog.empty() )
+      error += rpmlog;
+    return error;
+  }
+
+  /** In-process <tt>rpm -e</tt> (or <tt>rpm -e --allmatches</tt>) of \a label_r.
+   * Like rpm, without \a allmatches_r a label matching more than one
+   * package is an error.
+   * Returns the error message, empty on success.
+   */
+  std::string rpmEraseLabel( const Pathname & root_r, const Pathname & dbPath_r, const std::string & label_r, bool allmatches_r )
+  {
+    std::string error;
+    AutoDispose<rpmts> ts( writeTs( root_r, dbPath_r, error ) );
+    if ( ! error.empty() )
+      return error;
+
+    std::vector<unsigned> found;
+    rpmdbMatchIterator mi = ::rpmtsInitIterator( ts, RPMDBI_LABEL, label_r.c_str(), 0 );
+    while ( Header h = ::rpmdbNextIterator( mi ) )
+      found.push_back( ::headerGetInstance( h ) );
+    ::rpmdbFreeIterator( mi );
+
+    if ( found.empty() )
+      return str::Str() << "package " << label_r << " is not installed";
+    if ( found.size() > 1 && ! allmatches_r )
+      return str::Str() << "\"" << label_r << "\" specifies multiple packages";
+
+    for ( unsigned instance : found )
+    {
+      mi = ::rpmtsInitIterator( ts, RPMDBI_PACKAGES, &instance, sizeof(instance) );
+      if ( Header h = ::rpmdbNextIterator( mi ) )
+	::rpmtsAddEraseElement( ts, h, instance );
+      ::rpmdbFreeIterator( mi );
+    }
+
+    RpmlogCapture rpmlog;
+    if ( ::rpmtsRun( ts, NULL, RPMPROB_FILTER_NONE ) )
+      return rpmlog.empty() ? label_r + ": erase failed" : rpmlog;
+    return std::string();
+  }
+
   RpmDb::CheckPackageResult doCheckPackageSig( const Pathname & path_r,			// rpm file to check
 					       const Pathname & root_r,			// target root
+					       const Pathname & dbPath_r,		// rpm database below root
 					       bool  requireGPGSig_r,			// whether no gpg signature is to be reported
 					       RpmDb::CheckPackageDetail & detail_r )	// detailed result
   {
@@ -1167,9 +1335,7 @@ namespace
 	::Fclose( fd );
       return RpmDb::CHK_ERROR;
     }
-    rpmts ts = ::rpmtsCreate();
-    ::rpmtsSetRootDir( ts, root_r.c_str() );
-    ::rpmtsSetVSFlags( ts, RPMVSF_DEFAULT );
+    rpmts ts = CheckPackageTs::get( root_r, dbPath_r );
 
     rpmQVKArguments_s qva;
     memset( &qva, 0, sizeof(rpmQVKArguments_s) );
@@ -1177,15 +1343,13 @@ namespace
     // Legacy: In rpm >= 4.15 qva_flags symbols don't exist
     // and qva_flags is not used in signature checking at all.
     qva.qva_flags = (VERIFY_DIGEST|VERIFY_SIGNATURE);
-#else
-    ::rpmtsSetVfyFlags( ts, RPMVSF_DEFAULT );
 #endif
     RpmlogCapture vresult;
     LocaleGuard guard( LC_ALL, "C" );	// bsc#1076415: rpm log output is localized, but we need to parse it :(
     int res = ::rpmVerifySignatures( &qva, ts, fd, path_r.basename().c_str() );
     guard.restore();
 
-    ts = rpmtsFree(ts);
+    ::rpmtsCloseDB( ts );	// the loaded keyring is kept
     ::Fclose( fd );
 
     // results per line...
@@ -1265,13 +1429,13 @@ namespace
 //	METHOD TYPE : RpmDb::CheckPackageResult
 //
 RpmDb::CheckPackageResult RpmDb::checkPackage( const Pathname & path_r, CheckPackageDetail & detail_r )
-{ return doCheckPackageSig( path_r, root(), false/*requireGPGSig_r*/, detail_r ); }
+{ return doCheckPackageSig( path_r, root(), dbPath(), false/*requireGPGSig_r*/, detail_r ); }
 
 RpmDb::CheckPackageResult RpmDb::checkPackage( const Pathname & path_r )
 { CheckPackageDetail dummy; return checkPackage( path_r, dummy ); }
 
 RpmDb::CheckPackageResult RpmDb::checkPackageSignature( const Pathname & path_r, RpmDb::CheckPackageDetail & detail_r )
-{ return doCheckPackageSig( path_r, root(), true/*requireGPGSig_r*/, detail_r ); }
+{ return doCheckPackageSig( path_r, root(), dbPath(), true/*requireGPGSig_r*/, detail_r ); }
 
 
 // determine changed files of installed package
@@ -1469,6 +1633,39 @@ RpmDb::systemKill()
   if (process) process->kill();
 }
 
+/*--------------------------------------------------------------*/
+/* rpm -e [--allmatches] label; in-process unless rpm would	*/
+/* chroot a multithreaded process				*/
+/*--------------------------------------------------------------*/
+std::string
+RpmDb::eraseLabel( const std::string & label_r, bool allmatches_r )
+{
+  if ( inProcessChrootSafe( _root ) )
+    return rpmEraseLabel( _root, _dbPath, label_r, allmatches_r );
+
+  RpmArgVec opts;
+  opts.push_back ( "-e" );
+  if ( allmatches_r )
+    opts.push_back ( "--allmatches" );
+  opts.push_back ( "--" );
+  opts.push_back ( label_r.c_str() );
+  run_rpm( opts, ExternalProgram::Stderr_To_Stdout );
+
+  std::string error;
+  std::string line;
+  while ( systemReadLine( line ) )
+  {
+    if ( str::startsWith( line, "error:" ) )
+      error += line + '\n';
+    else
+      DBG << line << endl;
+  }
+
+  if ( systemStatus() == 0 )
+    return std::string();
+  return error.empty() ? label_r + ": erase failed" : error;
+}
+
 
 // generate diff mails for config files
 void RpmDb::processConfigFiles(const std::string& line, const std::string& name, const char* typemsg, const char* difffailmsg, const char* diffgenmsg)
@@ -1898,6 +2095,491 @@ void RpmDb::doRemovePackage( const std::string & name_r, RpmInstFlags flags, cal
   }
 }
 
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  ///////////////////////////////////////////////////////////////////
+  /// \class RpmTransactionNotify
+  /// \brief Map the rpm transaction callbacks to the per-element reports
+  /// in \ref RpmDb::commitTransaction.
+  ///
+  /// Output of the scriptlets and the rpmlog is collected per element and
+  /// forwarded like the output of an rpm process in doInstallPackage.
+  ///////////////////////////////////////////////////////////////////
+  struct RpmTransactionNotify
+  {
+    typedef RpmDb::TransactionElement Element;
+
+    RpmTransactionNotify( std::vector<Element> & elements_r,
+			  const std::function<void(unsigned)> & activate_r,
+			  const Pathname & scriptout_r )
+    : _elements( elements_r )
+    , _activate( activate_r )
+    , _scriptin( scriptout_r.c_str() )	// now, rpm may have chrooted when we read it
+    {}
+
+    ~RpmTransactionNotify()
+    {
+      finish();
+      writeHistory();
+      if ( _fd )
+	::Fclose( _fd );
+    }
+
+    /** Remember the element an erased header instance belongs to. */
+    void eraseInstance( unsigned instance_r, unsigned idx_r )
+    { _eraseIdx[instance_r] = idx_r; }
+
+    /** Report an element rpm will not process at all. */
+    void failed( unsigned idx_r, const std::string & msg_r )
+    {
+      start( idx_r );
+      error( msg_r );
+      finish();
+    }
+
+    /** After rpmtsRun: Report the elements rpm was silent about. */
+    void complete( bool success_r )
+    {
+      finish();
+      if ( ! success_r && ! _started )
+	return;	// rpm did not touch anything; leave them PENDING
+
+      for ( unsigned idx = 0; idx < _elements.size(); ++idx )
+      {
+	if ( _elements[idx].state != Element::PENDING )
+	  continue;
+	if ( success_r )
+	{
+	  start( idx );
+	  finish();
+	}
+	else
+	  WAR << "Not processed by rpm: " << idx << endl;
+      }
+      writeHistory();
+    }
+
+    /** The config file warnings per element, to be processed by the caller. */
+    const std::vector<std::pair<unsigned,std::string>> & configwarnings() const
+    { return _configwarnings; }
+
+    static void * notifyCB( const void * h_r, const rpmCallbackType what_r,
+			    const rpm_loff_t amount_r, const rpm_loff_t total_r,
+			    fnpyKey key_r, rpmCallbackData data_r )
+    { return reinterpret_cast<RpmTransactionNotify*>(data_r)->notify( (Header)h_r, what_r, amount_r, total_r, key_r ); }
+
+  private:
+    void * notify( Header h_r, rpmCallbackType what_r, rpm_loff_t amount_r, rpm_loff_t total_r, fnpyKey key_r )
+    {
+      switch ( what_r )
+      {
+	case RPMCALLBACK_INST_OPEN_FILE:
+	  // NOTE: rpm may open the file more than once (e.g. to verify it first);
+	  // the element starts with RPMCALLBACK_INST_START.
+	  if ( _fd )
+	    ::Fclose( _fd );
+	  _fd = ::Fopen( elementOf( key_r ).file.c_str(), "r.ufdio" );
+	  if ( _fd == 0 || ::Ferror( _fd ) )
+	  {
+	    ERR << "Can't open file for reading: " << elementOf( key_r ).file << " (" << ::Fstrerror( _fd ) << ")" << endl;
+	    if ( _fd )
+	      ::Fclose( _fd );
+	    _fd = 0;
+	  }
+	  return _fd;
+
+	case RPMCALLBACK_INST_CLOSE_FILE:
+	  if ( _fd )
+	    ::Fclose( _fd );
+	  _fd = 0;
+	  break;
+
+	case RPMCALLBACK_INST_START:
+	  start( indexOf( key_r ) );
+	  break;
+
+	case RPMCALLBACK_INST_PROGRESS:
+	  if ( _ireport )
+	    (*_ireport)->progress( total_r ? amount_r * 100 / total_r : 0 );
+	  break;
+
+	case RPMCALLBACK_INST_STOP:
+	  finish();
+	  break;
+
+	case RPMCALLBACK_UNINST_START:
+	  if ( int idx = eraseIndexOf( h_r ); idx >= 0 )
+	    start( idx );
+	  break;
+
+	case RPMCALLBACK_UNINST_PROGRESS:
+	  if ( _rreport && eraseIndexOf( h_r ) == _current )
+	    (*_rreport)->progress( total_r ? amount_r * 100 / total_r : 0 );
+	  break;
+
+	case RPMCALLBACK_UNINST_STOP:
+	  if ( eraseIndexOf( h_r ) == _current )
+	    finish();
+	  break;
+
+	case RPMCALLBACK_UNPACK_ERROR:
+	case RPMCALLBACK_CPIO_ERROR:
+	  if ( key_r && indexOf( key_r ) == _current )
+	    error( str::form( "%s: unpacking failed", elementOf( key_r ).file.basename().c_str() ) );
+	  break;
+
+	case RPMCALLBACK_SCRIPT_ERROR:
+	  // amount: the scriptlet tag, total: its rpmRC.
+	  // Anything but RPMRC_FAIL is a non-critical scriptlet (just a warning in the rpmlog).
+	  if ( total_r == RPMRC_FAIL )
+	  {
+	    int idx = key_r ? indexOf( key_r ) : eraseIndexOf( h_r );
+	    if ( idx >= 0 && idx == _current )
+	      error( "scriptlet failed" );
+	    else
+	      WAR << "scriptlet failed outside element " << idx << " (tag " << amount_r << ")" << endl;
+	  }
+	  break;
+
+	default:
+	  break;
+      }
+      return nullptr;
+    }
+
+    Element & elementOf( fnpyKey key_r ) const
+    { return *static_cast<Element*>(const_cast<void*>(key_r)); }
+
+    int indexOf( fnpyKey key_r ) const
+    { return &elementOf( key_r ) - &_elements[0]; }
+
+    int eraseIndexOf( Header h_r ) const
+    {
+      if ( ! h_r )
+	return _current;
+      auto it = _eraseIdx.find( ::headerGetInstance( h_r ) );
+      return( it == _eraseIdx.end() ? -1 : int(it->second) );
+    }
+
+    void start( int idx_r )
+    {
+      if ( idx_r == _current )
+	return;
+      finish();
+
+      _current = idx_r;
+      _started = true;
+      _failmsg.clear();
+      const Element & el( _elements[idx_r] );
+      MIL << "RpmDb::commitTransaction " << (el.kind == Element::INSTALL ? "install " : "erase ") << idx_r << ": "
+          << (el.kind == Element::INSTALL ? el.file.asString() : el.name) << endl;
+
+      if ( _activate )
+	_activate( idx_r );
+      if ( el.kind == Element::INSTALL )
+      {
+	_ireport.reset( new callback::SendReport<RpmInstallReport> );
+	(*_ireport)->start( el.file );
+      }
+      else
+      {
+	_rreport.reset( new callback::SendReport<RpmRemoveReport> );
+	(*_rreport)->start( el.name );
+      }
+    }
+
+    void error( const std::string & msg_r )
+    {
+      if ( _current < 0 )
+	return;
+      if ( ! _failmsg.empty() )
+	_failmsg += '\n';
+      _failmsg += msg_r;
+    }
+
+    void finish()
+    {
+      if ( _current < 0 )
+	return;
+
+      Element & el( _elements[_current] );
+      const std::string & elname( el.kind == Element::INSTALL ? el.file.basename() : el.name );
+
+      // forward the collected output via report;
+      std::string output;
+      if ( _scriptin.is_open() )
+      {
+	_scriptin.clear();	// at EOF after the previous element
+	output.assign( std::istreambuf_iterator<char>( _scriptin ), std::istreambuf_iterator<char>() );
+      }
+      output += _rpmlog;
+      _rpmlog.clear();
+
+      std::string line;
+      unsigned    lineno = 0;
+      callback::UserData cmdout( el.kind == Element::INSTALL ? InstallResolvableReport::contentRpmout
+							       : RemoveResolvableReport::contentRpmout );
+      // Key "solvable" injected by RpmInstallPackageReceiver
+      cmdout.set( "line",   std::cref(line) );
+      cmdout.set( "lineno", lineno );
+
+      std::string rpmmsg;
+      std::istringstream in( output );
+      while ( std::getline( in, line ) )
+      {
+	++lineno;
+	cmdout.set( "lineno", lineno );
+	if ( _ireport )
+	  (*_ireport)->report( cmdout );
+	else
+	  (*_rreport)->report( cmdout );
+
+	if ( lineno >= MAXRPMMESSAGELINES ) {
+	  if ( line.find( " scriptlet failed, " ) == std::string::npos )	// always log %script errors
+	    continue;
+	}
+	rpmmsg += line+'\n';
+
+	if ( el.kind == Element::INSTALL && str::startsWith( line, "warning:" ) )
+	  _configwarnings.push_back( std::make_pair( unsigned(_current), line ) );
+      }
+      if ( lineno >= MAXRPMMESSAGELINES )
+	rpmmsg += "[truncated]\n";
+
+      // evaluate result
+      const char * what = ( el.kind == Element::INSTALL ? "install" : "remove" );
+      if ( ! _failmsg.empty() )
+      {
+	el.state = Element::FAILED;
+	history( str::form( "%s %s failed", elname.c_str(), what ), true /*timestamp*/ );
+	std::ostringstream sstr;
+	sstr << "rpm output:" << endl << rpmmsg << endl;
+	history( sstr.str() );
+	// TranslatorExplanation the colon is followed by an error message
+	RpmSubprocessException excpt( _("RPM failed: ") + (rpmmsg.empty() ? _failmsg : rpmmsg) );
+	if ( _ireport )
+	  (*_ireport)->finish( excpt );
+	else
+	  (*_rreport)->finish( excpt );
+      }
+      else
+      {
+	el.state = Element::DONE;
+	if ( ! rpmmsg.empty() )
+	{
+	  history( str::form( "%s %s ok", elname.c_str(), (el.kind == Element::INSTALL ? "installed" : "removed") ), true /*timestamp*/ );
+	  std::ostringstream sstr;
+	  sstr << "Additional rpm output:" << endl << rpmmsg << endl;
+	  history( sstr.str() );
+
+	  // report additional rpm output in finish
+	  // TranslatorExplanation Text is followed by a ':'  and the actual output.
+	  std::string info( str::form( "%s:\n%s\n", _("Additional rpm output"),  rpmmsg.c_str() ) );
+	  if ( _ireport )
+	    (*_ireport)->finishInfo( info );
+	  else
+	    (*_rreport)->finishInfo( info );
+	}
+	if ( _ireport )
+	  (*_ireport)->finish();
+	else
+	  (*_rreport)->finish();
+      }
+
+      _ireport.reset();
+      _rreport.reset();
+      _current = -1;
+    }
+
+    /** Queue a HistoryLog comment; the file may not be reachable while rpm has chrooted. */
+    void history( std::string comment_r, bool timestamp_r = false )
+    { _history.push_back( std::make_pair( std::move(comment_r), timestamp_r ) ); }
+
+    /** Write the queued comments (after rpmtsRun). */
+    void writeHistory()
+    {
+      if ( _history.empty() )
+	return;
+      HistoryLog historylog;
+      for ( const auto & comment : _history )
+	historylog.comment( comment.first, comment.second );
+      _history.clear();
+    }
+
+  private:
+    std::vector<Element> &			_elements;
+    const std::function<void(unsigned)> &	_activate;
+    std::ifstream				_scriptin;
+    std::vector<std::pair<std::string,bool>>	_history;
+    RpmlogCapture				_rpmlog;
+    std::map<unsigned,unsigned>			_eraseIdx;	// header instance -> element
+    std::vector<std::pair<unsigned,std::string>>	_configwarnings;
+
+    FD_t _fd		= 0;
+    int  _current	= -1;
+    bool _started	= false;
+    std::string _failmsg;
+    std::unique_ptr<callback::SendReport<RpmInstallReport>> _ireport;
+    std::unique_ptr<callback::SendReport<RpmRemoveReport>>  _rreport;
+  };
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+void RpmDb::commitTransaction( std::vector<TransactionElement> & elements_r, RpmInstFlags flags_r, const std::function<void(unsigned)> & activate_r )
+{
+  FAILIFNOTINITIALIZED;
+  MIL << "RpmDb::commitTransaction(" << elements_r.size() << "," << flags_r << ")" << endl;
+  if ( elements_r.empty() )
+    return;
+
+  if ( ! inProcessChrootSafe( _root ) )
+    ZYPP_THROW( RpmException( "In-process rpm transaction refused: other threads are running" ) );
+
+  // backup
+  if ( _packagebackups )
+  {
+    for ( const TransactionElement & el : elements_r )
+    {
+      if ( el.kind == TransactionElement::INSTALL ? ! backupPackage( el.file ) : ! backupPackage( el.name ) )
+	ERR << "backup of " << (el.kind == TransactionElement::INSTALL ? el.file.asString() : el.name) << " failed" << endl;
+    }
+  }
+
+  // Invalidate all outstanding database handles as the database gets modified.
+  librpmDb::dbRelease( true );
+  librpmDb::globalInit();
+  ::addMacro( NULL, "_dbpath", NULL, _dbPath.asString().c_str(), RMIL_CMDLINE );
+
+  AutoDispose<rpmts> ts( ::rpmtsCreate(), ::rpmtsFree );
+  ::rpmtsSetRootDir( ts, _root.c_str() );
+  if ( ::rpmtsOpenDB( ts, (flags_r & RPMINST_TEST) ? O_RDONLY : O_RDWR ) )
+  {
+    ERR << "rpmtsOpenDB failed: " << _root << _dbPath << endl;
+    ZYPP_THROW(RpmDbOpenException( _root, _dbPath ));
+  }
+
+  rpmtransFlags transFlags = RPMTRANS_FLAG_NONE;
+  if ( flags_r & RPMINST_JUSTDB )
+    transFlags |= RPMTRANS_FLAG_JUSTDB;
+  if ( flags_r & RPMINST_TEST )
+    transFlags |= RPMTRANS_FLAG_TEST;
+  if ( flags_r & RPMINST_NOSCRIPTS )
+    transFlags |= RPMTRANS_FLAG_NOSCRIPTS;
+  if ( flags_r & RPMINST_EXCLUDEDOCS )
+    transFlags |= RPMTRANS_FLAG_NODOCS;
+  if ( flags_r & RPMINST_NOPOSTTRANS )
+    transFlags |= RPMTRANS_FLAG_NOPOSTTRANS;
+  ::rpmtsSetFlags( ts, transFlags );
+
+  unsigned vsflag = RPMVSF_DEFAULT;
+  if ( flags_r & RPMINST_NODIGEST )
+    vsflag |= _RPMVSF_NODIGESTS;
+  if ( flags_r & RPMINST_NOSIGNATURE )
+    vsflag |= _RPMVSF_NOSIGNATURES;
+  ::rpmtsSetVSFlags( ts, rpmVSFlags(vsflag) );
+
+  // Same as '--force', '--ignoresize' and '--ignorearch' in doInstallPackage
+  rpmprobFilterFlags probFilter = RPMPROB_FILTER_NONE;
+  if ( flags_r & RPMINST_FORCE )
+    probFilter |= RPMPROB_FILTER_REPLACEPKG | RPMPROB_FILTER_REPLACEOLDFILES | RPMPROB_FILTER_REPLACENEWFILES | RPMPROB_FILTER_OLDPACKAGE;
+  if ( flags_r & RPMINST_IGNORESIZE )
+    probFilter |= RPMPROB_FILTER_DISKSPACE | RPMPROB_FILTER_DISKNODES;
+  if ( ! ZConfig::instance().systemArchitecture().compatibleWith( ZConfig::instance().defaultSystemArchitecture() ) )
+    probFilter |= RPMPROB_FILTER_IGNOREARCH | RPMPROB_FILTER_IGNOREOS;
+
+  // scriptlet output is collected here and forwarded per element
+  filesystem::TmpFile scriptout;
+  FD_t scriptfd = ::Fopen( scriptout.path().c_str(), "w.ufdio" );
+  if ( scriptfd && ! ::Ferror( scriptfd ) )
+    ::rpmtsSetScriptFd( ts, scriptfd );
+
+  RpmTransactionNotify notify( elements_r, activate_r, scriptout.path() );
+
+  for ( unsigned idx = 0; idx < elements_r.size(); ++idx )
+  {
+    TransactionElement & el( elements_r[idx] );
+    if ( el.kind == TransactionElement::INSTALL )
+    {
+      Header h = 0;
+      FD_t fd = ::Fopen( el.file.c_str(), "r.ufdio" );
+      if ( fd && ! ::Ferror( fd ) )
+	::rpmReadPackageFile( ts, fd, el.file.c_str(), &h );
+      if ( fd )
+	::Fclose( fd );
+
+      if ( ! h )
+	notify.failed( idx, str::form( "%s: %s", el.file.c_str(), "can't read the package header" ) );
+      else if ( ::rpmtsAddInstallElement( ts, h, &el, el.noUpgrade ? 0 : 1, NULL ) )
+	notify.failed( idx, str::form( "%s: %s", el.file.c_str(), "can't add the package to the transaction" ) );
+      if ( h )
+	::headerFree( h );
+    }
+    else
+    {
+      // like 'rpm -e --allmatches', but the label does not tell the epoch
+      unsigned found = 0;
+      rpmdbMatchIterator mi = ::rpmtsInitIterator( ts, RPMDBI_LABEL, el.name.c_str(), 0 );
+      while ( Header h = ::rpmdbNextIterator( mi ) )
+      {
+	if ( ::headerGetNumber( h, RPMTAG_EPOCH ) != el.epoch )
+	  continue;
+	unsigned instance = ::headerGetInstance( h );
+	if ( ::rpmtsAddEraseElement( ts, h, instance ) == 0 )
+	{
+	  notify.eraseInstance( instance, idx );
+	  ++found;
+	}
+      }
+      ::rpmdbFreeIterator( mi );
+
+      if ( ! found )
+	notify.failed( idx, str::form( "%s: %s", el.name.c_str(), "package is not installed" ) );
+    }
+  }
+
+  // The elements are processed in the order they were added (no rpmtsOrder).
+  ::rpmtsSetNotifyCallback( ts, RpmTransactionNotify::notifyCB, &notify );
+  int res = ::rpmtsRun( ts, NULL, probFilter );
+  ::rpmtsSetNotifyCallback( ts, NULL, NULL );
+  notify.complete( res == 0 );
+
+  if ( res )
+  {
+    std::string problems;
+    rpmps ps = ::rpmtsProblems( ts );
+    rpmpsi psi = ::rpmpsInitIterator( ps );
+    while ( ::rpmpsNextIterator( psi ) >= 0 )
+    {
+      char * msg = ::rpmProblemString( ::rpmpsGetProblem( psi ) );
+      problems += str::form( "    %s\n", msg );
+      ::free( msg );
+    }
+    ::rpmpsFreeIterator( psi );
+    ::rpmpsFree( ps );
+    WAR << "rpmtsRun returned " << res << endl << problems;
+  }
+
+  ::rpmtsSetScriptFd( ts, NULL );
+  if ( scriptfd )
+    ::Fclose( scriptfd );
+
+  for ( const auto & warning : notify.configwarnings() )
+  {
+    const std::string & name( elements_r[warning.first].file.basename() );
+    processConfigFiles(warning.second, name, " saved as ",
+                       // %s = filenames
+                       _("rpm saved %s as %s, but it was impossible to determine the difference"),
+                       // %s = filenames
+                       _("rpm saved %s as %s.\nHere are the first 25 lines of difference:\n"));
+    processConfigFiles(warning.second, name, " created as ",
+                       // %s = filenames
+                       _("rpm created %s as %s, but it was impossible to determine the difference"),
+                       // %s = filenames
+                       _("rpm created %s as %s.\nHere are the first 25 lines of difference:\n"));
+  }
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 //
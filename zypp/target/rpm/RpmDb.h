@@ -16,6 +16,7 @@
 #define ZYPP_TARGET_RPM_RPMDB_H
 
 #include <iosfwd>
+#include <functional>
 #include <list>
 #include <vector>
 #include <string>
@@ -290,6 +291,13 @@ private:
                 ExternalProgram::Stderr_Disposition stderr_disp =
                   ExternalProgram::Stderr_To_Stdout);
 
+  /**
+   * Like <tt>rpm -e [--allmatches] label_r</tt>. Done in-process, unless
+   * rpm would have to chroot a process running other threads.
+   * Returns the error message, empty on success.
+   */
+  std::string eraseLabel( const std::string & label_r, bool allmatches_r );
+
 
   /**
    * Read a line from the general rpm query
@@ -417,6 +425,49 @@ public:
   void removePackage( const std::string & name_r, RpmInstFlags flags = RPMINST_NONE );
   void removePackage( Package::constPtr package, RpmInstFlags flags = RPMINST_NONE );
 
+  /** One element of a \ref commitTransaction. */
+  struct TransactionElement
+  {
+    enum Kind  { INSTALL, ERASE };
+    enum State { PENDING, DONE, FAILED };
+
+    Kind        kind	= INSTALL;
+    Pathname    file;			//!< INSTALL: the rpm file
+    std::string name;			//!< ERASE: the installed package (NVRA, like \c rpm -e)
+    Edition::epoch_t epoch	= 0;		//!< ERASE: the installed packages epoch (not part of \c name)
+    bool        noUpgrade	= false;	//!< INSTALL: do not replace older versions (multiversion)
+    State       state	= PENDING;	//!< The outcome
+  };
+
+  /** Install and remove packages in a single in-process rpm transaction.
+   *
+   * Unlike \ref installPackage and \ref removePackage, which run one rpm
+   * process per package, the whole list is handed to librpm at once. It is
+   * processed in the given order, without dependency checks (like
+   * <tt>--nodeps --force</tt>).
+   *
+   * \ref RpmInstallReport and \ref RpmRemoveReport are sent for each element
+   * as rpm processes it. \a activate_r is called with the element's index right
+   * before, so the caller can connect the matching receiver. As rpm can not be
+   * interrupted in the middle of a transaction, there is no RETRY and
+   * \c problem is not asked. A failed element is just reported in \c finish.
+   *
+   * The outcome is stored in each element's \c state. Elements left \c PENDING
+   * were not touched by rpm (e.g. the transaction was refused as a whole) and
+   * can still be processed the per-package way.
+   *
+   * \note If the target root is not \c /, rpm \c chroot()s the whole process
+   * into it while the transaction runs. Other threads would resolve absolute
+   * paths inside the target root meanwhile. The transaction is therefore
+   * refused unless the calling thread is the only one in the process.
+   *
+   * \throws RpmException if the transaction could not be set up or was refused.
+   * No element was touched by rpm then, all are still \c PENDING.
+   */
+  void commitTransaction( std::vector<TransactionElement> & elements_r,
+                          RpmInstFlags flags_r = RPMINST_NONE,
+                          const std::function<void(unsigned)> & activate_r = std::function<void(unsigned)>() );
+
   /**
    * get backup dir for rpm config files
    *
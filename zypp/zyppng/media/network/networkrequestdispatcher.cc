@@ -10,6 +10,7 @@
 
 #include <zypp/base/Logger.h>
 #include <zypp/base/String.h>
+#include <zypp/ZConfig.h>
 
 using namespace boost;
 
@@ -25,6 +26,10 @@ NetworkRequestDispatcherPrivate::NetworkRequestDispatcherPrivate( )
   curl_multi_setopt( _multi, CURLMOPT_TIMERDATA, reinterpret_cast<void *>( this ) );
   curl_multi_setopt( _multi, CURLMOPT_SOCKETFUNCTION, NetworkRequestDispatcherPrivate::static_socket_callback );
   curl_multi_setopt( _multi, CURLMOPT_SOCKETDATA, reinterpret_cast<void *>( this ) );
+  internal::limitSharedConnections( _multi );
+
+  _maxStreams = std::max( 1L, zypp::ZConfig::instance().download_max_concurrent_streams() );
+  applyConnectionLimits();
 
   _timer->sigExpired().connect( sigc::mem_fun( *this, &NetworkRequestDispatcherPrivate::multiTimerTimout ) );
 }
@@ -33,6 +38,23 @@ NetworkRequestDispatcherPrivate::~NetworkRequestDispatcherPrivate()
 {
   cancelAll( NetworkRequestErrorPrivate::customError( NetworkRequestError::Cancelled, "Dispatcher shutdown" ) );
   curl_multi_cleanup( _multi );
+  MIL << "Curl connections: " << internal::connectionStats() << std::endl;
+}
+
+void NetworkRequestDispatcherPrivate::applyConnectionLimits()
+{
+#if CURLVERSION_AT_LEAST(7,43,0)
+  curl_multi_setopt( _multi, CURLMOPT_PIPELINING, _maxStreams > 1 ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING );
+#endif
+#if CURLVERSION_AT_LEAST(7,67,0)
+  curl_multi_setopt( _multi, CURLMOPT_MAX_CONCURRENT_STREAMS, static_cast<long>( _maxStreams ) );
+#endif
+  curl_multi_setopt( _multi, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>( _maxConnections ) );
+}
+
+std::string NetworkRequestDispatcherPrivate::hostKey( const Url &url )
+{
+  return url.getScheme() + "://" + url.getHost() + ":" + url.getPort();
 }
 
 //called by curl to setup a timer
@@ -160,6 +182,7 @@ void NetworkRequestDispatcherPrivate::handleMultiSocketAction(curl_socket_t nati
     if(msg->msg == CURLMSG_DONE) {
       CURL *easy = msg->easy_handle;
       CURLcode res = msg->data.result;
+      internal::countTransfer( easy );
 
       void *privatePtr = nullptr;
       if ( curl_easy_getinfo( easy, CURLINFO_PRIVATE, &privatePtr ) != CURLE_OK )
@@ -175,6 +198,16 @@ void NetworkRequestDispatcherPrivate::handleMultiSocketAction(curl_socket_t nati
 
       NetworkRequestPrivate *request = reinterpret_cast<NetworkRequestPrivate *>( privatePtr );
 
+#if CURLVERSION_AT_LEAST(7,50,0)
+      // Once a host talked HTTP/2 to us, more requests are started than we have connections.
+      long httpVersion = 0;
+      if ( _maxStreams > 1
+           && curl_easy_getinfo( easy, CURLINFO_HTTP_VERSION, &httpVersion ) == CURLE_OK
+           && httpVersion >= CURL_HTTP_VERSION_2_0
+           && _multiplexingHosts.insert( hostKey( request->_url ) ).second )
+        DBG << "Multiplexing up to " << _maxStreams << " requests per connection to " << request->_url.getHost() << std::endl;
+#endif
+
       //trigger notification about file downloaded
       NetworkRequestError e = NetworkRequestErrorPrivate::fromCurlError( *request->z_func(), res, request->_errorBuf.data() );
       setFinished( *request->z_func(), e );
@@ -237,8 +270,11 @@ void NetworkRequestDispatcherPrivate::dequeuePending()
   if ( !_isRunning || _locked )
     return;
 
-  while ( _maxConnections > _runningDownloads.size() ) {
-    if ( !_pendingDownloads.size() )
+  while ( _pendingDownloads.size() ) {
+    size_t maxRunning = _maxConnections;
+    if ( _maxStreams > 1 && _multiplexingHosts.count( hostKey( _pendingDownloads.front()->url() ) ) )
+      maxRunning *= _maxStreams;
+    if ( _runningDownloads.size() >= maxRunning )
       break;
 
     std::shared_ptr<NetworkRequest> req = std::move( _pendingDownloads.front() );
@@ -300,7 +336,16 @@ bool NetworkRequestDispatcher::supportsProtocol( const Url &url )
 
 void NetworkRequestDispatcher::setMaximumConcurrentConnections( size_t maxConn )
 {
-  d_func()->_maxConnections = maxConn;
+  Z_D();
+  d->_maxConnections = maxConn;
+  d->applyConnectionLimits();
+}
+
+void NetworkRequestDispatcher::setMaximumConcurrentStreams( size_t maxStreams )
+{
+  Z_D();
+  d->_maxStreams = std::max( size_t(1), maxStreams );
+  d->applyConnectionLimits();
 }
 
 void NetworkRequestDispatcher::enqueue(const std::shared_ptr<NetworkRequest> &req )
@@ -94,6 +94,14 @@ namespace zyppng {
        */
       void setMaximumConcurrentConnections (size_t maxConn );
 
+      /*!
+       * Change the number of requests sent as concurrent streams over a single
+       * HTTP/2 connection, the default is the ZConfig \c download.max_concurrent_streams.
+       * A value of 1 disables multiplexing. Requests to a host which did not (yet)
+       * answer using HTTP/2 are limited by \ref setMaximumConcurrentConnections.
+       */
+      void setMaximumConcurrentStreams ( size_t maxStreams );
+
       /*!
        * Enqueues a new \a request and puts it into the waiting queue. If the dispatcher
        * is already running and has free capacatly the request might be started right away
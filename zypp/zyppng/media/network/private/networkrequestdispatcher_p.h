@@ -20,6 +20,10 @@ public:
   virtual ~NetworkRequestDispatcherPrivate();
 
   size_t _maxConnections = 10;
+  size_t _maxStreams = 1;	//< HTTP/2 streams per connection
+
+  /** Hosts known to multiplex, they may run \ref _maxStreams requests per connection. */
+  std::set<std::string> _multiplexingHosts;
 
   std::deque< std::shared_ptr<NetworkRequest> > _pendingDownloads;
   std::vector< std::shared_ptr<NetworkRequest> > _runningDownloads;
@@ -33,6 +37,9 @@ public:
 
   NetworkRequestError _lastError;
 
+  /** The key used in \ref _multiplexingHosts. */
+  static std::string hostKey ( const Url &url );
+
   //signals
   signal<void ( NetworkRequestDispatcher &, NetworkRequest & )> _sigDownloadStarted;
   signal<void ( NetworkRequestDispatcher &, NetworkRequest & )> _sigDownloadFinished;
@@ -53,6 +60,8 @@ private:
 
   void handleMultiSocketAction ( curl_socket_t nativeSocket, int evBitmask );
   void dequeuePending ();
+
+  void applyConnectionLimits ();
 };
 }
 
@@ -67,6 +67,7 @@ namespace zyppng {
 
     _errorBuf.fill( '\0' );
     curl_easy_setopt( _easyHandle, CURLOPT_ERRORBUFFER, this->_errorBuf.data() );
+    internal::useGlobalShare( _easyHandle );	// the reset above dropped it
 
     try {
 
@@ -174,6 +175,8 @@ namespace zyppng {
 
 #if CURLVERSION_AT_LEAST(7,60,0)	// SLE15+
         setCurlOption( CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS );
+        // rather wait for a connection we may multiplex on than open a new one
+        setCurlOption( CURLOPT_PIPEWAIT, 1L );
 #endif
 
         if( locSet.verifyPeerEnabled() ||